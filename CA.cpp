@@ -23,6 +23,9 @@
  */
 
 #include <AliHLTTPCCAGBTracker.h>
+#include <AliHLTTPCCAEventArchive.h>
+#include <AliHLTTPCCAMerger.h>
+#include <AliHLTTPCCAAllocationCounter.h>
 #ifdef KFPARTICLE
 #include "KFParticleTopoReconstructor.h"
 #ifndef HLTCA_STANDALONE
@@ -83,8 +86,21 @@ static void usage(const char *execName)
      "  -links     let it draw every vector of links the NeighboursFinder found.\n"
 #else
      "  -single    force tracker to run on only one core. Per default all available cores will be used\n"
+     "  -nThreads [n] number of threads for the slice trackers\n"
 #endif
+     "  -preallocate [nHits] [nTracks] allocate the memory for events of this size before the first event\n"
+     "  -gridProfile [file] read the grid coefficients of the rows from the file\n"
+     "  -tuneGrid [file] tune the grid coefficients on the events and write them into the file (needs TUNE_GRID)\n"
+     "  -denseNeighbours use the NeighboursFinder kernel evaluating all neighbour candidates of each hit\n"
+     "  -refillTracklets give the vector lanes of finished tracklets to the next tracklets in the TrackletConstructor\n"
+     "  -orderStartHits [n] pack the start hits into the vectors in buckets of n start rows\n"
+     "  -parallelTracklets [n] construct the tracklets of a slice in parallel waves of n vectors\n"
+     "  -tuning [file] read the search windows, cuts and chain lengths of the iterations from the file\n"
      "  -save      dump result of the tracker/merger into a file for later analysis\n"
+     "  -archive [file] read the hits of all events from the archive file (see convertToBinary)\n"
+     "  -dump [every|slow|big] [value] save input hits in binary files: of every value-th event, of events\n"
+     "             reconstructed longer than value seconds or of events with more than value hits\n"
+     "  -dumpDir [dir] directory for the -dump files, default is current\n"
 #ifndef HLTCA_STANDALONE
      "  -perf      do a performance analysis against Monte-Carlo information right after reconstruction\n\n"
 #endif
@@ -118,6 +134,17 @@ int main(int argc, char **argv)
   int iHLT = 0;
   int iXeonPhi = 1;
   string filePrefix = "./Events/"; 
+  string archiveName;
+  AliHLTTPCCAEventDumper::EMode dumpMode = AliHLTTPCCAEventDumper::kNone;
+  double dumpThreshold = 0;
+  string dumpDir = ".";
+  int nThreads = 0;
+  int maxNHits = 0, maxNTracks = 0;
+  string gridProfileName, tunedGridProfileName, tuningName;
+  bool isDenseNeighboursFinder = false;
+  bool isRefillTrackletConstructor = false;
+  int startHitsRowBucket = 0;
+  int parallelTrackletVectors = 0;
   for( int i=1; i < argc; i++ ){
     if ( !std::strcmp( argv[i], "-h" ) || !std::strcmp( argv[i], "--help" ) || !std::strcmp( argv[i], "-help" ) ) {
       usage(argv[0]);
@@ -129,6 +156,25 @@ int main(int argc, char **argv)
     } else if ( !std::strcmp( argv[i], "-single" ) ) {
       SINGLE_THREADED = true;
 #endif
+    } else if ( !std::strcmp( argv[i], "-nThreads" ) && ++i < argc ) {
+      nThreads = atoi( argv[i] );
+    } else if ( !std::strcmp( argv[i], "-preallocate" ) && i + 2 < argc ) {
+      maxNHits = atoi( argv[++i] );
+      maxNTracks = atoi( argv[++i] );
+    } else if ( !std::strcmp( argv[i], "-gridProfile" ) && ++i < argc ) {
+      gridProfileName = argv[i];
+    } else if ( !std::strcmp( argv[i], "-tuneGrid" ) && ++i < argc ) {
+      tunedGridProfileName = argv[i];
+    } else if ( !std::strcmp( argv[i], "-tuning" ) && ++i < argc ) {
+      tuningName = argv[i];
+    } else if ( !std::strcmp( argv[i], "-denseNeighbours" ) ) {
+      isDenseNeighboursFinder = true;
+    } else if ( !std::strcmp( argv[i], "-refillTracklets" ) ) {
+      isRefillTrackletConstructor = true;
+    } else if ( !std::strcmp( argv[i], "-orderStartHits" ) && ++i < argc ) {
+      startHitsRowBucket = atoi( argv[i] );
+    } else if ( !std::strcmp( argv[i], "-parallelTracklets" ) && ++i < argc ) {
+      parallelTrackletVectors = atoi( argv[i] );
     } else if ( !std::strcmp( argv[i], "-save" ) ) {
       SAVE = true;
 #ifndef HLTCA_STANDALONE
@@ -139,6 +185,17 @@ int main(int argc, char **argv)
       fullTiming = true;
     } else if ( !std::strcmp( argv[i], "-dir" ) && ++i < argc ) {
       filePrefix = argv[i];
+    } else if ( !std::strcmp( argv[i], "-archive" ) && ++i < argc ) {
+      archiveName = argv[i];
+    } else if ( !std::strcmp( argv[i], "-dump" ) && i + 2 < argc ) {
+      ++i;
+      if ( !std::strcmp( argv[i], "every" ) ) dumpMode = AliHLTTPCCAEventDumper::kEveryNth;
+      else if ( !std::strcmp( argv[i], "slow" ) ) dumpMode = AliHLTTPCCAEventDumper::kSlowEvents;
+      else if ( !std::strcmp( argv[i], "big" ) ) dumpMode = AliHLTTPCCAEventDumper::kBigEvents;
+      else std::cout << "Unknown dump mode " << argv[i] << ". Nothing will be dumped." << std::endl;
+      dumpThreshold = atof( argv[++i] );
+    } else if ( !std::strcmp( argv[i], "-dumpDir" ) && ++i < argc ) {
+      dumpDir = argv[i];
     } else if ( !std::strcmp( argv[i], "-HLT" ) && ++i < argc ) {
       iHLT = atoi( argv[i] );
     } else if ( !std::strcmp( argv[i], "-XeonPhi" ) && ++i < argc ) {
@@ -176,10 +233,40 @@ int main(int argc, char **argv)
   const AliHLTTPCCAGBTracker *trackerConst = 0;
 
   tracker = new AliHLTTPCCAGBTracker;
+  tracker->SetNThreads( nThreads );
+  tracker->Init();
 
   filePrefix += "/";
   tracker->ReadSettingsFromFile(filePrefix);
+  tracker->SetDenseNeighboursFinder( isDenseNeighboursFinder );
+  tracker->SetRefillTrackletConstructor( isRefillTrackletConstructor );
+  tracker->SetStartHitsRowBucket( startHitsRowBucket );
+  tracker->SetParallelTrackletVectors( parallelTrackletVectors );
+  if ( !tuningName.empty() && !tracker->ReadTuning( tuningName ) ) {
+    std::cout << "Tuning " << tuningName << " can't be read. The default cuts are used." << std::endl;
+  }
+  if ( !gridProfileName.empty() && !tracker->ReadGridProfile( gridProfileName ) ) {
+    std::cout << "Grid profile " << gridProfileName << " can't be read. The default grid is used." << std::endl;
+  }
+  if ( !tunedGridProfileName.empty() ) {
+    if ( !AliHLTTPCCAGridProfile::StatisticsEnabled() ) std::cout << "Build with TUNE_GRID to tune the grid." << std::endl;
+    tracker->StartGridTuning();
+  }
+  if ( maxNHits > 0 ) tracker->Preallocate( maxNHits, maxNTracks );
   trackerConst = tracker;
+  if ( dumpMode != AliHLTTPCCAEventDumper::kNone ) {
+    tracker->SetDumpPolicy( dumpMode, dumpThreshold, dumpDir + "/" );
+  }
+
+  AliHLTTPCCAEventArchive archive;
+  if ( !archiveName.empty() ) {
+    if ( !archive.Open( archiveName ) ) {
+      cout << "Archive " << archiveName << " can't be read." << std::endl;
+      return 1;
+    }
+    if ( lastEvent >= archive.NEvents() ) lastEvent = archive.NEvents() - 1;
+    archive.Prefetch( firstEvent );
+  }
 
 #ifdef WITHSCIF
   //check if the node with index iXeonPhi exists
@@ -244,7 +331,16 @@ int main(int argc, char **argv)
     const string fileName = filePrefix + "event" + string(buf) + "_";
 
     std::cout << "Loading Event " << kEvents << "..." << std::endl;
-    if (!tracker->ReadHitsFromFile(fileName)) {
+    if ( archive.IsOpen() ) {
+      AliHLTTPCCAEventFile event;
+      if ( !archive.GetEvent( kEvents, event ) ) {
+        cout << "Hits Data for Event " << kEvents << " can't be read from the archive." << std::endl;
+        break;
+      }
+      tracker->SetHits( event );
+      archive.Prefetch( kEvents + 1 ); // read the next event while this one is reconstructed
+    }
+    else if (!tracker->ReadHitsFromFile(fileName)) {
         cout << "Hits Data for Event " << kEvents << " can't be read." << std::endl;
         break;
     }
@@ -275,6 +371,8 @@ int main(int argc, char **argv)
     }
     
     tracker->FindTracks();
+    if ( AliHLTTPCCAAllocationCounter::Enabled() )
+      std::cout << "Event " << kEvents << ": " << trackerConst->NAllocations() << " allocations in FindTracks" << std::endl;
 
 #if 0
     tracker->WriteTracks(fileName);
@@ -398,6 +496,8 @@ int main(int argc, char **argv)
           << " | ---- OverlapTrackMerge: " << std::setw( 10 )  << trackerConst->StatTime( 15 ) * 1000. << " ms\n"
           << " |               Merge: " << std::setw( 10 )  << trackerConst->StatTime( 17 ) * 1000. << " ms\n"
           << " |           DataStore: " << std::setw( 10 )  << trackerConst->StatTime( 19 ) * 1000. << " ms\n"
+          << " |       Merger memory: " << std::setw( 10 )  << trackerConst->Merger().Arena().Used()/1024 << " kB, max "
+          << trackerConst->Merger().Arena().HighWater()/1024 << " kB, " << trackerConst->Merger().Arena().NSystemAllocations() << " system allocations\n"
           ;
       } 
 
@@ -490,6 +590,19 @@ int main(int argc, char **argv)
 #endif
     
   } // kEvent
+  if ( tracker->StatNNeighbourTruncations() > 0 ) {
+    std::cout << tracker->StatNNeighbourTruncations() << " hits had more than " << int(AliHLTTPCCAParameters::MaxNeighboursUp)
+              << " neighbour candidates in the upper row" << ( isDenseNeighboursFinder ? "" : ", the rest of them wasn't considered (see -denseNeighbours)" ) << std::endl;
+  }
+  if ( tracker->StatNTrackletLaneSteps() > 0 ) {
+    std::cout << "TrackletConstructor lane utilisation " << 100. * tracker->StatNTrackletActiveLaneSteps() / tracker->StatNTrackletLaneSteps()
+              << "% of " << tracker->StatNTrackletLaneSteps() << " lane row steps" << ( isRefillTrackletConstructor ? " (refilled lanes)" : "" ) << std::endl;
+  }
+  if ( !tunedGridProfileName.empty() ) {
+    tracker->FinishGridTuning();
+    if ( !tracker->GridProfile().WriteToFile( tunedGridProfileName ) )
+      std::cout << "Grid profile can't be written into " << tunedGridProfileName << std::endl;
+  }
 #ifndef HLTCA_STANDALONE
   if ( perf) {
     perf->WriteHistos();
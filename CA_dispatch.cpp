@@ -0,0 +1,97 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// Launcher of the CA builds for several instruction sets (cmake option MULTI_ISA).
+  /// to run:  ./CA_dispatch [CA arguments]
+  /// runs CA_avx512, CA_avx2 or CA_sse4 from the directory of the launcher, the best one the CPU supports,
+  /// with the same arguments. The environment variable CA_ISA=avx512|avx2|sse4 selects the build explicitly,
+  /// the launcher fails if that build is missing.
+  /// The vector width is fixed at compile time by Vc, so the builds are separate programs.
+
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static const int NISA = 3;
+static const char *ISAName[NISA] = { "avx512", "avx2", "sse4" }; // from the best to the worst
+
+static bool IsSupported( int iISA )
+{
+  switch ( iISA ) {
+    case 0: return __builtin_cpu_supports( "avx512f" ) && __builtin_cpu_supports( "avx512cd" ) && __builtin_cpu_supports( "avx512bw" )
+               && __builtin_cpu_supports( "avx512dq" ) && __builtin_cpu_supports( "avx512vl" ) && IsSupported( 1 );
+    case 1: return __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" ) && __builtin_cpu_supports( "bmi" )
+               && __builtin_cpu_supports( "bmi2" ) && IsSupported( 2 );
+    case 2: return __builtin_cpu_supports( "sse4.1" );
+  }
+  return 0;
+}
+
+  /// directory of the launcher with the trailing '/'
+static std::string ProgramDir( const char *argv0 )
+{
+  char buf[4096];
+  const ssize_t n = readlink( "/proc/self/exe", buf, sizeof( buf ) - 1 );
+  std::string path = ( n > 0 ) ? std::string( buf, n ) : std::string( argv0 );
+  const size_t slash = path.rfind( '/' );
+  return ( slash == std::string::npos ) ? std::string( "./" ) : path.substr( 0, slash + 1 );
+}
+
+int main( int, char **argv )
+{
+  __builtin_cpu_init();
+
+  int iFirst = 0;
+  const char *requested = getenv( "CA_ISA" );
+  if ( requested ) {
+    for ( iFirst = 0; iFirst < NISA && std::strcmp( requested, ISAName[iFirst] ); iFirst++ );
+    if ( iFirst == NISA ) {
+      std::fprintf( stderr, "Unknown CA_ISA=%s, it can be avx512, avx2 or sse4.\n", requested );
+      return 1;
+    }
+    if ( !IsSupported( iFirst ) ) {
+      std::fprintf( stderr, "CA_ISA=%s is not supported by this CPU.\n", requested );
+      return 1;
+    }
+  }
+
+  const std::string dir = ProgramDir( argv[0] );
+  const int iEnd = requested ? iFirst + 1 : NISA; // the requested build only, no fall back to another one
+  for ( int iISA = iFirst; iISA < iEnd; iISA++ ) {
+    if ( !IsSupported( iISA ) ) continue;
+    const std::string program = dir + "CA_" + ISAName[iISA];
+    if ( access( program.c_str(), X_OK ) != 0 ) { // not built
+      if ( requested ) std::fprintf( stderr, "CA_dispatch: CA_ISA=%s is requested, but %s is not found.\n", requested, program.c_str() );
+      continue;
+    }
+    std::fprintf( stderr, "CA_dispatch: running %s\n", program.c_str() );
+    argv[0] = strdup( program.c_str() );
+    execv( program.c_str(), argv );
+    perror( program.c_str() ); // try the next one
+  }
+  if ( !requested ) std::fprintf( stderr, "CA_dispatch: no CA build for this CPU is found in %s\n", dir.c_str() );
+  return 1;
+}
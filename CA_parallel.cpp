@@ -44,6 +44,8 @@ using namespace std;
 #endif
 
 #include <AliHLTTPCCAInputData.h>
+#include <AliHLTTPCCAEventArchive.h>
+#include <AliHLTTPCCAEventPipeline.h>
 
 #include "Stopwatch.h"
 #include "pthread.h"
@@ -63,6 +65,22 @@ static bool file_exists( const char *filename )
     return false;
 }
 
+class PipelineOutput : public AliHLTTPCCAEventPipeline::Output
+{
+  public:
+    PipelineOutput(): fNTracks( 0 ) {}
+    void EventDone( int, AliHLTTPCCAGBTracker &tracker ) {
+      fNTracks += tracker.NTracks();
+#ifdef KFPARTICLE
+      KFParticleTopoReconstructor topoReconstructor;
+      topoReconstructor.Init( &tracker );
+      topoReconstructor.ReconstructPrimVertex();
+      topoReconstructor.ReconstructParticles();
+#endif
+    }
+    long fNTracks;
+};
+
 int main(int argc, char **argv)
 {
   bool fullTiming = false;
@@ -72,7 +90,9 @@ int main(int argc, char **argv)
   int Step=1;
   int nRuns=1;
   int repetitions = 1;
+  int pipelineDepth = 0;
   string filePrefix = "./Events/"; 
+  string archiveName;
   for( int i=1; i < argc; i++ ){
     if ( !std::strcmp( argv[i], "-h" ) || !std::strcmp( argv[i], "--help" ) || !std::strcmp( argv[i], "-help" ) ) {
       std::cout << "Please look in readme.txt" << std::endl;
@@ -81,8 +101,12 @@ int main(int argc, char **argv)
       fullTiming = true;
     } else if ( !std::strcmp( argv[i], "-dir" ) && ++i < argc ) {
       filePrefix = argv[i];
+    } else if ( !std::strcmp( argv[i], "-archive" ) && ++i < argc ) {
+      archiveName = argv[i];
     } else if ( !std::strcmp( argv[i], "-nThreads" ) && ++i < argc ) {
       nThreads = atoi( argv[i] );
+    } else if ( !std::strcmp( argv[i], "-pipeline" ) && ++i < argc ) {
+      pipelineDepth = atoi( argv[i] );
     } else if ( !std::strcmp( argv[i], "-Step" ) && ++i < argc ) {
       Step = atoi( argv[i] );
     } else if ( !std::strcmp( argv[i], "-nRuns" ) && ++i < argc ) {
@@ -104,6 +128,16 @@ int main(int argc, char **argv)
     }
   }
 
+  AliHLTTPCCAEventArchive archive;
+  if ( !archiveName.empty() ) {
+    if ( !archive.Open( archiveName ) ) {
+      std::cout << "Archive " << archiveName << " can't be read." << std::endl;
+      return 1;
+    }
+    if ( lastEvent >= archive.NEvents() ) lastEvent = archive.NEvents() - 1;
+    archive.Prefetch( firstEvent );
+  }
+
   const int NEventsPerThread = lastEvent - firstEvent + 1;
   fstream OutTime;
   OutTime.open( "outtime.dat", ios::out );
@@ -126,11 +160,21 @@ int main(int argc, char **argv)
       sprintf( buf, "%d", kEvents );
       const std::string fileName = LocalfilePrefix + "event" + std::string(buf) + "_";
 
-      if (!InputDataPerThread.fInput[kEvents].ReadHitsFromFile(fileName)) {
+      if ( archive.IsOpen() ) {
+        AliHLTTPCCAEventFile event;
+        if ( !archive.GetEvent( kEvents, event ) ) {
+          cout << "Hits Data for Event " << kEvents << " can't be read from the archive." << std::endl;
+          break;
+        }
+        archive.Prefetch( kEvents + 1 );
+        InputDataPerThread.fInput[kEvents].SetHits( event );
+      }
+      else if (!InputDataPerThread.fInput[kEvents].ReadHitsFromFile(fileName)) {
         cout << "Hits Data for Event " << kEvents << " can't be read." << std::endl;
         break;
       }
     }
+    archive.Close();
   }
 
   std::cout << nThreads << "  " << Step << "  " << 1/*nRuns*/ << "  " << NEventsPerThread << std::endl;
@@ -152,7 +196,26 @@ int main(int argc, char **argv)
     
   #define handle_error_en(en, msg) do { errno = en; perror(msg); exit(EXIT_FAILURE); } while (0)
 
-  for(int iThreads=Step; iThreads <= nThreads; iThreads+=Step)
+  for(int iThreads=Step; iThreads <= nThreads && pipelineDepth > 0; iThreads+=Step)
+  {
+      // one copy of the events, pipelineDepth events are reconstructed at once by iThreads threads
+    PipelineOutput output;
+    AliHLTTPCCAEventPipeline pipeline( InputDataPerThread.fSettings->GetSettings(), pipelineDepth, iThreads, &output );
+    Stopwatch timer;
+    for(int iTimes = 0; iTimes<nRuns; iTimes++)
+      for ( int iE = firstEvent; iE <= lastEvent; iE++ )
+        pipeline.Push( iE, InputDataPerThread.fInput[iE].Hits(), InputDataPerThread.fInput[iE].NHits() );
+    pipeline.Finish();
+    timer.Stop();
+
+    double rtime = timer.RealTime();
+    cout << iThreads << " (pipeline of " << pipelineDepth << " events):" << endl;
+    cout << " Estimated CATime = " << rtime/nRuns << " Estimated CATime/nEvents = " << (rtime/nRuns/NEventsPerThread) << endl;
+    cout << " Busy time of the stages: grouping " << pipeline.StageTime(0) << " slices " << pipeline.StageTime(1)
+         << " merge " << pipeline.StageTime(2) << ", tracks " << output.fNTracks << endl;
+  }
+
+  for(int iThreads=Step; iThreads <= nThreads && pipelineDepth <= 0; iThreads+=Step)
   {
     InputDataArray *InputDataParallel = new InputDataArray[iThreads];
     Stopwatch timer;
@@ -195,6 +258,7 @@ int main(int argc, char **argv)
 
           AliHLTTPCCAGBTracker Tracker;
           Tracker.SetSettings( InputDataParallel[i].fSettings->GetSettings() );
+          Tracker.SetNThreads( 1 ); // events are already processed in parallel
 
           for ( int iE = firstEvent; iE <= lastEvent; iE++ ) {
             Tracker.SetHits(InputDataParallel[i].fInput[iE].Hits(), InputDataParallel[i].fInput[iE].NHits());
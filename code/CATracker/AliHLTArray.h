@@ -33,6 +33,7 @@
 #ifndef assert
 #include <assert.h>
 #endif
+#include "AliHLTTPCCAAllocationCounter.h"
 
 #if 1//(defined(__MMX__) || defined(__SSE__))
 
@@ -161,7 +162,7 @@ namespace AliHLTInternal
   {
     public:
 #ifdef USE_MM_MALLOC
-      static inline T *Alloc( int s ) { T *p = reinterpret_cast<T *>( _mm_malloc( s * sizeof( T ), alignment ) ); return new( p ) T[s]; }
+      static inline T *Alloc( int s ) { AliHLTTPCCAAllocationCounter::Count( s * sizeof( T ) ); T *p = reinterpret_cast<T *>( _mm_malloc( s * sizeof( T ), alignment ) ); return new( p ) T[s]; }
       static inline void Free( T *const p, int size ) {
         for ( int i = 0; i < size; ++i ) {
           p[i].~T();
@@ -169,7 +170,7 @@ namespace AliHLTInternal
         _mm_free( p );
       }
 #else
-      static inline T *Alloc( int s ) { T *p; posix_memalign( &p, alignment, s * sizeof( T ) ); return new( p ) T[s]; }
+      static inline T *Alloc( int s ) { AliHLTTPCCAAllocationCounter::Count( s * sizeof( T ) ); T *p; posix_memalign( &p, alignment, s * sizeof( T ) ); return new( p ) T[s]; }
       static inline void Free( T *const p, int size ) {
         for ( int i = 0; i < size; ++i ) {
           p[i].~T();
@@ -183,7 +184,7 @@ namespace AliHLTInternal
     public:
       typedef CacheLineSizeHelper<T> T2;
 #ifdef USE_MM_MALLOC
-      static inline T2 *Alloc( int s ) { T2 *p = reinterpret_cast<T2 *>( _mm_malloc( s * sizeof( T2 ), 128 ) ); return new( p ) T2[s]; }
+      static inline T2 *Alloc( int s ) { AliHLTTPCCAAllocationCounter::Count( s * sizeof( T2 ) ); T2 *p = reinterpret_cast<T2 *>( _mm_malloc( s * sizeof( T2 ), 128 ) ); return new( p ) T2[s]; }
       static inline void Free( T2 *const p, int size ) {
         for ( int i = 0; i < size; ++i ) {
           p[i].~T2();
@@ -191,7 +192,7 @@ namespace AliHLTInternal
         _mm_free( p );
       }
 #else
-      static inline T2 *Alloc( int s ) { T2 *p; posix_memalign( &p, 128, s * sizeof( T2 ) ); return new( p ) T2[s]; }
+      static inline T2 *Alloc( int s ) { AliHLTTPCCAAllocationCounter::Count( s * sizeof( T2 ) ); T2 *p; posix_memalign( &p, 128, s * sizeof( T2 ) ); return new( p ) T2[s]; }
       static inline void Free( T2 *const p, int size ) {
         for ( int i = 0; i < size; ++i ) {
           p[i].~T2();
@@ -204,7 +205,7 @@ namespace AliHLTInternal
   {
     public:
 #ifdef USE_MM_MALLOC
-      static inline T *Alloc( int s ) { T *p = reinterpret_cast<T *>( _mm_malloc( s * sizeof( T ), 128 ) ); return new( p ) T[s]; }
+      static inline T *Alloc( int s ) { AliHLTTPCCAAllocationCounter::Count( s * sizeof( T ) ); T *p = reinterpret_cast<T *>( _mm_malloc( s * sizeof( T ), 128 ) ); return new( p ) T[s]; }
       static inline void Free( T *const p, int size ) {
         for ( int i = 0; i < size; ++i ) {
           p[i].~T();
@@ -212,7 +213,7 @@ namespace AliHLTInternal
         _mm_free( p );
       }
 #else
-      static inline T *Alloc( int s ) { T *p; posix_memalign( &p, 128, s * sizeof( T ) ); return new( p ) T[s]; }
+      static inline T *Alloc( int s ) { AliHLTTPCCAAllocationCounter::Count( s * sizeof( T ) ); T *p; posix_memalign( &p, 128, s * sizeof( T ) ); return new( p ) T[s]; }
       static inline void Free( T *const p, int size ) {
         for ( int i = 0; i < size; ++i ) {
           p[i].~T();
@@ -0,0 +1,85 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AliHLTTPCCAAllocationCounter.h"
+
+#ifdef COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<long> gNAllocations( 0 );
+static std::atomic<long> gNBytes( 0 );
+
+void AliHLTTPCCAAllocationCounter::Count( size_t size )
+{
+  gNAllocations.fetch_add( 1, std::memory_order_relaxed );
+  gNBytes.fetch_add( size, std::memory_order_relaxed );
+}
+
+long AliHLTTPCCAAllocationCounter::NAllocations() { return gNAllocations.load(); }
+long AliHLTTPCCAAllocationCounter::NBytes() { return gNBytes.load(); }
+
+  // replacements of the global allocation functions, the nothrow versions call these
+
+void *operator new( size_t size )
+{
+  AliHLTTPCCAAllocationCounter::Count( size );
+  void *p = std::malloc( size ? size : 1 );
+  if ( !p ) throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[]( size_t size )
+{
+  return ::operator new( size );
+}
+
+void operator delete( void *p ) noexcept
+{
+  std::free( p );
+}
+
+void operator delete[]( void *p ) noexcept
+{
+  std::free( p );
+}
+
+void operator delete( void *p, size_t ) noexcept
+{
+  std::free( p );
+}
+
+void operator delete[]( void *p, size_t ) noexcept
+{
+  std::free( p );
+}
+
+#else // COUNT_ALLOCATIONS
+
+long AliHLTTPCCAAllocationCounter::NAllocations() { return 0; }
+long AliHLTTPCCAAllocationCounter::NBytes() { return 0; }
+
+#endif // COUNT_ALLOCATIONS
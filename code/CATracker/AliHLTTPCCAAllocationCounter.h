@@ -0,0 +1,58 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALIHLTTPCCAALLOCATIONCOUNTER_H
+#define ALIHLTTPCCAALLOCATIONCOUNTER_H
+
+#include <cstddef>
+
+/**
+ * @class AliHLTTPCCAAllocationCounter
+ *
+ * Counts the heap allocations of the whole program, to check that the reconstruction of an event
+ * doesn't allocate memory after the warm-up (see AliHLTTPCCAGBTracker::Preallocate).
+ * Works only when built with COUNT_ALLOCATIONS: then the global operator new is replaced
+ * and the aligned allocations of AliHLTArray are counted as well. Otherwise the counters stay 0.
+ *
+ * Usage:
+ *   const long n = AliHLTTPCCAAllocationCounter::NAllocations();
+ *   tracker.FindTracks();
+ *   assert( AliHLTTPCCAAllocationCounter::NAllocations() == n );
+ */
+class AliHLTTPCCAAllocationCounter
+{
+  public:
+#ifdef COUNT_ALLOCATIONS
+    static bool Enabled() { return 1; }
+    static void Count( size_t size ); // called by the allocators
+#else
+    static bool Enabled() { return 0; }
+    static void Count( size_t ) {}
+#endif // COUNT_ALLOCATIONS
+
+    static long NAllocations(); // since the program start, all threads
+    static long NBytes();
+};
+
+#endif // ALIHLTTPCCAALLOCATIONCOUNTER_H
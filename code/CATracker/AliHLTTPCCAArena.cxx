@@ -0,0 +1,82 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AliHLTTPCCAArena.h"
+
+#include <cstdint>
+
+void *AliHLTTPCCAArena::AllocBytes( size_t size, size_t alignment )
+{
+  if ( size == 0 ) size = 1; // different objects get different addresses
+  while ( 1 ) {
+    if ( fBlock < fBlocks.size() ) {
+      const Block &b = fBlocks[fBlock];
+      const uintptr_t begin = reinterpret_cast<uintptr_t>( b.fData ) + fBlockUsed;
+      const size_t pad = ( alignment - begin % alignment ) % alignment;
+      if ( fBlockUsed + pad + size <= b.fSize ) {
+        fBlockUsed += pad + size;
+        fUsed += pad + size;
+        if ( fHighWater < fUsed ) fHighWater = fUsed;
+        return reinterpret_cast<void*>( begin + pad );
+      }
+      if ( fBlock + 1 < fBlocks.size() ) { // the next block is free
+        fBlock++;
+        fBlockUsed = 0;
+        continue;
+      }
+    }
+    size_t blockSize = fBlocks.empty() ? kMinBlockSize : 2 * fBlocks.back().fSize;
+    if ( blockSize < size + alignment ) blockSize = size + alignment;
+    AddBlock( blockSize );
+    fBlock = fBlocks.size() - 1;
+    fBlockUsed = 0;
+  }
+}
+
+void AliHLTTPCCAArena::Reset()
+{
+    // the blocks are kept and filled again from the first one, merging them would allocate in the next event
+  fBlock = 0;
+  fBlockUsed = 0;
+  fUsed = 0;
+}
+
+void AliHLTTPCCAArena::AddBlock( size_t size )
+{
+  Block b;
+  b.fData = new char[size];
+  b.fSize = size;
+  fBlocks.push_back( b );
+  fCapacity += size;
+  fNSystemAllocations++;
+}
+
+void AliHLTTPCCAArena::Free()
+{
+  for ( unsigned int i = 0; i < fBlocks.size(); i++ ) delete[] fBlocks[i].fData;
+  fBlocks.clear();
+  fCapacity = 0;
+  fBlock = 0;
+  fBlockUsed = 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALIHLTTPCCAARENA_H
+#define ALIHLTTPCCAARENA_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class AliHLTTPCCAArena
+ *
+ * Memory for the data which lives not longer than one event.
+ * Alloc() takes the memory from big blocks, the memory is given back all at once by Reset().
+ * The blocks are kept by Reset(), so after the first event only a bigger event calls the system allocator;
+ * each new block is at least twice as big as the previous one.
+ * Objects are constructed by Alloc() but never destructed, so only trivially destructible types are allowed.
+ */
+class AliHLTTPCCAArena
+{
+  public:
+    static const size_t kAlignment = 64; // cache line
+    static const size_t kMinBlockSize = 1 << 16;
+
+    AliHLTTPCCAArena(): fBlocks(), fBlock( 0 ), fBlockUsed( 0 ), fUsed( 0 ), fHighWater( 0 ), fCapacity( 0 ), fNSystemAllocations( 0 ) {}
+    ~AliHLTTPCCAArena() { Free(); }
+
+      /// n default-constructed objects
+    template<typename T> T *Alloc( size_t n ) {
+      static_assert( std::is_trivially_destructible<T>::value, "AliHLTTPCCAArena never calls destructors" );
+      T *p = static_cast<T*>( AllocBytes( n * sizeof( T ), alignof( T ) > kAlignment ? alignof( T ) : kAlignment ) );
+      for ( size_t i = 0; i < n; i++ ) new( p + i ) T;
+      return p;
+    }
+    void *AllocBytes( size_t size, size_t alignment = kAlignment );
+
+      /// Forget all allocated objects, the blocks are reused by the next Alloc() calls.
+    void Reset();
+
+    size_t Used() const { return fUsed; }            // bytes allocated since the last Reset
+    size_t HighWater() const { return fHighWater; }  // maximum of Used()
+    size_t Capacity() const { return fCapacity; }    // bytes taken from the system
+    int NSystemAllocations() const { return fNSystemAllocations; }
+
+  private:
+    struct Block {
+      char *fData;
+      size_t fSize;
+    };
+
+    void AddBlock( size_t size );
+    void Free();
+
+    std::vector<Block> fBlocks;
+    unsigned int fBlock;      // current block
+    size_t fBlockUsed;        // bytes used in the current block
+    size_t fUsed;
+    size_t fHighWater;
+    size_t fCapacity;
+    int fNSystemAllocations;
+
+    AliHLTTPCCAArena( const AliHLTTPCCAArena& );
+    AliHLTTPCCAArena &operator=( const AliHLTTPCCAArena& );
+};
+
+#endif
@@ -21,6 +21,9 @@
 
 void AliHLTTPCCAClusterData::readEvent( const AliHLTTPCCAGBHit *hits, int *offset, int numberOfClusters, int nRows8 )
 {
+  fNumberOfClusters.clear(); // keeps the capacity
+  fRowOffset.clear();
+  fData.clear();
   fNumberOfClusters.reserve( nRows8 );
   fRowOffset.reserve( nRows8 );
   fData.reserve( CAMath::Min( 64, numberOfClusters / 64 ) );
@@ -51,3 +54,42 @@ void AliHLTTPCCAClusterData::readEvent( const AliHLTTPCCAGBHit *hits, int *offse
   fNumberOfClusters.push_back( fData.size() - fRowOffset.back() );
   fLastRow = row; // the last seen row is the last row in this slice
 }
+
+void AliHLTTPCCAClusterData::readEvent( const float *x, const float *y, const float *z, const int *row, const int *id,
+                                        int iSlice, const int *index, int numberOfClusters, int nRows8 )
+{
+  fNumberOfClusters.clear();
+  fRowOffset.clear();
+  fData.clear();
+  fNumberOfClusters.reserve( nRows8 );
+  fRowOffset.reserve( nRows8 );
+  fData.reserve( numberOfClusters );
+
+  fSlice = iSlice;
+  fFirstRow = row[index[0]];
+  int iRow = fFirstRow;
+  for ( int i = 0; i < iRow; ++i ) {
+    fNumberOfClusters.push_back( 0 );
+    fRowOffset.push_back( 0 );
+  }
+  fRowOffset.push_back( 0 );
+  for ( int iCl = 0; iCl < numberOfClusters; ++iCl ) {
+    const int i = index[iCl];
+    while ( iRow < row[i] ) {
+      fNumberOfClusters.push_back( fData.size() - fRowOffset.back() );
+      fRowOffset.push_back( fData.size() );
+      ++iRow;
+    }
+    Data d = { x[i], y[i], z[i], id[i], row[i] };
+    fData.push_back( d );
+  }
+  fNumberOfClusters.push_back( fData.size() - fRowOffset.back() );
+  fLastRow = iRow;
+}
+
+void AliHLTTPCCAClusterData::Reserve( int numberOfClusters, int nRows8 )
+{
+  fNumberOfClusters.reserve( nRows8 + 1 );
+  fRowOffset.reserve( nRows8 + 1 );
+  fData.reserve( numberOfClusters );
+}
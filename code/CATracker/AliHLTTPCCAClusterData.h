@@ -49,7 +49,19 @@ class AliHLTTPCCAClusterData
 
     // void readEvent( const AliHLTArray<AliHLTTPCSpacePointData *> &clusters,
     //     int numberOfClusters, double ClusterZCut );
-    void readEvent( const AliHLTTPCCAGBHit *hits, int *offset, int numberOfClusters, int nRows8 );
+    void readEvent( const AliHLTTPCCAGBHit *hits, int *offset, int numberOfClusters, int nRows8 ); // the memory of the previous event is reused
+
+    /**
+     * Fill from the hit columns of AliHLTTPCCAGBTracker::SetHitsSoA: the numberOfClusters hits index[0..numberOfClusters)
+     * of the slice iSlice, sorted by row and z.
+     */
+    void readEvent( const float *x, const float *y, const float *z, const int *row, const int *id,
+                    int iSlice, const int *index, int numberOfClusters, int nRows8 );
+
+    /**
+     * Allocate the memory for up to numberOfClusters clusters in nRows8 rows.
+     */
+    void Reserve( int numberOfClusters, int nRows8 );
 
     /**
      * "remove" two clusters and "add" a new one, keeping history.
@@ -76,6 +76,11 @@
 #include <Vc/array>
 #include <Vc/vector>
 
+  // Vc gathers and scatters (AliHLTTPCCAGatherScatter.h) where the target has the gather instructions
+#if !defined(VC_GATHER_SCATTER) && !defined(VC_NO_GATHER_TRICKS) && ( defined(Vc_IMPL_AVX2) || defined(Vc_IMPL_MIC) )
+#define VC_GATHER_SCATTER
+#endif
+
 using ::Vc::double_v;
 using ::Vc::float_v;
 using ::Vc::short_v;
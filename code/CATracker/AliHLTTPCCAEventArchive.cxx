@@ -0,0 +1,198 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AliHLTTPCCAEventArchive.h"
+#include "AliHLTTPCCAGBHit.h"
+
+#include <cstring>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static const char kEventArchiveMagic[12] = { 'C', 'A', 'E', 'V', 'A', 'R', 'C', 'H', 'I', 'V', 'E', 0 };
+
+static void TouchEventPages( const char *data, long long size )
+{
+  //* bring the event into memory, runs in the prefetch thread
+#ifndef _WIN32
+  const long long pageSize = sysconf( _SC_PAGESIZE );
+  const long long shift = reinterpret_cast<size_t>( data ) % pageSize;
+  madvise( const_cast<char *>( data - shift ), size + shift, MADV_WILLNEED );
+#else
+  const long long pageSize = 4096;
+#endif
+  volatile char sum = 0;
+  for ( long long i = 0; i < size; i += pageSize ) {
+    sum += data[i];
+  }
+}
+
+AliHLTTPCCAEventArchive::AliHLTTPCCAEventArchive()
+    : fMapped( 0 ), fMappedSize( 0 ), fIsMMapped( 0 ), fIndex( 0 ), fNEvents( 0 ), fPrefetcher(),
+    fPrefetchMutex(), fPrefetchStart(), fPrefetchDone(), fPrefetchData( 0 ), fPrefetchSize( 0 ), fStopPrefetcher( 0 ),
+    fOut( 0 ), fOutIndex(), fOutSize( 0 )
+{
+}
+
+AliHLTTPCCAEventArchive::~AliHLTTPCCAEventArchive()
+{
+  Close();
+  if ( fOut ) Finish();
+  if ( fPrefetcher.joinable() ) {
+    {
+      std::lock_guard<std::mutex> lock( fPrefetchMutex );
+      fStopPrefetcher = 1;
+    }
+    fPrefetchStart.notify_all();
+    fPrefetcher.join();
+  }
+}
+
+void AliHLTTPCCAEventArchive::Close()
+{
+  WaitPrefetch();
+  if ( fMapped ) AliHLTTPCCAEventFile::UnmapFile( fMapped, fMappedSize, fIsMMapped );
+  fMapped = 0;
+  fMappedSize = 0;
+  fIsMMapped = 0;
+  fIndex = 0;
+  fNEvents = 0;
+}
+
+bool AliHLTTPCCAEventArchive::Open( const string &fileName )
+{
+  Close();
+  fMapped = AliHLTTPCCAEventFile::MapFile( fileName, fMappedSize, fIsMMapped );
+  if ( !fMapped ) return 0;
+
+  bool ok = ( fMappedSize >= static_cast<long long>( sizeof( Trailer ) ) );
+  if ( ok ) {
+    const Trailer *t = reinterpret_cast<const Trailer *>( fMapped + fMappedSize - sizeof( Trailer ) );
+    ok = ( std::memcmp( t->fMagic, kEventArchiveMagic, sizeof( kEventArchiveMagic ) ) == 0 )
+      && t->fByteOrder == AliHLTTPCCAEventFile::kByteOrder && t->fVersion == kVersion
+      && t->fNEvents >= 0 && t->fIndex >= 0
+      && t->fIndex + static_cast<long long>( sizeof( long long ) ) * ( t->fNEvents + 1 ) <= fMappedSize - static_cast<long long>( sizeof( Trailer ) );
+    if ( ok ) {
+      fIndex = reinterpret_cast<const long long *>( fMapped + t->fIndex );
+      fNEvents = t->fNEvents;
+      for ( int i = 0; i < fNEvents && ok; i++ ) {
+        ok = ( fIndex[i] >= 0 && fIndex[i] <= fIndex[i + 1] );
+      }
+      ok = ok && ( fIndex[fNEvents] <= t->fIndex );
+    }
+  }
+  if ( !ok ) {
+    Close();
+    return 0;
+  }
+  return 1;
+}
+
+bool AliHLTTPCCAEventArchive::GetEvent( int iEvent, AliHLTTPCCAEventFile &event ) const
+{
+  if ( iEvent < 0 || iEvent >= fNEvents ) return 0;
+  event.Close();
+  return event.Map( fMapped + fIndex[iEvent], fIndex[iEvent + 1] - fIndex[iEvent] );
+}
+
+void AliHLTTPCCAEventArchive::Prefetch( int iEvent )
+{
+  WaitPrefetch();
+  if ( iEvent < 0 || iEvent >= fNEvents ) return;
+  if ( !fPrefetcher.joinable() ) fPrefetcher = std::thread( &AliHLTTPCCAEventArchive::RunPrefetcher, this );
+  {
+    std::lock_guard<std::mutex> lock( fPrefetchMutex );
+    fPrefetchData = fMapped + fIndex[iEvent];
+    fPrefetchSize = fIndex[iEvent + 1] - fIndex[iEvent];
+  }
+  fPrefetchStart.notify_all();
+}
+
+void AliHLTTPCCAEventArchive::WaitPrefetch()
+{
+  std::unique_lock<std::mutex> lock( fPrefetchMutex );
+  while ( fPrefetchData ) fPrefetchDone.wait( lock );
+}
+
+void AliHLTTPCCAEventArchive::RunPrefetcher()
+{
+  //* read the events given by Prefetch() one after another, the event stays in fPrefetchData until it is read
+  std::unique_lock<std::mutex> lock( fPrefetchMutex );
+  while ( 1 ) {
+    while ( !fStopPrefetcher && !fPrefetchData ) fPrefetchStart.wait( lock );
+    if ( fStopPrefetcher ) return;
+    const char *data = fPrefetchData;
+    const long long size = fPrefetchSize;
+    lock.unlock();
+    TouchEventPages( data, size );
+    lock.lock();
+    fPrefetchData = 0;
+    fPrefetchDone.notify_all();
+  }
+}
+
+bool AliHLTTPCCAEventArchive::Create( const string &fileName )
+{
+  if ( fOut ) Finish();
+  fOut = std::fopen( fileName.data(), "wb" );
+  fOutIndex.clear();
+  fOutSize = 0;
+  return fOut != 0;
+}
+
+bool AliHLTTPCCAEventArchive::AddEvent( const AliHLTTPCCAGBHit *hits, int nHits )
+{
+  //* event images have an aligned size, so all events stay aligned in the archive
+  if ( !fOut ) return 0;
+  const long long size = AliHLTTPCCAEventFile::Write( fOut, hits, nHits );
+  if ( size <= 0 ) return 0;
+  fOutIndex.push_back( fOutSize );
+  fOutSize += size;
+  return 1;
+}
+
+bool AliHLTTPCCAEventArchive::Finish()
+{
+  //* write the index and the trailer
+  if ( !fOut ) return 0;
+  fOutIndex.push_back( fOutSize );
+
+  Trailer t;
+  std::memset( &t, 0, sizeof( Trailer ) );
+  t.fIndex = fOutSize;
+  t.fNEvents = fOutIndex.size() - 1;
+  t.fVersion = kVersion;
+  t.fByteOrder = AliHLTTPCCAEventFile::kByteOrder;
+  std::memcpy( t.fMagic, kEventArchiveMagic, sizeof( kEventArchiveMagic ) );
+
+  bool ok = ( std::fwrite( &fOutIndex[0], sizeof( long long ), fOutIndex.size(), fOut ) == fOutIndex.size() );
+  ok = ok && ( std::fwrite( &t, sizeof( Trailer ), 1, fOut ) == 1 );
+  ok = ( std::fclose( fOut ) == 0 ) && ok;
+  fOut = 0;
+  fOutIndex.clear();
+  fOutSize = 0;
+  return ok;
+}
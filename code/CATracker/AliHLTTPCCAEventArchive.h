@@ -0,0 +1,109 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALIHLTTPCCAEVENTARCHIVE_H
+#define ALIHLTTPCCAEVENTARCHIVE_H
+
+#include "AliHLTTPCCAEventFile.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using std::string;
+
+class AliHLTTPCCAGBHit;
+
+/**
+ * @class AliHLTTPCCAEventArchive
+ *
+ * Many events in one file: AliHLTTPCCAEventFile images are concatenated and followed by
+ * the index with the offsets of the events and a fixed size trailer at the very end of the file.
+ *
+ * The archive is mapped into memory, so any event can be accessed in O(1) via the index.
+ * Prefetch() reads the pages of an event in a background thread, which allows to load
+ * the next event while the current one is being reconstructed. The thread is started by
+ * the first Prefetch() and serves all the following ones until the archive is destroyed.
+ */
+class AliHLTTPCCAEventArchive
+{
+  public:
+    enum { kVersion = 1 };
+
+    struct Trailer {
+      long long fIndex;           //* offset of the index: fNEvents+1 offsets, the last one is the end of the data
+      int fNEvents;               //* number of events
+      unsigned int fVersion;      //* format version
+      unsigned int fByteOrder;    //* AliHLTTPCCAEventFile::kByteOrder as written by the producer
+      char fMagic[12];            //* "CAEVARCHIVE"
+    };
+
+    AliHLTTPCCAEventArchive();
+    ~AliHLTTPCCAEventArchive();
+
+      /// open the archive for reading. Returns 0 if the file can't be read or is not a valid archive.
+    bool Open( const string &fileName );
+    void Close();
+    bool IsOpen() const { return fIndex != 0; }
+    int NEvents() const { return fNEvents; }
+
+      /// give access to the event iEvent. The event is valid as long as the archive is open.
+    bool GetEvent( int iEvent, AliHLTTPCCAEventFile &event ) const;
+      /// start reading of the event iEvent in the background, the previous prefetch is finished first
+    void Prefetch( int iEvent );
+      /// wait until the last prefetch is done
+    void WaitPrefetch();
+
+      /// write a new archive: Create(), AddEvent() for each event, Finish()
+    bool Create( const string &fileName );
+    bool AddEvent( const AliHLTTPCCAGBHit *hits, int nHits );
+    bool Finish();
+
+  private:
+    char *fMapped;                 //* mapped archive
+    long long fMappedSize;         //* size of fMapped
+    bool fIsMMapped;               //* fMapped is created by mmap
+    const long long *fIndex;       //* offsets of the events
+    int fNEvents;                  //* number of events
+    std::thread fPrefetcher;       //* background reading of the next event, see RunPrefetcher
+    std::mutex fPrefetchMutex;
+    std::condition_variable fPrefetchStart; //* a new event to read, or fStopPrefetcher
+    std::condition_variable fPrefetchDone;
+    const char *fPrefetchData;     //* event to read, 0 - nothing to do
+    long long fPrefetchSize;
+    bool fStopPrefetcher;          //* the prefetch thread has to exit
+
+    FILE *fOut;                    //* archive being written
+    std::vector<long long> fOutIndex; //* offsets of the written events
+    long long fOutSize;            //* bytes written
+
+    void RunPrefetcher(); // loop of the prefetch thread
+
+    AliHLTTPCCAEventArchive( const AliHLTTPCCAEventArchive& );
+    AliHLTTPCCAEventArchive &operator=( const AliHLTTPCCAEventArchive& );
+};
+
+#endif
@@ -0,0 +1,155 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AliHLTTPCCAEventDumper.h"
+#include "AliHLTTPCCAEventFile.h"
+
+#include <iostream>
+
+AliHLTTPCCAEventDumper::AliHLTTPCCAEventDumper()
+    : fMode( kNone ), fThreshold( 0 ), fPrefix( "./" ), fNDumped( 0 ), fNDropped( 0 ),
+    fQueue(), fWriting( 0 ), fStop( 0 ), fMutex(), fCondition(), fWriter()
+{
+}
+
+AliHLTTPCCAEventDumper::~AliHLTTPCCAEventDumper()
+{
+  //* write the rest of the queue and stop the writer
+  if ( fWriter.joinable() ) {
+    {
+      std::lock_guard<std::mutex> lock( fMutex );
+      fStop = 1;
+    }
+    fCondition.notify_all();
+    fWriter.join();
+  }
+}
+
+void AliHLTTPCCAEventDumper::SetPolicy( EMode mode, double threshold, const string &prefix )
+{
+  Flush();
+  fMode = mode;
+  fThreshold = threshold;
+  fPrefix = prefix;
+  if ( fMode == kEveryNth && fThreshold < 1 ) fThreshold = 1;
+}
+
+bool AliHLTTPCCAEventDumper::IsSelected( int iEvent, int nHits, double time ) const
+{
+  bool save = false;
+  switch ( fMode ) {
+    case kNone:
+      break;
+    case kEveryNth:
+      save = ( iEvent % static_cast<int>( fThreshold ) == 0 );
+      break;
+    case kSlowEvents:
+      save = ( time > fThreshold );
+      break;
+    case kBigEvents:
+      save = ( nHits > fThreshold );
+      break;
+  }
+  return save;
+}
+
+AliHLTTPCCAEventDumper::Event *AliHLTTPCCAEventDumper::NewEvent( int iEvent )
+{
+  if ( fQueue.size() >= kMaxPending ) {
+    fNDropped++;
+    return 0;
+  }
+  if ( !fWriter.joinable() ) fWriter = std::thread( &AliHLTTPCCAEventDumper::Run, this );
+
+  fQueue.push_back( Event() );
+  Event &event = fQueue.back();
+  event.fIEvent = iEvent;
+  return &event;
+}
+
+void AliHLTTPCCAEventDumper::ProcessEvent( int iEvent, const AliHLTTPCCAGBHit *hits, int nHits, double time )
+{
+  if ( !IsSelected( iEvent, nHits, time ) ) return;
+
+  std::unique_lock<std::mutex> lock( fMutex );
+  Event *event = NewEvent( iEvent );
+  if ( !event ) return;
+  event->fHits.assign( hits, hits + nHits );
+  lock.unlock();
+  fCondition.notify_all();
+}
+
+void AliHLTTPCCAEventDumper::ProcessEvent( int iEvent, const float *x, const float *y, const float *z, const int *iSlice, const int *iRow, const int *id,
+                                           const int *index, int nHits, double time )
+{
+  if ( !IsSelected( iEvent, nHits, time ) ) return;
+
+  std::unique_lock<std::mutex> lock( fMutex );
+  Event *event = NewEvent( iEvent );
+  if ( !event ) return;
+  event->fHits.resize( nHits );
+  for ( int i = 0; i < nHits; i++ ) {
+    const int iHit = index[i];
+    AliHLTTPCCAGBHit &h = event->fHits[i];
+    h.SetX( x[iHit] );
+    h.SetY( y[iHit] );
+    h.SetZ( z[iHit] );
+    h.SetISlice( iSlice[iHit] );
+    h.SetIRow( iRow[iHit] );
+    h.SetID( id[iHit] );
+  }
+  lock.unlock();
+  fCondition.notify_all();
+}
+
+void AliHLTTPCCAEventDumper::Flush()
+{
+  std::unique_lock<std::mutex> lock( fMutex );
+  while ( !fQueue.empty() || fWriting ) fCondition.wait( lock );
+}
+
+void AliHLTTPCCAEventDumper::Run()
+{
+  std::unique_lock<std::mutex> lock( fMutex );
+  while ( true ) {
+    while ( !fStop && fQueue.empty() ) fCondition.wait( lock );
+    if ( fQueue.empty() ) break; // stop requested and nothing left
+
+    Event event;
+    event.fIEvent = fQueue.front().fIEvent;
+    event.fHits.swap( fQueue.front().fHits );
+    fQueue.pop_front();
+    fWriting = 1;
+    lock.unlock();
+
+    const string fileName = fPrefix + "event" + std::to_string( event.fIEvent ) + "_hits.bin";
+    const bool ok = AliHLTTPCCAEventFile::Write( fileName, event.fHits.empty() ? 0 : &event.fHits[0], event.fHits.size() );
+    if ( !ok ) std::cout << "AliHLTTPCCAEventDumper: hits can't be written to " << fileName << std::endl;
+
+    lock.lock();
+    fWriting = 0;
+    if ( ok ) fNDumped++;
+    fCondition.notify_all();
+  }
+}
@@ -0,0 +1,106 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALIHLTTPCCAEVENTDUMPER_H
+#define ALIHLTTPCCAEVENTDUMPER_H
+
+#include "AliHLTTPCCAGBHit.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+using std::string;
+
+/**
+ * @class AliHLTTPCCAEventDumper
+ *
+ * Saves the input hits of selected events into binary files (see AliHLTTPCCAEventFile)
+ * for a later offline analysis.
+ *
+ * Which events are saved is given by the policy: none (default), every N-th event, events
+ * reconstructed longer than a time threshold or events with more hits than a threshold.
+ * The hits are copied and written by a background thread, so the reconstruction is not delayed
+ * by the disk. If the writer can't keep up, the events above kMaxPending are dropped and counted.
+ */
+class AliHLTTPCCAEventDumper
+{
+  public:
+    enum EMode {
+      kNone = 0,   //* nothing is saved
+      kEveryNth,   //* every N-th event, N = threshold
+      kSlowEvents, //* events with reconstruction time above threshold seconds
+      kBigEvents   //* events with number of hits above threshold
+    };
+    enum { kMaxPending = 16 };
+
+    AliHLTTPCCAEventDumper();
+    ~AliHLTTPCCAEventDumper();
+
+      /// set the policy. Files are named @prefix+"event"+N+"_hits.bin". Ex: "./dump/"
+    void SetPolicy( EMode mode, double threshold, const string &prefix );
+    EMode Mode() const { return fMode; }
+
+      /// decide if the event has to be saved and queue it. Called after the reconstruction of the event.
+    void ProcessEvent( int iEvent, const AliHLTTPCCAGBHit *hits, int nHits, double time );
+      /// the same for the hits given as columns, the hits index[0..nHits) are saved. The errors and the amplitude are 0.
+    void ProcessEvent( int iEvent, const float *x, const float *y, const float *z, const int *iSlice, const int *iRow, const int *id,
+                       const int *index, int nHits, double time );
+
+      /// wait until all queued events are written
+    void Flush();
+
+    int NDumped() const { return fNDumped; }
+    int NDropped() const { return fNDropped; }
+
+  private:
+    struct Event {
+      int fIEvent;
+      std::vector<AliHLTTPCCAGBHit> fHits;
+    };
+
+    bool IsSelected( int iEvent, int nHits, double time ) const; // the policy
+    Event *NewEvent( int iEvent ); // queue an event, 0 if the queue is full. fMutex must be locked.
+    void Run(); // writer thread
+
+    EMode fMode;          //* dump policy
+    double fThreshold;    //* parameter of the policy
+    string fPrefix;       //* prefix of the file names
+    int fNDumped;         //* number of written events
+    int fNDropped;        //* number of events dropped because of the full queue
+
+    std::deque<Event> fQueue;         //* events to be written
+    bool fWriting;                    //* the writer is busy with an event
+    bool fStop;                       //* the writer has to finish
+    std::mutex fMutex;
+    std::condition_variable fCondition;
+    std::thread fWriter;
+
+    AliHLTTPCCAEventDumper( const AliHLTTPCCAEventDumper& );
+    AliHLTTPCCAEventDumper &operator=( const AliHLTTPCCAEventDumper& );
+};
+
+#endif
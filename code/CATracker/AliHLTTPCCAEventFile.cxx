@@ -0,0 +1,259 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AliHLTTPCCAEventFile.h"
+#include "AliHLTTPCCAGBHit.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char kEventFileMagic[4] = { 'C', 'A', 'E', 'V' };
+
+static inline long long AlignEventFileOffset( long long offset )
+{
+  return ( offset + AliHLTTPCCAEventFile::kAlignment - 1 ) & ~static_cast<long long>( AliHLTTPCCAEventFile::kAlignment - 1 );
+}
+
+AliHLTTPCCAEventFile::AliHLTTPCCAEventFile()
+    : fData( 0 ), fHeader( 0 ), fFirstHit( 0 ), fMapped( 0 ), fMappedSize( 0 ), fIsMMapped( 0 )
+{
+}
+
+AliHLTTPCCAEventFile::~AliHLTTPCCAEventFile()
+{
+  Close();
+}
+
+void AliHLTTPCCAEventFile::Close()
+{
+  //* release the mapped file
+  if ( fMapped ) UnmapFile( fMapped, fMappedSize, fIsMMapped );
+  fMapped = 0;
+  fMappedSize = 0;
+  fIsMMapped = 0;
+  fData = 0;
+  fHeader = 0;
+  fFirstHit = 0;
+}
+
+bool AliHLTTPCCAEventFile::Open( const string &fileName )
+{
+  Close();
+  fMapped = MapFile( fileName, fMappedSize, fIsMMapped );
+  if ( !fMapped ) return 0;
+  if ( !Map( fMapped, fMappedSize ) ) {
+    Close();
+    return 0;
+  }
+  return 1;
+}
+
+char *AliHLTTPCCAEventFile::MapFile( const string &fileName, long long &size, bool &isMMapped )
+{
+  size = 0;
+  isMMapped = 0;
+#ifndef _WIN32
+  const int fd = open( fileName.data(), O_RDONLY );
+  if ( fd < 0 ) return 0;
+  struct stat st;
+  if ( fstat( fd, &st ) != 0 || st.st_size <= 0 ) {
+    close( fd );
+    return 0;
+  }
+  void *mem = mmap( 0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+  close( fd );
+  if ( mem == MAP_FAILED ) return 0;
+  size = st.st_size;
+  isMMapped = 1;
+  return static_cast<char *>( mem );
+#else
+  FILE *f = std::fopen( fileName.data(), "rb" );
+  if ( !f ) return 0;
+  std::fseek( f, 0, SEEK_END );
+  size = std::ftell( f );
+  std::fseek( f, 0, SEEK_SET );
+  char *mem = ( size > 0 ) ? new char[size] : 0;
+  const bool ok = mem && ( static_cast<long long>( std::fread( mem, 1, size, f ) ) == size );
+  std::fclose( f );
+  if ( !ok ) {
+    delete[] mem;
+    size = 0;
+    return 0;
+  }
+  return mem;
+#endif
+}
+
+void AliHLTTPCCAEventFile::UnmapFile( char *data, long long size, bool isMMapped )
+{
+#ifndef _WIN32
+  if ( isMMapped ) {
+    munmap( data, size );
+    return;
+  }
+#endif
+  UNUSED_PARAM2( size, isMMapped );
+  delete[] data;
+}
+
+bool AliHLTTPCCAEventFile::Map( const char *data, long long size )
+{
+  //* check the image and set the column pointers
+  fData = 0;
+  fHeader = 0;
+  fFirstHit = 0;
+  if ( !data || size < static_cast<long long>( sizeof( Header ) ) ) return 0;
+  if ( reinterpret_cast<unsigned long>( data ) % 4 != 0 ) return 0; // the columns are read as int and float
+
+  const Header *h = reinterpret_cast<const Header *>( data );
+  if ( std::memcmp( h->fMagic, kEventFileMagic, 4 ) != 0 ) return 0;
+  if ( h->fByteOrder != kByteOrder ) return 0;
+  if ( h->fVersion != kVersion ) return 0;
+  if ( h->fSize > size || h->fNHits < 0 || h->fNSlices < 0 || h->fNRows < 0 ) return 0;
+  for ( int i = 0; i < kNColumns; i++ ) {
+    if ( h->fColumn[i] < 0 || h->fColumn[i] % 4 != 0 || h->fColumn[i] + 4ll * h->fNHits > h->fSize ) return 0;
+  }
+  const long long nEntries = static_cast<long long>( h->fNSlices ) * h->fNRows; // FirstHit() computes it in int
+  if ( nEntries >= INT_MAX ) return 0;
+  if ( h->fFirstHit < 0 || h->fFirstHit % 4 != 0 || h->fFirstHit + 4ll * ( nEntries + 1 ) > h->fSize ) return 0;
+
+    // the hit ranges of the rows must be ordered and inside the hit columns
+  const int *firstHit = reinterpret_cast<const int *>( data + h->fFirstHit );
+  if ( firstHit[0] < 0 || firstHit[nEntries] > h->fNHits ) return 0;
+  for ( long long i = 0; i < nEntries; i++ ) {
+    if ( firstHit[i + 1] < firstHit[i] ) return 0;
+  }
+
+  fData = data;
+  fHeader = h;
+  fFirstHit = firstHit;
+  return 1;
+}
+
+void AliHLTTPCCAEventFile::GetHits( AliHLTTPCCAGBHit *hits ) const
+{
+  const int nHits = NHits();
+  const float *x = X(), *y = Y(), *z = Z();
+  const float *errX = ErrX(), *errY = ErrY(), *errZ = ErrZ(), *amp = Amp();
+  const int *iSlice = ISlice(), *iRow = IRow(), *id = ID();
+  for ( int i = 0; i < nHits; i++ ) {
+    AliHLTTPCCAGBHit &h = hits[i];
+    h.SetX( x[i] );
+    h.SetY( y[i] );
+    h.SetZ( z[i] );
+    h.SetErrX( errX[i] );
+    h.SetErrY( errY[i] );
+    h.SetErrZ( errZ[i] );
+    h.SetAmp( amp[i] );
+    h.SetISlice( iSlice[i] );
+    h.SetIRow( iRow[i] );
+    h.SetID( id[i] );
+    h.SetIsUsed( 0 );
+  }
+}
+
+long long AliHLTTPCCAEventFile::Write( FILE *f, const AliHLTTPCCAGBHit *hits, int nHits )
+{
+  //* build the event image in memory and write it at once
+  std::vector<AliHLTTPCCAGBHit> sorted( hits, hits + nHits );
+  std::stable_sort( sorted.begin(), sorted.end(), AliHLTTPCCAGBHit::Compare );
+
+  int nSlices = 0, nRows = 0;
+  for ( int i = 0; i < nHits; i++ ) {
+    if ( sorted[i].ISlice() < 0 || sorted[i].IRow() < 0 ) return 0;
+    nSlices = std::max( nSlices, sorted[i].ISlice() + 1 );
+    nRows = std::max( nRows, sorted[i].IRow() + 1 );
+  }
+  if ( static_cast<long long>( nSlices ) * nRows >= INT_MAX ) return 0; // the reader refuses such an offset table
+
+  Header h;
+  std::memset( &h, 0, sizeof( Header ) );
+  std::memcpy( h.fMagic, kEventFileMagic, 4 );
+  h.fVersion = kVersion;
+  h.fByteOrder = kByteOrder;
+  h.fNHits = nHits;
+  h.fNSlices = nSlices;
+  h.fNRows = nRows;
+  long long offset = AlignEventFileOffset( sizeof( Header ) );
+  for ( int i = 0; i < kNColumns; i++ ) {
+    h.fColumn[i] = offset;
+    offset = AlignEventFileOffset( offset + 4ll * nHits );
+  }
+  h.fFirstHit = offset;
+  h.fSize = AlignEventFileOffset( offset + 4ll * ( nSlices * nRows + 1 ) );
+
+  std::vector<char> image( h.fSize, 0 );
+  char *mem = &image[0];
+  std::memcpy( mem, &h, sizeof( Header ) );
+  float *x = reinterpret_cast<float *>( mem + h.fColumn[kX] );
+  float *y = reinterpret_cast<float *>( mem + h.fColumn[kY] );
+  float *z = reinterpret_cast<float *>( mem + h.fColumn[kZ] );
+  float *errX = reinterpret_cast<float *>( mem + h.fColumn[kErrX] );
+  float *errY = reinterpret_cast<float *>( mem + h.fColumn[kErrY] );
+  float *errZ = reinterpret_cast<float *>( mem + h.fColumn[kErrZ] );
+  float *amp = reinterpret_cast<float *>( mem + h.fColumn[kAmp] );
+  int *iSlice = reinterpret_cast<int *>( mem + h.fColumn[kISlice] );
+  int *iRow = reinterpret_cast<int *>( mem + h.fColumn[kIRow] );
+  int *id = reinterpret_cast<int *>( mem + h.fColumn[kID] );
+  int *firstHit = reinterpret_cast<int *>( mem + h.fFirstHit );
+
+  for ( int i = 0; i < nHits; i++ ) {
+    const AliHLTTPCCAGBHit &hit = sorted[i];
+    x[i] = hit.X();
+    y[i] = hit.Y();
+    z[i] = hit.Z();
+    errX[i] = hit.ErrX();
+    errY[i] = hit.ErrY();
+    errZ[i] = hit.ErrZ();
+    amp[i] = hit.Amp();
+    iSlice[i] = hit.ISlice();
+    iRow[i] = hit.IRow();
+    id[i] = hit.ID();
+    firstHit[hit.ISlice() * nRows + hit.IRow() + 1]++;
+  }
+  for ( int i = 0; i < nSlices * nRows; i++ ) {
+    firstHit[i + 1] += firstHit[i];
+  }
+
+  if ( static_cast<long long>( std::fwrite( mem, 1, h.fSize, f ) ) != h.fSize ) return 0;
+  return h.fSize;
+}
+
+bool AliHLTTPCCAEventFile::Write( const string &fileName, const AliHLTTPCCAGBHit *hits, int nHits )
+{
+  FILE *f = std::fopen( fileName.data(), "wb" );
+  if ( !f ) return 0;
+  const bool ok = ( Write( f, hits, nHits ) > 0 );
+  std::fclose( f );
+  return ok;
+}
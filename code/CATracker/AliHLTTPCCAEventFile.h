@@ -0,0 +1,130 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALIHLTTPCCAEVENTFILE_H
+#define ALIHLTTPCCAEVENTFILE_H
+
+#include "AliHLTTPCCADef.h"
+
+#include <cstdio>
+#include <string>
+using std::string;
+
+class AliHLTTPCCAGBHit;
+
+/**
+ * @class AliHLTTPCCAEventFile
+ *
+ * Binary container of the hits of one event, replacing the text "hits.data" files.
+ *
+ * The event image is a fixed header followed by the hit columns (struct of arrays, each column
+ * aligned to a cache line) and by the per-slice/row offset table. The hits are stored sorted by
+ * AliHLTTPCCAGBHit::Compare, so the hits of slice s and row r are [FirstHit(s,r), FirstHit(s,r+1)).
+ * All offsets are relative to the beginning of the image, so an image can be placed at any
+ * (aligned) position of a bigger file. The data is written little-endian;
+ * a file written with a different byte order is refused.
+ *
+ * The reader maps the file into memory and gives direct access to the columns, no parsing is done.
+ */
+class AliHLTTPCCAEventFile
+{
+  public:
+    enum {
+      kVersion = 1,
+      kByteOrder = 0x01020304,
+      kAlignment = 64
+    };
+
+    enum EColumn { kX = 0, kY, kZ, kErrX, kErrY, kErrZ, kAmp, kISlice, kIRow, kID, kNColumns };
+
+    struct Header {
+      char fMagic[4];                    //* "CAEV"
+      unsigned int fVersion;             //* format version
+      unsigned int fByteOrder;           //* kByteOrder as written by the producer
+      int fNHits;                        //* number of hits
+      int fNSlices;                      //* number of slices in the offset table
+      int fNRows;                        //* number of rows per slice in the offset table
+      long long fSize;                   //* size of the whole event image in bytes
+      long long fColumn[kNColumns];      //* offset of each column
+      long long fFirstHit;               //* offset of the fNSlices*fNRows+1 first hit indices
+    };
+
+    AliHLTTPCCAEventFile();
+    ~AliHLTTPCCAEventFile();
+
+      /// map the whole file into memory. Returns 0 if the file can't be read or is not a valid event image.
+    bool Open( const string &fileName );
+      /// use an event image already placed in memory. The memory is not owned.
+    bool Map( const char *data, long long size );
+    void Close();
+    bool IsOpen() const { return fData != 0; }
+
+    int NHits() const { return fHeader->fNHits; }
+    int NSlices() const { return fHeader->fNSlices; }
+    int NRows() const { return fHeader->fNRows; }
+    long long Size() const { return fHeader->fSize; }
+
+    const float *X() const { return FloatColumn( kX ); }
+    const float *Y() const { return FloatColumn( kY ); }
+    const float *Z() const { return FloatColumn( kZ ); }
+    const float *ErrX() const { return FloatColumn( kErrX ); }
+    const float *ErrY() const { return FloatColumn( kErrY ); }
+    const float *ErrZ() const { return FloatColumn( kErrZ ); }
+    const float *Amp() const { return FloatColumn( kAmp ); }
+    const int *ISlice() const { return IntColumn( kISlice ); }
+    const int *IRow() const { return IntColumn( kIRow ); }
+    const int *ID() const { return IntColumn( kID ); }
+
+      /// index of the first hit of the given row of the given slice. Slices after the last stored one are empty.
+    int FirstHit( int iSlice, int iRow ) const { return iSlice < fHeader->fNSlices ? fFirstHit[iSlice * fHeader->fNRows + iRow] : fHeader->fNHits; }
+    int FirstSliceHit( int iSlice ) const { return FirstHit( iSlice, 0 ); }
+    int NSliceHits( int iSlice ) const { return FirstSliceHit( iSlice + 1 ) - FirstSliceHit( iSlice ); }
+
+      /// fill the AliHLTTPCCAGBHit array (of NHits() size) from the columns
+    void GetHits( AliHLTTPCCAGBHit *hits ) const;
+
+      /// write the event image at the current position of the file. Returns the number of bytes written or 0 in case of an error.
+    static long long Write( FILE *f, const AliHLTTPCCAGBHit *hits, int nHits );
+    static bool Write( const string &fileName, const AliHLTTPCCAGBHit *hits, int nHits );
+
+      /// map the whole file read-only into memory (read it on systems without mmap). Returns 0 in case of an error.
+    static char *MapFile( const string &fileName, long long &size, bool &isMMapped );
+    static void UnmapFile( char *data, long long size, bool isMMapped );
+
+  private:
+    const float *FloatColumn( int i ) const { return reinterpret_cast<const float *>( fData + fHeader->fColumn[i] ); }
+    const int *IntColumn( int i ) const { return reinterpret_cast<const int *>( fData + fHeader->fColumn[i] ); }
+
+    const char *fData;         //* begin of the event image
+    const Header *fHeader;     //* header of the event image
+    const int *fFirstHit;      //* per slice/row first hit index
+    char *fMapped;             //* mapped (or read) file, owned
+    long long fMappedSize;     //* size of fMapped
+    bool fIsMMapped;           //* fMapped is created by mmap
+
+    AliHLTTPCCAEventFile( const AliHLTTPCCAEventFile& );
+    AliHLTTPCCAEventFile &operator=( const AliHLTTPCCAEventFile& );
+};
+
+#endif
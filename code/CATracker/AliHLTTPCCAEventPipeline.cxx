@@ -0,0 +1,161 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AliHLTTPCCAEventPipeline.h"
+#include "AliHLTTPCCAGBTracker.h"
+#include "AliHLTTPCCAThreadPool.h"
+#include "AliHLTTPCCAEventFile.h"
+#include "Stopwatch.h"
+
+extern bool SINGLE_THREADED;
+
+void AliHLTTPCCAEventPipeline::Queue::Push( Slot *slot )
+{
+  {
+    std::lock_guard<std::mutex> lock( fMutex );
+    fSlots.push_back( slot );
+  }
+  fCond.notify_all();
+}
+
+AliHLTTPCCAEventPipeline::Slot *AliHLTTPCCAEventPipeline::Queue::Pop()
+{
+  std::unique_lock<std::mutex> lock( fMutex );
+  while ( fSlots.empty() && !fClosed ) fCond.wait( lock );
+  if ( fSlots.empty() ) return 0;
+  Slot *slot = fSlots.front();
+  fSlots.pop_front();
+  fCond.notify_all();
+  return slot;
+}
+
+void AliHLTTPCCAEventPipeline::Queue::Close()
+{
+  {
+    std::lock_guard<std::mutex> lock( fMutex );
+    fClosed = 1;
+  }
+  fCond.notify_all();
+}
+
+void AliHLTTPCCAEventPipeline::Queue::WaitSize( unsigned int n )
+{
+  std::unique_lock<std::mutex> lock( fMutex );
+  while ( fSlots.size() != n ) fCond.wait( lock );
+}
+
+AliHLTTPCCAEventPipeline::AliHLTTPCCAEventPipeline( const std::vector<AliHLTTPCCAParam> &settings, int nEventsInFlight, int nThreads, Output *output )
+    : fSlots( nEventsInFlight > 0 ? nEventsInFlight : 1 ), fPool( 0 ), fOutput( output ),
+    fFree(), fToPrepare(), fToReconstruct(), fToMerge(), fNEvents( 0 )
+{
+  fPool = new AliHLTTPCCAThreadPool( SINGLE_THREADED ? 1 : nThreads );
+  for ( unsigned int i = 0; i < fSlots.size(); i++ ) {
+    fSlots[i].fTracker = new AliHLTTPCCAGBTracker;
+    fSlots[i].fTracker->SetSettings( settings );
+    fSlots[i].fTracker->SetThreadPool( fPool );
+    fSlots[i].fIEvent = -1;
+    fFree.Push( &fSlots[i] );
+  }
+  for ( int i = 0; i < 3; i++ ) fStageTime[i] = 0;
+
+  fStages[0] = std::thread( &AliHLTTPCCAEventPipeline::Prepare, this );
+  fStages[1] = std::thread( &AliHLTTPCCAEventPipeline::Reconstruct, this );
+  fStages[2] = std::thread( &AliHLTTPCCAEventPipeline::Merge, this );
+}
+
+AliHLTTPCCAEventPipeline::~AliHLTTPCCAEventPipeline()
+{
+    // each stage closes the next queue when its own is empty
+  fToPrepare.Close();
+  for ( int i = 0; i < 3; i++ ) fStages[i].join();
+  for ( unsigned int i = 0; i < fSlots.size(); i++ ) delete fSlots[i].fTracker;
+  delete fPool;
+}
+
+AliHLTTPCCAEventPipeline::Slot *AliHLTTPCCAEventPipeline::GetFree( int iEvent )
+{
+  Slot *slot = fFree.Pop();
+  slot->fIEvent = iEvent;
+  slot->fTracker->StartEvent();
+  return slot;
+}
+
+void AliHLTTPCCAEventPipeline::Push( int iEvent, const AliHLTTPCCAGBHit *hits, int nHits )
+{
+  Slot *slot = GetFree( iEvent );
+  slot->fTracker->SetHits( hits, nHits );
+  fToPrepare.Push( slot );
+}
+
+void AliHLTTPCCAEventPipeline::Push( int iEvent, const AliHLTTPCCAEventFile &event )
+{
+  Slot *slot = GetFree( iEvent );
+  slot->fTracker->SetHits( event );
+  fToPrepare.Push( slot );
+}
+
+void AliHLTTPCCAEventPipeline::Finish()
+{
+  fFree.WaitSize( fSlots.size() );
+}
+
+void AliHLTTPCCAEventPipeline::Prepare()
+{
+  Slot *slot;
+  while ( ( slot = fToPrepare.Pop() ) ) {
+    Stopwatch timer;
+    slot->fTracker->PrepareEvent();
+    timer.Stop();
+    fStageTime[0] += timer.RealTime();
+    fToReconstruct.Push( slot );
+  }
+  fToReconstruct.Close();
+}
+
+void AliHLTTPCCAEventPipeline::Reconstruct()
+{
+  Slot *slot;
+  while ( ( slot = fToReconstruct.Pop() ) ) {
+    Stopwatch timer;
+    slot->fTracker->ReconstructSlices();
+    timer.Stop();
+    fStageTime[1] += timer.RealTime();
+    fToMerge.Push( slot );
+  }
+  fToMerge.Close();
+}
+
+void AliHLTTPCCAEventPipeline::Merge()
+{
+  Slot *slot;
+  while ( ( slot = fToMerge.Pop() ) ) {
+    Stopwatch timer;
+    slot->fTracker->FinishEvent();
+    if ( fOutput ) fOutput->EventDone( slot->fIEvent, *slot->fTracker );
+    timer.Stop();
+    fStageTime[2] += timer.RealTime();
+    fNEvents++;
+    fFree.Push( slot );
+  }
+}
@@ -0,0 +1,125 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALIHLTTPCCAEVENTPIPELINE_H
+#define ALIHLTTPCCAEVENTPIPELINE_H
+
+#include "AliHLTTPCCAParam.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class AliHLTTPCCAGBHit;
+class AliHLTTPCCAGBTracker;
+class AliHLTTPCCAEventFile;
+class AliHLTTPCCAThreadPool;
+
+/**
+ * @class AliHLTTPCCAEventPipeline
+ *
+ * Reconstructs a stream of events with several events in flight.
+ * Each event goes through three stages, each stage has its own thread:
+ *   1. grouping of the hits by slice, one counting and one scatter pass (AliHLTTPCCAGBTracker::PrepareEvent)
+ *   2. the slice tasks, they run in parallel on the thread pool (AliHLTTPCCAGBTracker::ReconstructSlices):
+ *      sorting of the slice hits, filling of the cluster data, ReadEvent and the slice tracking
+ *   3. merging (AliHLTTPCCAGBTracker::FinishEvent) and output
+ * So the next events are tracked while the serial merger of the current one works. The 1st stage is short,
+ * the preparation of the slice data is in the StageTime of the 2nd stage.
+ *
+ * Every event in flight occupies one AliHLTTPCCAGBTracker, the number of them bounds all queues
+ * between the stages. Push() waits when all trackers are busy.
+ * The events leave the pipeline in the order they were pushed.
+ */
+class AliHLTTPCCAEventPipeline
+{
+  public:
+      /// Receives the reconstructed events, is called from the thread of the 3rd stage
+    class Output
+    {
+      public:
+        virtual ~Output() {}
+        virtual void EventDone( int iEvent, AliHLTTPCCAGBTracker &tracker ) = 0;
+    };
+
+      /// nThreads - threads for the slice tracking, 0 - all hardware threads. output can be 0.
+    AliHLTTPCCAEventPipeline( const std::vector<AliHLTTPCCAParam> &settings, int nEventsInFlight = 3, int nThreads = 0, Output *output = 0 );
+    ~AliHLTTPCCAEventPipeline();
+
+      /// Copy the hits of event iEvent into a free tracker and start the reconstruction
+    void Push( int iEvent, const AliHLTTPCCAGBHit *hits, int nHits );
+    void Push( int iEvent, const AliHLTTPCCAEventFile &event );
+
+      /// Wait until all pushed events are reconstructed. The pipeline can be used further.
+    void Finish();
+
+    int NEventsInFlight() const { return fSlots.size(); }
+    int NEvents() const { return fNEvents; }                       // events passed through the pipeline
+    double StageTime( int iStage ) const { return fStageTime[iStage]; } // time the stage was busy, see the stages above
+
+  private:
+    struct Slot {
+      AliHLTTPCCAGBTracker *fTracker;
+      int fIEvent;
+    };
+
+      /// FIFO of slots, Pop waits for the next slot and returns 0 after Close
+    class Queue
+    {
+      public:
+        Queue(): fSlots(), fClosed( 0 ), fMutex(), fCond() {}
+        void Push( Slot *slot );
+        Slot *Pop();
+        void Close();
+        void WaitSize( unsigned int n ); // wait until there are n slots in the queue
+      private:
+        std::deque<Slot*> fSlots;
+        bool fClosed;
+        std::mutex fMutex;
+        std::condition_variable fCond;
+    };
+
+    void Prepare();     // loop of the stage 1
+    void Reconstruct(); // loop of the stage 2
+    void Merge();       // loop of the stage 3
+    Slot *GetFree( int iEvent );
+
+    std::vector<Slot> fSlots;    //* trackers, one per event in flight
+    AliHLTTPCCAThreadPool *fPool; //* shared by the slice trackers of all slots
+    Output *fOutput;             //* user output
+    Queue fFree;                 //* slots ready to take an event
+    Queue fToPrepare;            //* hits are set
+    Queue fToReconstruct;        //* hits are grouped by slice
+    Queue fToMerge;              //* slice tracks are ready
+    std::thread fStages[3];
+    int fNEvents;                //* reconstructed events
+    double fStageTime[3];        //* busy time of the stages
+
+    AliHLTTPCCAEventPipeline( const AliHLTTPCCAEventPipeline& );
+    AliHLTTPCCAEventPipeline &operator=( const AliHLTTPCCAEventPipeline& );
+};
+
+#endif
@@ -37,6 +37,10 @@
 #include "AliHLTTPCCAMath.h"
 #include "AliHLTTPCCATrackLinearisation.h"
 #include "AliHLTTPCCAClusterData.h"
+#include "AliHLTTPCCAEventFile.h"
+#include "AliHLTTPCCAThreadPool.h"
+#include "AliHLTTPCCAAllocationCounter.h"
+#include "AliHLTTPCCAParameters.h"
 #include "Stopwatch.h"
 #include <algorithm>
 #include <fstream>
@@ -72,12 +76,39 @@ AliHLTTPCCAGBTracker::AliHLTTPCCAGBTracker()
     fTrackHitsSegmentsId( 0 ),
     fTracks( 0 ),
     fNTracks( 0 ),
+    fTracksCapacity( 0 ),
+    fTrackHitsCapacity( 0 ),
     fMerger( 0 ),
+    fLooperMerger( 0 ),
+    fDumper( 0 ),
+    fGridProfile(),
+    fIsDenseNeighboursFinder( 0 ),
+    fIsRefillTrackletConstructor( 0 ),
+    fStartHitsRowBucket( 0 ),
+    fParallelTrackletVectors( 0 ),
+    fTuning(),
+    fNThreads( 0 ),
+#ifdef USE_TBB
+    fTaskScheduler( 0 ),
+#else
+    fThreadPool( 0 ),
+    fOwnThreadPool( 0 ),
+#endif //USE_TBB
     fClusterData( 0 ),
     fTime( 0 ),
     fStatNEvents( 0 ),
+    fStatNNeighbourTruncations( 0 ),
+    fStatNTrackletLaneSteps( 0 ),
+    fStatNTrackletActiveLaneSteps( 0 ),
     fSliceTrackerTime( 0 ),
-    fSliceTrackerCpuTime( 0 )
+    fSliceTrackerCpuTime( 0 ),
+    fSliceTime(),
+    fSlicePrepareTime(),
+    fHitBuffer(),
+    fHitIndexBuffer(),
+    fNAllocations( 0 ),
+    fHitColumns(),
+    fInputHitIndex()
 {
   //* constructor
   for ( int i = 0; i < 20; i++ ) fStatTime[i] = 0;
@@ -92,42 +123,104 @@ void AliHLTTPCCAGBTracker::Init()
   fTrackHitsSegmentsId = 0;
   fTracks = 0;
   fNTracks = 0;
+  fTracksCapacity = 0;
+  fTrackHitsCapacity = 0;
   fTime = 0.;
   fStatNEvents = 0;
+  fStatNNeighbourTruncations = 0;
+  fStatNTrackletLaneSteps = 0;
+  fStatNTrackletActiveLaneSteps = 0;
   fSliceTrackerTime = 0.;
   fSliceTrackerCpuTime = 0.;
   for ( int i = 0; i < 20; ++i ) {
     fStatTime[i] = 0.;
   }
+  StartThreads();
+}
+
+void AliHLTTPCCAGBTracker::SetNThreads( int n )
+{
+  //* the threads are restarted with the next Init or FindTracks
+  fNThreads = n;
+#ifdef USE_TBB
+  if (fTaskScheduler) delete fTaskScheduler;
+  fTaskScheduler = 0;
+#else
+  if (fThreadPool && fOwnThreadPool) delete fThreadPool;
+  fThreadPool = 0;
+  fMerger->SetThreadPool( 0 );
+#endif //USE_TBB
+}
+
+void AliHLTTPCCAGBTracker::SetThreadPool( AliHLTTPCCAThreadPool *pool )
+{
+#ifdef USE_TBB
+  (void) pool;
+#else
+  if (fThreadPool && fOwnThreadPool) delete fThreadPool;
+  fThreadPool = pool;
+  fOwnThreadPool = 0;
+  fMerger->SetThreadPool( fThreadPool );
+#endif //USE_TBB
+}
+
+int AliHLTTPCCAGBTracker::NThreads() const
+{
+#ifndef USE_TBB
+  if ( fThreadPool ) return fThreadPool->NThreads();
+#endif //USE_TBB
+  return SINGLE_THREADED ? 1 : fNThreads;
+}
+
+void AliHLTTPCCAGBTracker::StartThreads()
+{
+  const int nThreads = SINGLE_THREADED ? 1 : fNThreads;
+#ifdef USE_TBB
+  if ( !fTaskScheduler )
+    fTaskScheduler = new tbb::task_scheduler_init( nThreads > 0 ? nThreads : tbb::task_scheduler_init::automatic );
+#else
+  if ( !fThreadPool ) {
+    fThreadPool = new AliHLTTPCCAThreadPool( nThreads );
+    fOwnThreadPool = 1;
+  }
+  fMerger->SetThreadPool( fThreadPool );
+  for ( int iSlice = 0; iSlice < fNSlices; iSlice++ ) fSlices[iSlice].SetThreadPool( fThreadPool );
+#endif //USE_TBB
 }
 
 AliHLTTPCCAGBTracker::~AliHLTTPCCAGBTracker()
 {
   //* destructor
-  StartEvent();
+  if (fTrackHits) delete[] fTrackHits;
+  if (fTrackHitsSegmentsId) delete[] fTrackHitsSegmentsId;
+  if (fTracks) delete[] fTracks;
+  if (fExt2IntHitID) delete[] fExt2IntHitID;
   if (fMerger) delete fMerger;
+  if (fLooperMerger) delete fLooperMerger;
+  if (fDumper) delete fDumper; // waits for the pending writes
+#ifdef USE_TBB
+  if (fTaskScheduler) delete fTaskScheduler;
+#else
+  if (fThreadPool && fOwnThreadPool) delete fThreadPool;
+#endif //USE_TBB
 }
 
 void AliHLTTPCCAGBTracker::SetNSlices( int N )
 {
   //* set N of slices
   StartEvent();
+  if ( N < 0 || N >= 100 ) { // fFirstSliceHit has 100 entries
+    std::cout << "AliHLTTPCCAGBTracker: " << N << " slices are not supported, 99 at most" << std::endl;
+    N = ( N < 0 ) ? 0 : 99;
+  }
   fNSlices = N;
   fSlices.Resize( N );
 }
 
 void AliHLTTPCCAGBTracker::StartEvent()
 {
-  //* clean up track and hit arrays
+  //* clean up track and hit arrays, the memory is kept for the next event
 
-  if (fTrackHits) delete[] fTrackHits;
-  fTrackHits = 0;
-  if (fTrackHitsSegmentsId) delete[] fTrackHitsSegmentsId;
-  fTrackHitsSegmentsId = 0;
-  if (fTracks) delete[] fTracks;
-  fTracks = 0;
-  if (fExt2IntHitID) delete[] fExt2IntHitID;
-  fExt2IntHitID = 0;
   fNHits = 0;
   fNTracks = 0;
   for ( int i = 0; i < fNSlices; i++ ) fSlices[i].StartEvent();
@@ -136,11 +229,62 @@ void AliHLTTPCCAGBTracker::StartEvent()
 
 void AliHLTTPCCAGBTracker::SetNHits( int nHits )
 {
-  //* set the number of hits
-  fHits.Resize( nHits );
+  //* set the number of hits, the hit array only grows
+  fHitColumns = HitColumns();
+  if ( fHits.Size() < nHits ) {
+    fHits.Resize( nHits );
+    if (fExt2IntHitID) delete[] fExt2IntHitID;
+    fExt2IntHitID = new int[ nHits ];
+  }
   fNHits = nHits;
-  if (fExt2IntHitID) delete[] fExt2IntHitID;
-  fExt2IntHitID = new int[ nHits ];
+}
+
+void AliHLTTPCCAGBTracker::ReserveTracks( int nTracks, int nTrackHits )
+{
+  //* the old content is not kept
+  if ( fTracksCapacity < nTracks ) {
+    if ( fTracks ) delete[] fTracks;
+    fTracks = new AliHLTTPCCAGBTrack[nTracks];
+    fTracksCapacity = nTracks;
+  }
+  if ( fTrackHitsCapacity < nTrackHits ) {
+    if ( fTrackHits ) delete[] fTrackHits;
+    if ( fTrackHitsSegmentsId ) delete[] fTrackHitsSegmentsId;
+    fTrackHits = new int [nTrackHits];
+    fTrackHitsSegmentsId = new short [nTrackHits];
+    fTrackHitsCapacity = nTrackHits;
+  }
+}
+
+void AliHLTTPCCAGBTracker::Preallocate( int maxNHits, int maxNTracks )
+{
+  StartThreads();
+
+  const int nHits = fNHits; // keep the current event
+  SetNHits( maxNHits );
+  fNHits = nHits;
+  ReserveTracks( 2*maxNTracks, maxNHits ); // a looper is stored twice
+
+  if ( fClusterData.Size() != fNSlices ) fClusterData.Resize( fNSlices );
+  for ( int iSlice = 0; iSlice < fNSlices; iSlice++ ) {
+    fClusterData[iSlice].Reserve( maxNHits, fSlices[iSlice].Param().NRows8() );
+    fSlices[iSlice].ReserveOutputMemory( maxNTracks, maxNHits );
+    fSlices[iSlice].ReserveWorkMemory( maxNTracks, maxNHits );
+  }
+  fMerger->Reserve( maxNTracks );
+#ifdef MERGE_LOOPERS
+  if ( !fLooperMerger ) fLooperMerger = new AliHLTTPCCALooperMerger;
+  fLooperMerger->Reserve( maxNTracks );
+#endif
+#ifdef CALC_DCA_ON
+  dca_left.reserve( maxNTracks );
+  dca_right.reserve( maxNTracks );
+#endif
+  fSliceTime.resize( fNSlices );
+  fSlicePrepareTime.resize( fNSlices );
+  fHitBuffer.reserve( maxNHits );
+  fHitIndexBuffer.reserve( maxNHits );
+  fInputHitIndex.reserve( maxNHits );
 }
 
 #ifdef USE_TBB
@@ -164,16 +308,22 @@ class Initializer
 
 class ReconstructSliceTracks
 {
+    AliHLTTPCCAGBTracker &fTracker;
     AliHLTArray<AliHLTTPCCATracker> &fSlices;
     double *fStatTime;
     tbb::spin_mutex &fMutex;
   public:
-    inline ReconstructSliceTracks( AliHLTArray<AliHLTTPCCATracker> &fSlices_, double *fStatTime_, tbb::spin_mutex &fMutex_ )
-        : fSlices( fSlices_ ), fStatTime( fStatTime_ ), fMutex( fMutex_ ) {}//  2.1. Data preparation  is done as follows:
+    inline ReconstructSliceTracks( AliHLTTPCCAGBTracker &fTracker_, AliHLTArray<AliHLTTPCCATracker> &fSlices_, double *fStatTime_, tbb::spin_mutex &fMutex_ )
+        : fTracker( fTracker_ ), fSlices( fSlices_ ), fStatTime( fStatTime_ ), fMutex( fMutex_ ) {}//  2.1. Data preparation  is done as follows:
 
     inline void operator()( const tbb::blocked_range<int> &r ) const {
       for ( int iSlice = r.begin(); iSlice < r.end(); ++iSlice ) {
 #ifdef USE_TIMERS
+        Stopwatch timer1;
+#endif // USE_TIMERS
+        fTracker.PrepareSlice( iSlice );
+#ifdef USE_TIMERS
+        timer1.Stop();
         Stopwatch timer;
 #endif // USE_TIMERS
         AliHLTTPCCATracker &slice = fSlices[iSlice];
@@ -186,6 +336,7 @@ class ReconstructSliceTracks
         //blaTime+= timer.RealTime();
 #ifdef USE_TIMERS
         fStatTime[0] += timer.RealTime();
+        fStatTime[12] += timer1.RealTime();
 #endif // USE_TIMERS
         fStatTime[1] += slice.Timer( 0 );
         fStatTime[2] += slice.Timer( 1 );
@@ -199,11 +350,43 @@ class ReconstructSliceTracks
       }
     }
 };
+#else //USE_TBB
+class ReconstructSlice
+{
+    AliHLTTPCCAGBTracker &fTracker;
+    AliHLTArray<AliHLTTPCCATracker> &fSlices;
+    double *fSliceTime;
+    double *fSlicePrepareTime;
+  public:
+    inline ReconstructSlice( AliHLTTPCCAGBTracker &fTracker_, AliHLTArray<AliHLTTPCCATracker> &fSlices_, double *fSliceTime_, double *fSlicePrepareTime_ )
+        : fTracker( fTracker_ ), fSlices( fSlices_ ), fSliceTime( fSliceTime_ ), fSlicePrepareTime( fSlicePrepareTime_ ) {}
+
+    inline void operator()( int iSlice ) const {
+      Stopwatch timer1;
+      fTracker.PrepareSlice( iSlice );
+      timer1.Stop();
+      fSlicePrepareTime[iSlice] = timer1.RealTime();
+      Stopwatch timer;
+      fSlices[iSlice].Reconstruct();
+      timer.Stop();
+      fSliceTime[iSlice] = timer.RealTime();
+    }
+};
 #endif //USE_TBB
 
 void AliHLTTPCCAGBTracker::FindTracks()
 {
   //* main tracking routine
+  const long nAllocations = AliHLTTPCCAAllocationCounter::NAllocations();
+  PrepareEvent();
+  ReconstructSlices();
+  FinishEvent();
+  fNAllocations = AliHLTTPCCAAllocationCounter::NAllocations() - nAllocations;
+}
+
+void AliHLTTPCCAGBTracker::PrepareEvent()
+{
+  //* group the hits by slice, the rest of the preparation is done by PrepareSlice in parallel
   fTime = 0;
   fStatNEvents++;
 
@@ -216,75 +399,194 @@ void AliHLTTPCCAGBTracker::FindTracks()
 
  if ( fNHits <= 0 ) return; // TODO rid of it. Can be problems with performance
 
-#ifdef USE_TBB
-#ifndef NUM_THREADS
-#define NUM_THREADS SINGLE_THREADED ? 1 : tbb::task_scheduler_init::automatic
-#endif
-  tbb::task_scheduler_init *taskScheduler = new tbb::task_scheduler_init( NUM_THREADS );
-#undef NUM_THREADS
-#endif //USE_TBB
-
-SaveHitsInFile(string("d1/event"+std::to_string(fStatNEvents)+"_"));
-
   Stopwatch timer1;
-  Stopwatch timer2;
-
-#ifdef USE_TBB
-  tbb::parallel_sort( fHits.Data(), fHits.Data() + fNHits, AliHLTTPCCAGBHit::Compare );
-#else //USE_TBB
-  std::sort( fHits.Data(), fHits.Data() + fNHits, AliHLTTPCCAGBHit::Compare );
-  /// \brief The necessary data is transfered to the track-finder
-/// The necessary data is transfered to the track-finder
-///Data is structured and saved by track-finders for each sector. 
-///To speed up the process  in each row 2D-grid with the bin size
-///inversely proportional to the number of hits in the row is introduced.
-///Hits are sorted by grid bins and for each grid bin 1st  hit is found and saved. 
-///Such data structure allows to quickly   find closest hits to the point with given
-///coordinates, which is required while neighbours hits are searched and additional 
-///hits are attached to segments.
-#endif //USE_TBB
 
   for ( int i = 0; i < 20; ++i ) {
     fStatTime[i] = 0.;
   }
+
+  if ( fGridProfile.IsTuning() ) { // each row tries the candidate grids in turn
+    for ( int iSlice = 0; iSlice < fNSlices; iSlice++ ) {
+      for ( int iRow = 0; iRow < fSlices[iSlice].Param().NRows(); iRow++ ) {
+        fSlices[iSlice].SetGridCreationCoeff( iRow, fGridProfile.TuningCoeff( iRow, fStatNEvents ) );
+      }
+    }
+  }
   
 //  GroupHits();
-#ifdef USE_TIMERS
-  timer1.Start();
-#endif /// USE_TIMERS
-  
+
+    // Hits are grouped by slice with one counting pass and one scatter pass. The slices are independent
+    // afterwards, so sorting within the slice and creation of the slice data are done in the slice tasks.
   {
-    int offset = 0;
-    int nextSlice = 0;
-    int numberOfUsedSlices = 0;
-
-    fClusterData.Resize(fNSlices);
-    do {
-      fFirstSliceHit[nextSlice] = offset;
-      AliHLTTPCCAClusterData &data = fClusterData[numberOfUsedSlices++];
-      const int iSlice = fHits.Data()[offset].ISlice();
-      data.readEvent( fHits.Data(), &offset, fNHits, fSlices[iSlice].Param().NRows8() );
-
-      while ( nextSlice < iSlice ) {
-        fSlices[nextSlice++].StartEvent();
-        fFirstSliceHit[nextSlice] = fFirstSliceHit[nextSlice - 1];
-        
+      // a hit with the slice or the row out of range would be written outside the slice and row arrays,
+      // so it gets the key fNSlices and is dropped at the end of the hit array
+    const bool isColumns = ( fHitColumns.fX != 0 );
+    fSliceEnd.resize( fNSlices + 1 );
+    for ( int iSlice = 0; iSlice <= fNSlices; iSlice++ ) fSliceEnd[iSlice] = 0;
+    fHitIndexBuffer.resize( fNHits );
+    bool isGrouped = 1;
+    for ( int iHit = 0; iHit < fNHits; iHit++ ) {
+      const int iSlice = isColumns ? fHitColumns.fISlice[iHit] : fHits[iHit].ISlice();
+      const int iRow = isColumns ? fHitColumns.fIRow[iHit] : fHits[iHit].IRow();
+      int key = fNSlices;
+      if ( iSlice >= 0 && iSlice < fNSlices && iRow >= 0 && iRow < fSlices[iSlice].Param().NRows() ) key = iSlice;
+      fHitIndexBuffer[iHit] = key;
+      fSliceEnd[key]++;
+      if ( iHit > 0 && key < fHitIndexBuffer[iHit - 1] ) isGrouped = 0;
+    }
+    const int nBadHits = fSliceEnd[fNSlices];
+    fFirstSliceHit[0] = 0;
+    for ( int iSlice = 0; iSlice < fNSlices; iSlice++ ) {
+      fFirstSliceHit[iSlice + 1] = fFirstSliceHit[iSlice] + fSliceEnd[iSlice];
+      fSliceEnd[iSlice] = fFirstSliceHit[iSlice];
+    }
+    fSliceEnd[fNSlices] = fFirstSliceHit[fNSlices];
+
+    if ( isColumns ) { // only the indices are grouped
+      fInputHitIndex.resize( fNHits );
+      if ( isGrouped ) {
+        for ( int iHit = 0; iHit < fNHits; iHit++ ) fHitIndexBuffer[iHit] = iHit;
+      } else {
+        for ( int iHit = 0; iHit < fNHits; iHit++ ) fInputHitIndex[fSliceEnd[fHitIndexBuffer[iHit]]++] = iHit;
+        std::copy( fInputHitIndex.begin(), fInputHitIndex.begin() + fNHits, fHitIndexBuffer.begin() );
       }
-      ++nextSlice;
-      /// give the data to the slice tracker
-      fSlices[data.Slice()].ReadEvent( &data );
-    } while ( offset < fNHits );
-    while ( nextSlice < fNSlices ) {
-      fFirstSliceHit[nextSlice] = offset;
-      fSlices[nextSlice++].StartEvent();
+    } else {
+      fHitBuffer.resize( fNHits );
+      if ( !isGrouped ) {
+        for ( int iHit = 0; iHit < fNHits; iHit++ ) fHitBuffer[fSliceEnd[fHitIndexBuffer[iHit]]++] = fHits[iHit];
+        std::copy( fHitBuffer.begin(), fHitBuffer.begin() + fNHits, fHits.Data() );
+      }
+    }
+    if ( nBadHits > 0 ) {
+      std::cout << "AliHLTTPCCAGBTracker: " << nBadHits << " hits with the slice or the row out of range are rejected" << std::endl;
+      fNHits -= nBadHits;
     }
   }
-  
-#ifdef USE_TIMERS
+  if ( fClusterData.Size() != fNSlices ) fClusterData.Resize(fNSlices); // the cluster data keeps the memory
+
   timer1.Stop();
-  fStatTime[12] = timer1.RealTime();
-#endif /// USE_TIMERS
-  /// Read hits, row by row
+  fTime += timer1.RealTime();
+}
+
+  /// row and z of the hits given as AliHLTTPCCAGBHit
+class GBHitRowZ
+{
+    const AliHLTTPCCAGBHit *fHits;
+  public:
+    inline GBHitRowZ( const AliHLTTPCCAGBHit *fHits_ ): fHits( fHits_ ) {}
+    inline int IRow( int i ) const { return fHits[i].IRow(); }
+    inline float Z( int i ) const { return fHits[i].Z(); }
+};
+
+  /// row and z of the hits given as columns
+class ColumnsRowZ
+{
+    const int *fRow;
+    const float *fZ;
+  public:
+    inline ColumnsRowZ( const int *fRow_, const float *fZ_ ): fRow( fRow_ ), fZ( fZ_ ) {}
+    inline int IRow( int i ) const { return fRow[i]; }
+    inline float Z( int i ) const { return fZ[i]; }
+};
+
+template<typename THits>
+class HitZLess
+{
+    const THits &fHits;
+  public:
+    inline HitZLess( const THits &fHits_ ): fHits( fHits_ ) {}
+    inline bool operator()( int i, int j ) const { return fHits.Z( i ) < fHits.Z( j ); }
+};
+
+  /// Order of AliHLTTPCCAGBHit::Compare for the hits of one slice: counting sort of the hit indices by row,
+  /// then sort by z inside the rows if they are not sorted yet.
+  /// index[firstHit..endHit) gets ids[firstHit..endHit) reordered, ids = 0 means the indices firstHit..endHit-1.
+template<typename THits>
+static void SortSliceHits( const THits &hits, int firstHit, int endHit, int nRows, const int *ids, int *index )
+{
+  assert( nRows <= AliHLTTPCCAParameters::MaxNumberOfRows8 );
+  int rowFirstHit[AliHLTTPCCAParameters::MaxNumberOfRows8 + 1];
+  int rowEnd[AliHLTTPCCAParameters::MaxNumberOfRows8];
+  for ( int iRow = 0; iRow <= nRows; iRow++ ) rowFirstHit[iRow] = 0;
+  for ( int iHit = firstHit; iHit < endHit; iHit++ ) {
+    const int iRow = hits.IRow( ids ? ids[iHit] : iHit );
+    assert( iRow >= 0 && iRow < nRows );
+    rowFirstHit[iRow + 1]++;
+  }
+  rowFirstHit[0] = firstHit;
+  for ( int iRow = 0; iRow < nRows; iRow++ ) {
+    rowFirstHit[iRow + 1] += rowFirstHit[iRow];
+    rowEnd[iRow] = rowFirstHit[iRow];
+  }
+
+  for ( int iHit = firstHit; iHit < endHit; iHit++ ) {
+    const int id = ids ? ids[iHit] : iHit;
+    index[rowEnd[hits.IRow( id )]++] = id;
+  }
+  const HitZLess<THits> zLess( hits );
+  for ( int iRow = 0; iRow < nRows; iRow++ ) {
+    if ( !std::is_sorted( index + rowFirstHit[iRow], index + rowFirstHit[iRow + 1], zLess ) )
+      std::sort( index + rowFirstHit[iRow], index + rowFirstHit[iRow + 1], zLess );
+  }
+}
+
+void AliHLTTPCCAGBTracker::PrepareSlice( int iSlice )
+{
+  /// \brief The necessary data is transfered to the track-finder
+///Data is structured and saved by track-finders for each sector.
+///To speed up the process  in each row 2D-grid with the bin size
+///inversely proportional to the number of hits in the row is introduced.
+///Hits are sorted by grid bins and for each grid bin 1st  hit is found and saved.
+///Such data structure allows to quickly   find closest hits to the point with given
+///coordinates, which is required while neighbours hits are searched and additional
+///hits are attached to segments.
+  const int firstHit = fFirstSliceHit[iSlice];
+  const int endHit = fFirstSliceHit[iSlice + 1];
+  AliHLTTPCCATracker &slice = fSlices[iSlice];
+  if ( firstHit == endHit ) {
+    slice.StartEvent();
+    return;
+  }
+  const int nRows = slice.Param().NRows8();
+  AliHLTTPCCAClusterData &data = fClusterData[iSlice];
+
+  if ( fHitColumns.fX ) {
+      // the cluster data is filled directly from the columns, in the order of fInputHitIndex
+    int *index = fInputHitIndex.data();
+    if ( fHitColumns.fIsSorted ) {
+      std::copy( fHitIndexBuffer.begin() + firstHit, fHitIndexBuffer.begin() + endHit, index + firstHit );
+    } else {
+      SortSliceHits( ColumnsRowZ( fHitColumns.fIRow, fHitColumns.fZ ), firstHit, endHit, nRows, fHitIndexBuffer.data(), index );
+    }
+    data.readEvent( fHitColumns.fX, fHitColumns.fY, fHitColumns.fZ, fHitColumns.fIRow, fHitColumns.fID,
+                    iSlice, index + firstHit, endHit - firstHit, nRows );
+  } else {
+      // the hits are sorted in place: gathered by the sorted indices into fHitBuffer and copied back,
+      // only if they are not in the order yet (PrepareEvent has done the same for the grouping by slice)
+    int *index = fHitIndexBuffer.data();
+    SortSliceHits( GBHitRowZ( fHits.Data() ), firstHit, endHit, nRows, 0, index );
+    bool isSorted = 1;
+    for ( int iHit = firstHit; iHit < endHit && isSorted; iHit++ ) isSorted = ( index[iHit] == iHit );
+    if ( !isSorted ) {
+      for ( int iHit = firstHit; iHit < endHit; iHit++ ) fHitBuffer[iHit] = fHits[index[iHit]];
+      std::copy( fHitBuffer.begin() + firstHit, fHitBuffer.begin() + endHit, fHits.Data() + firstHit );
+    }
+
+    int offset = firstHit;
+    data.readEvent( fHits.Data(), &offset, endHit, nRows );
+    assert( offset == endHit );
+  }
+    /// give the data to the slice tracker
+  slice.ReadEvent( &data );
+}
+
+void AliHLTTPCCAGBTracker::ReconstructSlices()
+{
+  //* run the slice trackers
+  if ( fNHits <= 0 ) return;
+
+  StartThreads();
+  Stopwatch timer2;
 
 #ifdef USE_TBB
   tbb::spin_mutex mutex;
@@ -295,14 +597,18 @@ SaveHitsInFile(string("d1/event"+std::to_string(fStatNEvents)+"_"));
   timer2.Start();
 #ifdef USE_TBB
   tbb::parallel_for( tbb::blocked_range<int>( 0, fNSlices, 1 ),
-      ReconstructSliceTracks( fSlices, fStatTime, mutex ) );
+      ReconstructSliceTracks( *this, fSlices, fStatTime, mutex ) );
 #else //USE_TBB
+  fSliceTime.resize( fSlices.Size() );
+  fSlicePrepareTime.resize( fSlices.Size() );
+  fThreadPool->ParallelFor( fSlices.Size(), ReconstructSlice( *this, fSlices, fSliceTime.data(), fSlicePrepareTime.data() ) );
+    // sum up in the slice order, so the statistics doesn't depend on the scheduling
   for ( int iSlice = 0; iSlice < fSlices.Size(); ++iSlice ) {
-    Stopwatch timer;
-    AliHLTTPCCATracker &slice = fSlices[iSlice];
-    slice.Reconstruct();
-    timer.Stop();
-    fStatTime[0] += timer.RealTime();
+    const AliHLTTPCCATracker &slice = fSlices[iSlice];
+    fStatTime[0] += fSliceTime[iSlice];
+#ifdef USE_TIMERS
+    fStatTime[12] += fSlicePrepareTime[iSlice];
+#endif // USE_TIMERS
     fStatTime[1] += slice.Timer( 0 );
     fStatTime[2] += slice.Timer( 1 );
     fStatTime[3] += slice.Timer( 2 );
@@ -317,17 +623,41 @@ SaveHitsInFile(string("d1/event"+std::to_string(fStatNEvents)+"_"));
   timer2.Stop();
   fSliceTrackerTime = timer2.RealTime();
   fSliceTrackerCpuTime = timer2.CpuTime();
+  fTime += timer2.RealTime();
+}
+
+void AliHLTTPCCAGBTracker::FinishEvent()
+{
+  //* merge the slice tracks
+  if ( fNHits <= 0 ) return;
 
   Stopwatch timerMerge;
   Merge();
   timerMerge.Stop();
-  timer1.Stop();
   fStatTime[9] += timerMerge.RealTime();
   fStatTime[10] += timerMerge.CpuTime();
-  fTime += timer1.RealTime();
+  fTime += timerMerge.RealTime();
+
+  if ( fGridProfile.IsTuning() ) {
+    for ( int iSlice = 0; iSlice < fNSlices; iSlice++ ) fSlices[iSlice].AddGridStatistics( &fGridProfile );
+  }
+  for ( int iSlice = 0; iSlice < fNSlices; iSlice++ ) {
+    fStatNNeighbourTruncations += fSlices[iSlice].NNeighbourTruncations();
+    fStatNTrackletLaneSteps += fSlices[iSlice].NTrackletLaneSteps();
+    fStatNTrackletActiveLaneSteps += fSlices[iSlice].NTrackletActiveLaneSteps();
+  }
+
+  if ( fDumper ) {
+    if ( fHitColumns.fX ) { // the hits in the order of fInputHitIndex, as the slices have read them
+      fDumper->ProcessEvent( fStatNEvents, fHitColumns.fX, fHitColumns.fY, fHitColumns.fZ, fHitColumns.fISlice, fHitColumns.fIRow, fHitColumns.fID,
+                             fInputHitIndex.data(), fNHits, fTime );
+    } else {
+      fDumper->ProcessEvent( fStatNEvents, fHits.Data(), fNHits, fTime );
+    }
+  }
 
 #ifndef NDEBUG
-  {
+  if ( !fHitColumns.fX ) {
     int iFirstHit = 0;
     for ( int i = 0; i < fNTracks; i++ ) {
       const AliHLTTPCCAGBTrack &t = fTracks[i];
@@ -358,9 +688,6 @@ SaveHitsInFile(string("d1/event"+std::to_string(fStatNEvents)+"_"));
   if ( AliHLTTPCCADisplay::Instance().DrawType() == 1 )
     AliHLTTPCCADisplay::Instance().Ask();
 #endif // MAIN_DRAW
-#ifdef USE_TBB
-  if (taskScheduler) delete taskScheduler;
-#endif //USE_TBB
 }
 
 void AliHLTTPCCAGBTracker::Merge()
@@ -381,28 +708,26 @@ void AliHLTTPCCAGBTracker::Merge()
     fStatTime[13+i] = merger.Timer(i);
   }
 #ifdef CALC_DCA_ON
-  dca_left.clear();
-  dca_right.clear();
-  dca_left = std::move( merger.GetLeftDCA() );
-  dca_right = std::move( merger.GetRightDCA() );
+  dca_left.assign( merger.GetLeftDCA().begin(), merger.GetLeftDCA().end() ); // both copies keep their memory
+  dca_right.assign( merger.GetRightDCA().begin(), merger.GetRightDCA().end() );
 #endif
 
 ///mvz end
 
   AliHLTTPCCAMergerOutput &out = *( merger.Output() );
 #ifdef MERGE_LOOPERS
-  AliHLTTPCCALooperMerger* lmerger = new AliHLTTPCCALooperMerger( out, fHits );
+  if ( !fLooperMerger ) fLooperMerger = new AliHLTTPCCALooperMerger;
+  AliHLTTPCCALooperMerger* lmerger = fLooperMerger;
+  lmerger->SetOutput( &out );
   lmerger->SetSliceParam( fSlices[0].Param() );
   for ( int i = 0; i < fNSlices; i++ ) {
     lmerger->SetSliceData( i, fSlices[i].Output() );
     lmerger->SetSlices(i, &fSlices[i]);
-    lmerger->SetFirstSliceHits( i, fFirstSliceHit[i] );
   }
   lmerger->StartLooperTest();
   lmerger->FillSegments();
   lmerger->CheckSegments();
   lmerger->SaveSegments();
-  delete lmerger;
 #endif
 
   int newNTr(0), newNHits(0);
@@ -414,15 +739,8 @@ void AliHLTTPCCAGBTracker::Merge()
     newNHits += track.NClusters();
   }
 
-  if ( fTrackHits ) delete[] fTrackHits;
-  fTrackHits = 0;
-  if ( fTrackHitsSegmentsId ) delete[] fTrackHitsSegmentsId;
-  fTrackHitsSegmentsId = 0;
-  if ( fTracks ) delete[] fTracks;
-  fTracks = 0;
-  fTrackHits = new int [newNHits];
-  fTrackHitsSegmentsId = new short [newNHits];
-  fTracks = new AliHLTTPCCAGBTrack[newNTr];
+  ReserveTracks( newNTr, newNHits );
+  for ( int itr = 0; itr < newNTr; itr++ ) fTracks[itr] = AliHLTTPCCAGBTrack(); // clean the flags of the previous event
   fNTracks = 0;
 
   int nTrackHits = 0;
@@ -597,6 +915,10 @@ void AliHLTTPCCAGBTracker::Merge()
     }
   }
 #endif
+
+  if ( fHitColumns.fX ) { // the tracks refer to the indices in the input columns
+    for ( int i = 0; i < nTrackHits; i++ ) fTrackHits[i] = fInputHitIndex[fTrackHits[i]];
+  }
 }
 
 
@@ -729,7 +1051,12 @@ void AliHLTTPCCAGBTracker::ReadSettings( std::istream &in )
 //       param.SetRowX(param.RowX(iRow+1)-1,iRow);
 //     }
         
-    fSlices[iSlice].Initialize( param );
+    fSlices[iSlice].Initialize( param, &fGridProfile );
+    fSlices[iSlice].SetTuning( fTuning );
+    fSlices[iSlice].SetDenseNeighboursFinder( fIsDenseNeighboursFinder );
+    fSlices[iSlice].SetRefillTrackletConstructor( fIsRefillTrackletConstructor );
+    fSlices[iSlice].SetStartHitsRowBucket( fStartHitsRowBucket );
+    fSlices[iSlice].SetParallelTrackletVectors( fParallelTrackletVectors );
   }
 }
 
@@ -789,18 +1116,14 @@ void AliHLTTPCCAGBTracker::ReadTracks( std::istream &in )
   fSliceTrackerTime = fTime;
   fStatTime[0] += fTime;
   fStatNEvents++;
-  if (fTrackHits) delete[] fTrackHits;
-  fTrackHits = 0;
   int nTrackHits = 0;
   in >> nTrackHits;
-  fTrackHits = new int [nTrackHits];
+  ReserveTracks( 0, nTrackHits );
   for ( int ih = 0; ih < nTrackHits; ih++ ) {
     in >> TrackHits()[ih];
   }
-  if (fTracks) delete[] fTracks;
-  fTracks = 0;
   in >> fNTracks;
-  fTracks = new AliHLTTPCCAGBTrack[fNTracks];
+  ReserveTracks( fNTracks, 0 );
   for ( int itr = 0; itr < fNTracks; itr++ ) {
     AliHLTTPCCAGBTrack &t = Tracks()[itr];
     in >> t;
@@ -843,14 +1166,15 @@ void AliHLTTPCCAGBTracker::RestoreFromFile( FILE *f )
     fSlices[i].RestoreFromFile( f );
   }
 
-  BinaryStoreRead( fNHits, f );
-  fHits.Resize( fNHits );
+  int nHits = 0;
+  BinaryStoreRead( nHits, f );
+  SetNHits( nHits );
   BinaryStoreRead( fHits.Data(), fNHits, f );
-  fTrackHits = new int[fNHits * 10];
+  ReserveTracks( 0, fNHits * 10 );
   BinaryStoreRead( fTrackHits, fNHits * 10, f );
 
   BinaryStoreRead( fNTracks, f );
-  fTracks = new AliHLTTPCCAGBTrack[fNTracks];
+  ReserveTracks( fNTracks, 0 );
   BinaryStoreRead( fTracks, fNTracks, f );
 
   BinaryStoreRead( fTime, f );
@@ -974,7 +1298,6 @@ void AliHLTTPCCAGBTracker::SetHits( const std::vector<AliHLTTPCCAGBHit> &hits)
 
   SetNHits(NHits2);
 
-  fHits.Resize(NHits2);
   for (int iH = 0; iH < NHits2; iH++){
     fHits[iH] = hits[iH];
   }
@@ -986,26 +1309,121 @@ void AliHLTTPCCAGBTracker::SetHits( const AliHLTTPCCAGBHit *hits, int nHits )
 
   SetNHits(NHits2);
 
-  fHits.Resize(NHits2);
   for (int iH = 0; iH < NHits2; iH++){
     fHits[iH] = hits[iH];
   }
 }
 
+void AliHLTTPCCAGBTracker::SetHits( const AliHLTTPCCAEventFile &event )
+{
+  SetNHits( event.NHits() );
+  event.GetHits( fHits.Data() );
+}
+
+void AliHLTTPCCAGBTracker::SetHitsSoA( int nHits, const float *x, const float *y, const float *z,
+                                       const int *iSlice, const int *iRow, const int *id, bool isSorted )
+{
+  //* the columns aren't copied, the hits are read by PrepareEvent and PrepareSlice
+  fHitColumns.fX = x;
+  fHitColumns.fY = y;
+  fHitColumns.fZ = z;
+  fHitColumns.fISlice = iSlice;
+  fHitColumns.fIRow = iRow;
+  fHitColumns.fID = id;
+  fHitColumns.fIsSorted = isSorted;
+  fNHits = nHits;
+}
+
 void AliHLTTPCCAGBTracker::SetSettings( const std::vector<AliHLTTPCCAParam>& settings )
 {
   SetNSlices( settings.size() );
   for ( int iSlice = 0; iSlice < NSlices(); iSlice++ ) {
-    fSlices[iSlice].Initialize( settings[iSlice] );
+    fSlices[iSlice].Initialize( settings[iSlice], &fGridProfile );
+    fSlices[iSlice].SetTuning( fTuning );
+    fSlices[iSlice].SetDenseNeighboursFinder( fIsDenseNeighboursFinder );
+    fSlices[iSlice].SetRefillTrackletConstructor( fIsRefillTrackletConstructor );
+    fSlices[iSlice].SetStartHitsRowBucket( fStartHitsRowBucket );
+    fSlices[iSlice].SetParallelTrackletVectors( fParallelTrackletVectors );
   }
 }
 
+void AliHLTTPCCAGBTracker::SetDenseNeighboursFinder( bool b )
+{
+  fIsDenseNeighboursFinder = b;
+  for ( int iSlice = 0; iSlice < fNSlices; iSlice++ ) fSlices[iSlice].SetDenseNeighboursFinder( b );
+}
+
+void AliHLTTPCCAGBTracker::SetRefillTrackletConstructor( bool b )
+{
+  fIsRefillTrackletConstructor = b;
+  for ( int iSlice = 0; iSlice < fNSlices; iSlice++ ) fSlices[iSlice].SetRefillTrackletConstructor( b );
+}
+
+void AliHLTTPCCAGBTracker::SetStartHitsRowBucket( int n )
+{
+  fStartHitsRowBucket = n;
+  for ( int iSlice = 0; iSlice < fNSlices; iSlice++ ) fSlices[iSlice].SetStartHitsRowBucket( n );
+}
+
+void AliHLTTPCCAGBTracker::SetParallelTrackletVectors( int n )
+{
+  fParallelTrackletVectors = n;
+  for ( int iSlice = 0; iSlice < fNSlices; iSlice++ ) fSlices[iSlice].SetParallelTrackletVectors( n );
+}
+
+void AliHLTTPCCAGBTracker::SetGridProfile( const AliHLTTPCCAGridProfile &profile )
+{
+  fGridProfile = profile;
+  for ( int iSlice = 0; iSlice < fNSlices; iSlice++ ) fSlices[iSlice].SetGridProfile( fGridProfile );
+}
+
+bool AliHLTTPCCAGBTracker::ReadGridProfile( const string &fileName )
+{
+  AliHLTTPCCAGridProfile profile;
+  if ( !profile.ReadFromFile( fileName ) ) return 0;
+  SetGridProfile( profile );
+  return 1;
+}
+
+void AliHLTTPCCAGBTracker::SetTuning( const AliHLTTPCCAParam::Tuning &tuning )
+{
+  fTuning = tuning;
+  for ( int iSlice = 0; iSlice < fNSlices; iSlice++ ) fSlices[iSlice].SetTuning( fTuning );
+}
+
+bool AliHLTTPCCAGBTracker::ReadTuning( const string &fileName )
+{
+  ifstream in( fileName.c_str() );
+  if ( !in.is_open() ) return 0;
+  AliHLTTPCCAParam::Tuning tuning( fTuning );
+  if ( !tuning.Read( in ) ) return 0;
+  SetTuning( tuning );
+  return 1;
+}
+
+void AliHLTTPCCAGBTracker::StartGridTuning()
+{
+  fGridProfile.StartTuning( fNSlices > 0 ? fSlices[0].Param().NRows() : 0 );
+}
+
+void AliHLTTPCCAGBTracker::FinishGridTuning()
+{
+  fGridProfile.FinishTuning();
+  SetGridProfile( fGridProfile );
+}
+
+void AliHLTTPCCAGBTracker::SetDumpPolicy( AliHLTTPCCAEventDumper::EMode mode, double threshold, const string &prefix )
+{
+  if ( !fDumper ) fDumper = new AliHLTTPCCAEventDumper;
+  fDumper->SetPolicy( mode, threshold, prefix );
+}
+
 void AliHLTTPCCAGBTracker::SaveHitsInFile(string prefix) const
 {
     ofstream ofile((prefix+"hits.data").data(),std::ios::out|std::ios::app);
-    const int Size = fHits.Size();
+    const int Size = fNHits;
     ofile << Size << std::endl;
-    for (int i = 0; i < fHits.Size(); i++){
+    for (int i = 0; i < Size; i++){
       const AliHLTTPCCAGBHit &l = fHits[i];
       ofile << l;
     }
@@ -1021,11 +1439,12 @@ void AliHLTTPCCAGBTracker::SaveSettingsInFile(string prefix) const
 
 bool AliHLTTPCCAGBTracker::ReadHitsFromFile(string prefix)
 {
+    if ( ReadHitsFromBinaryFile( prefix ) ) return 1;
+
     ifstream ifile((prefix+"hits.data").data());
     if ( !ifile.is_open() ) return 0;
     int Size;
     ifile >> Size;
-    fHits.Resize(Size);
     SetNHits(Size);
     for (int i = 0; i < Size; i++){
       AliHLTTPCCAGBHit &l = fHits[i];
@@ -1035,6 +1454,14 @@ bool AliHLTTPCCAGBTracker::ReadHitsFromFile(string prefix)
     return 1;
 }
 
+bool AliHLTTPCCAGBTracker::ReadHitsFromBinaryFile(string prefix)
+{
+  AliHLTTPCCAEventFile event;
+  if ( !event.Open( prefix+"hits.bin" ) ) return 0;
+  SetHits( event );
+  return 1;
+}
+
 bool AliHLTTPCCAGBTracker::ReadSettingsFromFile(string prefix)
 {
   ifstream ifile((prefix+"settings.data").data());
@@ -31,6 +31,8 @@
 #include "AliHLTTPCCAGBHit.h"
 #include "AliHLTTPCCAGBTrack.h"
 #include "AliHLTTPCCATracker.h"
+#include "AliHLTTPCCAEventDumper.h"
+#include "AliHLTTPCCAGridProfile.h"
 
 #include <cstdio>
 #include <iostream>
@@ -39,6 +41,12 @@
 using std::string;
 
 class AliHLTTPCCAMerger;
+class AliHLTTPCCALooperMerger;
+class AliHLTTPCCAEventFile;
+class AliHLTTPCCAThreadPool;
+#ifdef USE_TBB
+namespace tbb { class task_scheduler_init; }
+#endif //USE_TBB
 
 /**
  * @class AliHLTTPCCAGBTracker
@@ -60,15 +68,40 @@ class AliHLTTPCCAGBTracker
   public:
     AliHLTTPCCAGBTracker();
     ~AliHLTTPCCAGBTracker();
-    void Init();
+    void Init(); // also starts the worker threads, otherwise they are started by the first FindTracks
+
+      /// Number of threads used for the slice reconstruction. 0 - all hardware threads (default). 1 with SINGLE_THREADED.
+    void SetNThreads( int n );
+    int NThreads() const;
+      /// Use a pool shared with other trackers instead of an own one. The pool isn't deleted by the tracker. Ignored with TBB.
+    void SetThreadPool( AliHLTTPCCAThreadPool *pool );
+
+      /// Allocate the memory for events with up to maxNHits hits and maxNTracks tracks, so FindTracks
+      /// doesn't allocate it event by event: the slice data, tracklets and tracks, the merger and the looper
+      /// merger. Call after SetSettings. The border candidates of the merger and the arena blocks have no bound
+      /// in the track number and are sized by the first events. All the memory is only grown by the later
+      /// events, so after a few events the reconstruction runs without allocations even without Preallocate.
+      /// Build with COUNT_ALLOCATIONS to check it with AliHLTTPCCAAllocationCounter.
+    void Preallocate( int maxNHits, int maxNTracks );
 
     void StartEvent();
     void SetNSlices( int N );
     void SetNHits( int nHits );
 
-    void FindTracks();
+    void FindTracks(); // PrepareEvent, ReconstructSlices and FinishEvent
+      /// Heap allocations of the whole program during the last FindTracks, see AliHLTTPCCAAllocationCounter
+    long NAllocations() const { return fNAllocations; }
+
+      /// Steps of FindTracks, used separately by AliHLTTPCCAEventPipeline
+    void PrepareEvent();      // group the hits by slice
+    void ReconstructSlices(); // PrepareSlice and run the slice tracker for all slices in parallel
+    void FinishEvent();       // merge the slice tracks
+
+      /// Sort the hits of the slice, fill its cluster data and give it to the slice tracker. Part of ReconstructSlices.
+    void PrepareSlice( int iSlice );
 
     void Merge();
+    const AliHLTTPCCAMerger &Merger() const { return *fMerger; }
 
     AliHLTArray<AliHLTTPCCATracker> Slices() const { return fSlices; }
     const AliHLTTPCCATracker &Slice( int index ) const { return fSlices[index]; }
@@ -81,6 +114,9 @@ class AliHLTTPCCAGBTracker
     double StatTime( int iTimer ) const { return fStatTime[iTimer]; }
     int NTimers() const { return fNTimers; }
     int StatNEvents() const { return fStatNEvents; }
+    long StatNNeighbourTruncations() const { return fStatNNeighbourTruncations; } // hits with more than MaxNeighboursUp upper neighbours, all events
+    long StatNTrackletLaneSteps() const { return fStatNTrackletLaneSteps; } // lanes of the TrackletConstructor row steps, all events
+    long StatNTrackletActiveLaneSteps() const { return fStatNTrackletActiveLaneSteps; } // the ones with a tracklet, all events
     int NTracks() const { return fNTracks; }
     AliHLTTPCCAGBTrack *Tracks() const { return fTracks; }
     AliHLTTPCCAGBTrack *Tracks() { return fTracks; }
@@ -104,9 +140,42 @@ class AliHLTTPCCAGBTracker
     void WriteTracks( const string& prefix ) const;
     void ReadTracks( std::istream &in );
 
+      /// Select events which input hits are saved in binary files, see AliHLTTPCCAEventDumper. Nothing is saved by default.
+    void SetDumpPolicy( AliHLTTPCCAEventDumper::EMode mode, double threshold, const string &prefix );
+    const AliHLTTPCCAEventDumper *Dumper() const { return fDumper; }
+
+      /// Grid creation coefficients of the rows, see AliHLTTPCCAGridProfile. Kept when the settings are read again.
+    void SetGridProfile( const AliHLTTPCCAGridProfile &profile );
+    bool ReadGridProfile( const string &fileName ); // the profile is kept if the file can't be read
+    const AliHLTTPCCAGridProfile &GridProfile() const { return fGridProfile; }
+      /// Tune the grid coefficients on the next events, FinishGridTuning sets the best ones. Needs TUNE_GRID.
+    void StartGridTuning();
+    void FinishGridTuning();
+
+      /// Cuts of the iterations of the slice trackers (see AliHLTTPCCAParam::Tuning), default from AliHLTTPCCAParameters.
+      /// Kept when the settings are read again, SetSettings also gives them to the slices.
+    void SetTuning( const AliHLTTPCCAParam::Tuning &tuning );
+    bool ReadTuning( const string &fileName ); // the tuning is kept if the file can't be read
+    const AliHLTTPCCAParam::Tuning &Tuning() const { return fTuning; }
+
+      /// NeighboursFinder kernel of the slice trackers, see AliHLTTPCCATracker::SetDenseNeighboursFinder
+    void SetDenseNeighboursFinder( bool b );
+    bool IsDenseNeighboursFinder() const { return fIsDenseNeighboursFinder; }
+
+      /// TrackletConstructor mode of the slice trackers, see AliHLTTPCCATracker::SetRefillTrackletConstructor
+    void SetRefillTrackletConstructor( bool b );
+    bool IsRefillTrackletConstructor() const { return fIsRefillTrackletConstructor; }
+      /// packing of the start hits of the slice trackers, see AliHLTTPCCATracker::SetStartHitsRowBucket
+    void SetStartHitsRowBucket( int n );
+    int StartHitsRowBucket() const { return fStartHitsRowBucket; }
+      /// parallel waves of the TrackletConstructor of the slice trackers, see AliHLTTPCCATracker::SetParallelTrackletVectors
+    void SetParallelTrackletVectors( int n );
+    int ParallelTrackletVectors() const { return fParallelTrackletVectors; }
+
     void SaveHitsInFile( string prefix ) const; // Save Hits in txt file. @prefix - prefix for file name. Ex: "./data/ev1"
     void SaveSettingsInFile( string prefix ) const; // Save geometry in txt file. @prefix - prefix for file name. Ex: "./data/"
-    bool ReadHitsFromFile( string prefix );
+    bool ReadHitsFromFile( string prefix ); // Read "hits.bin" if it exists, "hits.data" otherwise
+    bool ReadHitsFromBinaryFile( string prefix ); // Read hits from the binary file @prefix+"hits.bin" (see AliHLTTPCCAEventFile)
     bool ReadSettingsFromFile( string prefix );
 
     double SliceTrackerTime() const { return fSliceTrackerTime; }
@@ -119,8 +188,15 @@ class AliHLTTPCCAGBTracker
     
     void SetHits( const std::vector<AliHLTTPCCAGBHit> &hits);     // need for StRoot
     void SetHits( const AliHLTTPCCAGBHit *hits, int nHits );      // for CA_parallel
+    void SetHits( const AliHLTTPCCAEventFile &event );            // directly from the mapped binary event
+      /// Hits given as columns, read directly into the cluster data of the slices. Nothing is copied, so the
+      /// arrays must stay valid until FinishEvent. isSorted - the hits are sorted by slice, row and z already.
+      /// TrackHits() are then indices in these arrays and Hits() isn't filled. The errors and amplitudes
+      /// aren't used by the slice tracker, so they aren't needed.
+    void SetHitsSoA( int nHits, const float *x, const float *y, const float *z,
+                     const int *iSlice, const int *iRow, const int *id, bool isSorted = 0 );
     void SetSettings( const std::vector<AliHLTTPCCAParam>& settings ); // need for StRoot
-    int  GetHitsSize() const {return fHits.Size();}
+    int  GetHitsSize() const {return fNHits;}
 
 #ifdef CALC_DCA_ON
   vector<point_3d>& GetLeftDCA() { return dca_left; }
@@ -135,13 +211,30 @@ class AliHLTTPCCAGBTracker
     AliHLTResizableArray<AliHLTTPCCATracker> fSlices; //* array of slice trackers
     int fNSlices;              //* N slices
     AliHLTResizableArray<AliHLTTPCCAGBHit> fHits;     //* hit array
-    int *fExt2IntHitID;        //* array of internal hit indices
+    int *fExt2IntHitID;        //* array of internal hit indices, has fHits.Size() elements
     int fNHits;                //* N hits in event
     int *fTrackHits;           //* track->hits reference array
     short *fTrackHitsSegmentsId;           //* track->hit's segment id reference array
     AliHLTTPCCAGBTrack *fTracks; //* array of tracks
     int fNTracks;              //* N tracks
+    int fTracksCapacity;       //* size of fTracks
+    int fTrackHitsCapacity;    //* size of fTrackHits and fTrackHitsSegmentsId
     AliHLTTPCCAMerger *fMerger;  //* global merger
+    AliHLTTPCCALooperMerger *fLooperMerger; //* MERGE_LOOPERS, created with the first event and kept to reuse its memory
+    AliHLTTPCCAEventDumper *fDumper; //* saves hits of selected events, created with the first SetDumpPolicy
+    AliHLTTPCCAGridProfile fGridProfile; //* grid coefficients of the slice trackers
+    bool fIsDenseNeighboursFinder; //* NeighboursFinder kernel of the slice trackers
+    bool fIsRefillTrackletConstructor; //* TrackletConstructor mode of the slice trackers
+    int fStartHitsRowBucket; //* packing of the start hits of the slice trackers
+    int fParallelTrackletVectors; //* parallel waves of the TrackletConstructor of the slice trackers
+    AliHLTTPCCAParam::Tuning fTuning; //* cuts of the iterations of the slice trackers
+    int fNThreads;               //* requested number of threads, 0 - all
+#ifdef USE_TBB
+    tbb::task_scheduler_init *fTaskScheduler; //* kept for all events
+#else
+    AliHLTTPCCAThreadPool *fThreadPool; //* persistent workers for the slice trackers
+    bool fOwnThreadPool;                //* fThreadPool is created and deleted by the tracker
+#endif //USE_TBB
 #ifdef CALC_DCA_ON
     vector<point_3d> dca_left;
     vector<point_3d> dca_right;
@@ -153,12 +246,32 @@ class AliHLTTPCCAGBTracker
     static const int fNTimers = 25;
     double fStatTime[fNTimers]; //* timers
     int fStatNEvents;    //* n events proceed
+    long fStatNNeighbourTruncations; //* see StatNNeighbourTruncations()
+    long fStatNTrackletLaneSteps; //* see StatNTrackletLaneSteps()
+    long fStatNTrackletActiveLaneSteps; //* see StatNTrackletActiveLaneSteps()
     int fFirstSliceHit[100]; // hit array
 
     double fSliceTrackerTime; // reco time of the slice tracker;
     double fSliceTrackerCpuTime; // reco time of the slice tracker;
+    std::vector<double> fSliceTime; //* reco time of each slice, kept to reuse the memory
+    std::vector<double> fSlicePrepareTime; //* PrepareSlice time of each slice
+    std::vector<AliHLTTPCCAGBHit> fHitBuffer; //* used to reorder the hits, by PrepareEvent and by PrepareSlice in the slice ranges
+    std::vector<int> fHitIndexBuffer;         //* new order of the hits, used by PrepareSlice in the slice ranges
+    std::vector<int> fSliceEnd;               //* PrepareEvent: fill position of each slice, fNSlices for the rejected hits
+    long fNAllocations;             //* see NAllocations()
+
+    struct HitColumns {
+      HitColumns(): fX( 0 ), fY( 0 ), fZ( 0 ), fISlice( 0 ), fIRow( 0 ), fID( 0 ), fIsSorted( 0 ) {}
+      const float *fX, *fY, *fZ;
+      const int *fISlice, *fIRow, *fID;
+      bool fIsSorted;
+    } fHitColumns;                  //* set by SetHitsSoA, fX = 0 for the hits in fHits
+    std::vector<int> fInputHitIndex; //* SetHitsSoA: column index of the hits in the slice order
 
   private:
+    void StartThreads(); // create fTaskScheduler or fThreadPool if they don't exist
+    void ReserveTracks( int nTracks, int nTrackHits ); // grow fTracks, fTrackHits and fTrackHitsSegmentsId if needed
+
     AliHLTTPCCAGBTracker( const AliHLTTPCCAGBTracker& );
     AliHLTTPCCAGBTracker &operator=( const AliHLTTPCCAGBTracker& );
 };
@@ -0,0 +1,87 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALIHLTTPCCAGATHERSCATTER_H
+#define ALIHLTTPCCAGATHERSCATTER_H
+
+#include "AliHLTTPCCADef.h"
+
+/**
+ * Indexed access of the vectors to the hit arrays.
+ *
+ * With VC_GATHER_SCATTER the Vc gathers and scatters are used, they are compiled to the gather
+ * instructions for the 32-bit data on AVX2 (and MIC). Otherwise the masked lanes are loaded and
+ * stored one by one, which is faster than the emulated gathers of the SSE and scalar builds.
+ * The masked gathers change only the lanes in the mask, the other lanes are kept as they are.
+ */
+namespace CAGatherScatter
+{
+  template<typename V, typename T> static inline void Gather( V &v, const T *array, const uint_v &index, const typename V::Mask &mask )
+  {
+#ifdef VC_GATHER_SCATTER
+    v.gather( array, index, mask );
+#else
+    for( unsigned int i = 0; i < V::Size; i++ ) {
+      if( !mask[i] ) continue;
+      v[i] = array[(unsigned int)index[i]];
+    }
+#endif
+  }
+
+  template<typename V, typename T> static inline void Gather( V &v, const T *array, const uint_v &index )
+  {
+#ifdef VC_GATHER_SCATTER
+    v.gather( array, index );
+#else
+    for( unsigned int i = 0; i < V::Size; i++ ) {
+      v[i] = array[(unsigned int)index[i]];
+    }
+#endif
+  }
+
+  template<typename V, typename T> static inline void Scatter( const V &v, T *array, const uint_v &index, const typename V::Mask &mask )
+  {
+#ifdef VC_GATHER_SCATTER
+    v.scatter( array, index, mask );
+#else
+    for( unsigned int i = 0; i < V::Size; i++ ) {
+      if( !mask[i] ) continue;
+      array[(unsigned int)index[i]] = v[i];
+    }
+#endif
+  }
+
+  template<typename V, typename T> static inline void Scatter( const V &v, T *array, const uint_v &index )
+  {
+#ifdef VC_GATHER_SCATTER
+    v.scatter( array, index );
+#else
+    for( unsigned int i = 0; i < V::Size; i++ ) {
+      array[(unsigned int)index[i]] = v[i];
+    }
+#endif
+  }
+}
+
+#endif // ALIHLTTPCCAGATHERSCATTER_H
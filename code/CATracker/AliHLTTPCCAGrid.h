@@ -104,10 +104,6 @@ inline void AliHLTTPCCAGrid::GetBinBounded( const float_v &Y, const float_v &Z,
 
   *bY = CAMath::Max( int_v( Vc::Zero ), CAMath::Min( int_v( fNy - 1 ), yBin ) ).staticCast<uint_v>();
   *bZ = CAMath::Max( int_v( Vc::Zero ), CAMath::Min( int_v( fNz - 1 ), zBin ) ).staticCast<uint_v>();
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    (*bY)[i] = (int)(*bY)[i];
-    (*bZ)[i] = (int)(*bZ)[i];
-  }
 }
 
 inline unsigned int AliHLTTPCCAGrid::GetBinBounded( const float &Y, const float &Z ) const
@@ -0,0 +1,124 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AliHLTTPCCAGridProfile.h"
+#include "AliHLTTPCCAMath.h"
+
+#include <fstream>
+
+AliHLTTPCCAGridProfile::AliHLTTPCCAGridProfile()
+  : fNRows( AliHLTTPCCAParameters::MaxNumberOfRows8 ), fIsTuning( 0 )
+{
+  for ( int iRow = 0; iRow < AliHLTTPCCAParameters::MaxNumberOfRows8; iRow++ ) {
+    fCoeff[iRow] = AliHLTTPCCAParameters::GridCreationCoeff;
+    for ( int i = 0; i < NCandidates; i++ ) {
+      fNQueries[iRow][i] = 0;
+      fNVisited[iRow][i] = 0;
+    }
+  }
+}
+
+void AliHLTTPCCAGridProfile::SetCoeff( int iRow, float coeff )
+{
+  fCoeff[iRow] = CAMath::Max( Candidate( 0 ), CAMath::Min( Candidate( NCandidates - 1 ), coeff ) );
+}
+
+void AliHLTTPCCAGridProfile::StartTuning( int nRows )
+{
+  fNRows = nRows;
+  fIsTuning = 1;
+  for ( int iRow = 0; iRow < AliHLTTPCCAParameters::MaxNumberOfRows8; iRow++ ) {
+    for ( int i = 0; i < NCandidates; i++ ) {
+      fNQueries[iRow][i] = 0;
+      fNVisited[iRow][i] = 0;
+    }
+  }
+}
+
+void AliHLTTPCCAGridProfile::AddStatistics( int iRow, float coeff, int nQueries, int nHits, int nZLines )
+{
+  for ( int i = 0; i < NCandidates; i++ ) {
+    if ( coeff != Candidate( i ) ) continue;
+    fNQueries[iRow][i] += nQueries;
+    fNVisited[iRow][i] += nHits + nZLines;
+    return;
+  }
+}
+
+double AliHLTTPCCAGridProfile::Cost( int iRow, int iCandidate ) const
+{
+  if ( fNQueries[iRow][iCandidate] <= 0 ) return -1;
+  return fNVisited[iRow][iCandidate] / fNQueries[iRow][iCandidate];
+}
+
+void AliHLTTPCCAGridProfile::FinishTuning()
+{
+  fIsTuning = 0;
+  for ( int iRow = 0; iRow < fNRows; iRow++ ) {
+    int best = -1;
+    for ( int i = 0; i < NCandidates; i++ ) {
+      if ( Cost( iRow, i ) < 0 ) continue;
+      if ( best < 0 || Cost( iRow, i ) < Cost( iRow, best ) ) best = i;
+    }
+    if ( best >= 0 ) fCoeff[iRow] = Candidate( best );
+  }
+}
+
+bool AliHLTTPCCAGridProfile::Read( std::istream &in )
+{
+  int nRows = 0;
+  in >> nRows;
+  if ( !in || nRows <= 0 || nRows > AliHLTTPCCAParameters::MaxNumberOfRows8 ) return 0;
+  float coeff[AliHLTTPCCAParameters::MaxNumberOfRows8];
+  for ( int iRow = 0; iRow < nRows; iRow++ ) {
+    in >> coeff[iRow];
+    if ( !in ) return 0; // the profile is kept
+  }
+  for ( int iRow = 0; iRow < nRows; iRow++ ) SetCoeff( iRow, coeff[iRow] );
+  fNRows = nRows;
+  return 1;
+}
+
+void AliHLTTPCCAGridProfile::Write( std::ostream &out ) const
+{
+  out << fNRows << std::endl;
+  for ( int iRow = 0; iRow < fNRows; iRow++ ) {
+    out << fCoeff[iRow] << std::endl;
+  }
+}
+
+bool AliHLTTPCCAGridProfile::ReadFromFile( const std::string &fileName )
+{
+  std::ifstream in( fileName.c_str() );
+  if ( !in.is_open() ) return 0;
+  return Read( in );
+}
+
+bool AliHLTTPCCAGridProfile::WriteToFile( const std::string &fileName ) const
+{
+  std::ofstream out( fileName.c_str() );
+  if ( !out.is_open() ) return 0;
+  Write( out );
+  return out.good();
+}
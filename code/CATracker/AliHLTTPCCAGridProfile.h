@@ -0,0 +1,85 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALIHLTTPCCAGRIDPROFILE_H
+#define ALIHLTTPCCAGRIDPROFILE_H
+
+#include "AliHLTTPCCAParameters.h"
+
+#include <iostream>
+#include <string>
+
+/**
+ * @class AliHLTTPCCAGridProfile
+ *
+ * Grid creation coefficients of the rows: the grid of a row with n hits has about coeff*n cells,
+ * see AliHLTTPCCASliceData::createGrid. By default all rows use AliHLTTPCCAParameters::GridCreationCoeff.
+ *
+ * The coefficients can be tuned on the data. During the tuning each row uses the Candidate() coefficients
+ * in turn, event by event, and the hits and z-lines of the grid visited by the hit area queries
+ * (AliHLTTPCCAHitArea, AliHLTTPCCAHitAreaScalar) are accumulated for each candidate. A coarse grid gives
+ * many hits per query, a fine one many empty z-lines, so FinishTuning takes for each row the candidate
+ * with the smallest number of visited hits and z-lines per query.
+ * The queries are counted only when built with TUNE_GRID.
+ *
+ * The profile is a text file with the number of rows and the coefficient of each row.
+ */
+class AliHLTTPCCAGridProfile
+{
+  public:
+    AliHLTTPCCAGridProfile();
+
+#ifdef TUNE_GRID
+    static bool StatisticsEnabled() { return 1; }
+#else
+    static bool StatisticsEnabled() { return 0; }
+#endif // TUNE_GRID
+
+    float Coeff( int iRow ) const { return fCoeff[iRow]; }
+    void SetCoeff( int iRow, float coeff ); // limited to the candidate range
+
+    enum { NCandidates = 5 };
+    static float Candidate( int i ) { return 0.5f * ( 1 << i ); } // 0.5 .. 8
+
+    void StartTuning( int nRows ); // clean the statistics
+    bool IsTuning() const { return fIsTuning; }
+    float TuningCoeff( int iRow, int iEvent ) const { return Candidate( ( iRow + iEvent ) % NCandidates ); }
+    void AddStatistics( int iRow, float coeff, int nQueries, int nHits, int nZLines ); // coeff is one of the candidates
+    void FinishTuning(); // the rows without queries keep the coefficient
+    double Cost( int iRow, int iCandidate ) const; // visited hits and z-lines per query, -1 without queries
+
+    bool Read( std::istream &in );
+    void Write( std::ostream &out ) const;
+    bool ReadFromFile( const std::string &fileName );
+    bool WriteToFile( const std::string &fileName ) const;
+
+  private:
+    int fNRows; // number of rows with the tuned or read coefficients
+    float fCoeff[AliHLTTPCCAParameters::MaxNumberOfRows8];
+    bool fIsTuning;
+    double fNQueries[AliHLTTPCCAParameters::MaxNumberOfRows8][NCandidates]; // hit area queries on the row
+    double fNVisited[AliHLTTPCCAParameters::MaxNumberOfRows8][NCandidates]; // visited hits and z-lines
+};
+
+#endif // ALIHLTTPCCAGRIDPROFILE_H
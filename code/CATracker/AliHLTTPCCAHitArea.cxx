@@ -34,6 +34,9 @@ AliHLTTPCCAHitArea::AliHLTTPCCAHitArea( const AliHLTTPCCARow &row, const AliHLTT
   fHitYlst( Vc::Zero ),
   fIh( Vc::Zero ),
   fNy( fRow.Grid().Ny() )
+#ifdef TUNE_GRID
+  , fNQueries( mask.count() ), fNVisitedHits( 0 ), fNVisitedZLines( 0 )
+#endif // TUNE_GRID
 {
   const AliHLTTPCCAGrid &grid = fRow.Grid();
 
@@ -63,16 +66,8 @@ AliHLTTPCCAHitArea::AliHLTTPCCAHitArea( const AliHLTTPCCARow &row, const AliHLTT
     fIz.setZero( invalidMask );
 
       // for given fIz (which is min atm.) get
-#ifdef VC_GATHER_SCATTER
-    fIh.gather( fSlice.FirstUnusedHitInBin( fRow ), fIndYmin, mask ); // first and
-    fHitYlst.gather( fSlice.FirstUnusedHitInBin( fRow ), fIndYmin + fBDY, mask ); // last hit index in the bin
-#else
-    for( unsigned int i = 0; i < float_v::Size; i++ ) {
-      if( !mask[i] ) continue;
-      fIh[i] = (int)fSlice.FirstUnusedHitInBin( fRow )[(unsigned int)fIndYmin[i]];
-      fHitYlst[i] = (int)fSlice.FirstUnusedHitInBin( fRow )[(unsigned int)(fIndYmin[i] + fBDY[i])];
-    }
-#endif
+    CAGatherScatter::Gather( fIh, fSlice.FirstUnusedHitInBin( fRow ), fIndYmin, mask ); // first and
+    CAGatherScatter::Gather( fHitYlst, fSlice.FirstUnusedHitInBin( fRow ), fIndYmin + fBDY, mask ); // last hit index in the bin
   } else {
     fIh = fSlice.FirstUnusedHitInBin( fRow, fIndYmin );
     fHitYlst = fSlice.FirstUnusedHitInBin( fRow, fIndYmin + fBDY );
@@ -114,22 +109,17 @@ uint_m AliHLTTPCCAHitArea::GetNext( NeighbourData *data )
 
     // skip as long as fIh is outside of the interesting bin y-index
   while ( !needNextZ.isEmpty() ) {
+#ifdef TUNE_GRID
+    fNVisitedZLines += needNextZ.count();
+#endif // TUNE_GRID
     
     ++fIz( needNextZ );
     nextZIndexOutOfRange = fIz >= fBZmax;
     
       // get next hit
     fIndYmin( needNextZ ) += fNy;
-#ifdef VC_GATHER_SCATTER
-    fIh.gather( fSlice.FirstUnusedHitInBin( fRow ), fIndYmin, needNextZ ); // get first hit in cell, if z-line is new
-    fHitYlst.gather( fSlice.FirstUnusedHitInBin( fRow ), fIndYmin + fBDY, needNextZ );
-#else
-    for( unsigned int i = 0; i < float_v::Size; i++ ) {
-      if( !needNextZ[i] ) continue;
-      fIh[i] = (int)fSlice.FirstUnusedHitInBin( fRow )[(unsigned int)fIndYmin[i]];
-      fHitYlst[i] = (int)fSlice.FirstUnusedHitInBin( fRow )[(unsigned int)(fIndYmin[i] + fBDY[i])];
-    }
-#endif
+    CAGatherScatter::Gather( fIh, fSlice.FirstUnusedHitInBin( fRow ), fIndYmin, needNextZ ); // get first hit in cell, if z-line is new
+    CAGatherScatter::Gather( fHitYlst, fSlice.FirstUnusedHitInBin( fRow ), fIndYmin + fBDY, needNextZ );
     assert( (fHitYlst <= fRow.NUnusedHits() || !needNextZ).isFull() );
     
     yIndexOutOfRange = fIh >= fHitYlst;
@@ -147,6 +137,9 @@ uint_m AliHLTTPCCAHitArea::GetNext( NeighbourData *data )
   }
   
   ++fIh;
+#ifdef TUNE_GRID
+  fNVisitedHits += ( !yIndexOutOfRange ).count();
+#endif // TUNE_GRID
 
   return !yIndexOutOfRange;
 }
@@ -163,16 +156,8 @@ uint_v AliHLTTPCCAHitArea::NHits()
   while ( !needNextZ.isEmpty() ) {
     ++iz( needNextZ );   // get new z-line
     indYmin( needNextZ ) += fNy;
-#ifdef VC_GATHER_SCATTER
-    ih.gather( fSlice.FirstUnusedHitInBin( fRow ), indYmin, needNextZ ); // get first hit in cell, if z-line is new
-    hitYlst.gather( fSlice.FirstUnusedHitInBin( fRow ), indYmin + fBDY, needNextZ );
-#else
-    for( unsigned int i = 0; i < float_v::Size; i++ ) {
-      if( !needNextZ[i] ) continue;
-      ih[i] = (int)fSlice.FirstUnusedHitInBin( fRow )[(unsigned int)indYmin[i]];
-      hitYlst[i] = (int)fSlice.FirstUnusedHitInBin( fRow )[(unsigned int)(indYmin[i] + fBDY[i])];
-    }
-#endif
+    CAGatherScatter::Gather( ih, fSlice.FirstUnusedHitInBin( fRow ), indYmin, needNextZ ); // get first hit in cell, if z-line is new
+    CAGatherScatter::Gather( hitYlst, fSlice.FirstUnusedHitInBin( fRow ), indYmin + fBDY, needNextZ );
     nHits( needNextZ ) += hitYlst - ih;
     
     needNextZ = iz < fBZmax;
@@ -56,6 +56,10 @@ class AliHLTTPCCAHitArea
     uint_m GetNext( NeighbourData *data = 0 );
 
     uint_v NHits(); // can be called only before GetNext
+
+#ifdef TUNE_GRID
+    ~AliHLTTPCCAHitArea() { fRow.AddAreaStatistics( fNQueries, fNVisitedHits, fNVisitedZLines ); }
+#endif // TUNE_GRID
   
   protected:
     const AliHLTTPCCARow &fRow;
@@ -68,6 +72,9 @@ class AliHLTTPCCAHitArea
     uint_v fHitYlst; //
     uint_v fIh;      // hit index iterating inside the bins
     int fNy;      // Number of bins in Y direction
+#ifdef TUNE_GRID
+    int fNQueries, fNVisitedHits, fNVisitedZLines; // see AliHLTTPCCAGridProfile
+#endif // TUNE_GRID
 };
 
 typedef AliHLTTPCCAHitArea HitArea;
@@ -91,7 +98,11 @@ class AliHLTTPCCAHitAreaScalar
 //    AliHLTTPCCAHitAreaScalar( const AliHLTTPCCARow &row, const unsigned int iRow, const AliHLTTPCCASliceData &slice, const float &y, const float &z, float dy, float dz );
   AliHLTTPCCAHitAreaScalar( const AliHLTTPCCARow &row, const unsigned int iRow, const AliHLTTPCCASliceData &slice, float minY, float minZ, float maxY, float maxZ );
 
+#ifdef TUNE_GRID
+    ~AliHLTTPCCAHitAreaScalar() { fRow.AddAreaStatistics( 1, fNVisitedHits, fNVisitedZLines ); }
+#else
     ~AliHLTTPCCAHitAreaScalar() {};
+#endif // TUNE_GRID
 
     bool GetNext( int& i );
 
@@ -108,6 +119,9 @@ class AliHLTTPCCAHitAreaScalar
     unsigned int fHitYlst; //
     unsigned int fIh;      // hit index iterating inside the bins
     int fNy;      // Number of bins in Y direction
+#ifdef TUNE_GRID
+    int fNVisitedHits, fNVisitedZLines; // see AliHLTTPCCAGridProfile
+#endif // TUNE_GRID
 };
 
 typedef AliHLTTPCCAHitAreaScalar HitAreaScalar;
@@ -117,6 +131,9 @@ inline AliHLTTPCCAHitAreaScalar::AliHLTTPCCAHitAreaScalar( const AliHLTTPCCARow
   , fHitYlst( 0 )
   , fIh( 0 )
   , fNy( fRow.Grid().Ny() )
+#ifdef TUNE_GRID
+  , fNVisitedHits( 0 ), fNVisitedZLines( 0 )
+#endif // TUNE_GRID
 {
   UNUSED_PARAM1(iRow);
   const AliHLTTPCCAGrid &grid = fRow.Grid();
@@ -148,6 +165,9 @@ inline bool AliHLTTPCCAHitAreaScalar::GetNext( int& i )
 
   // skip as long as fIh is outside of the interesting bin y-index
   while ( ISLIKELY( needNextZ ) ) {
+#ifdef TUNE_GRID
+    fNVisitedZLines++;
+#endif // TUNE_GRID
     fIz++;   // get new z-line
     // get next hit
     fIndYmin += fNy;
@@ -161,6 +181,9 @@ inline bool AliHLTTPCCAHitAreaScalar::GetNext( int& i )
 
   i = fIh; // return
   fIh++; // go to next
+#ifdef TUNE_GRID
+  fNVisitedHits += !yIndexOutOfRange;
+#endif // TUNE_GRID
   return !yIndexOutOfRange;
 }
 
@@ -179,6 +202,9 @@ inline bool AliHLTTPCCAHitAreaScalar::GetNext( NeighbourData *data )
 
   // skip as long as fIh is outside of the interesting bin y-index
   while ( ISLIKELY( needNextZ ) ) {
+#ifdef TUNE_GRID
+    fNVisitedZLines++;
+#endif // TUNE_GRID
     fIz++;   // get new z-line
     // get next hit
     fIndYmin += fNy;
@@ -200,6 +226,9 @@ inline bool AliHLTTPCCAHitAreaScalar::GetNext( NeighbourData *data )
     data->fLinks = indexes;
   }
   fIh++; // go to next
+#ifdef TUNE_GRID
+  fNVisitedHits += !yIndexOutOfRange;
+#endif // TUNE_GRID
   return !yIndexOutOfRange;
 }
 
@@ -0,0 +1,48 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALIHLTTPCCAHITCLAIMS_H
+#define ALIHLTTPCCAHITCLAIMS_H
+
+#include <vector>
+
+/**
+ * Used flags and weights given to the hits by the tracklets of one vector of a parallel wave of the
+ * TrackletConstructor, they are applied to the slice data after the wave, see AliHLTTPCCATracker::SetParallelTrackletVectors.
+ * The tracker keeps one per vector of a wave, so the claims reuse their memory in the next waves and events.
+ */
+struct AliHLTTPCCAHitClaims {
+  struct Claim {
+    int fRow;
+    unsigned int fHit;
+    unsigned int fValue; // isUsed flag or weight
+  };
+  std::vector<Claim> fIsUsed; // in the order they are set
+  std::vector<Claim> fWeights;
+  int fNStored;
+  int fNLaneSteps;
+  int fNActiveLaneSteps;
+};
+
+#endif // ALIHLTTPCCAHITCLAIMS_H
@@ -40,24 +40,35 @@
 using std::cout;
 using std::endl;
 
+AliHLTTPCCAGBHit AliHLTTPCCALooperMerger::Hit( const DataCompressor::SliceRowCluster &iDsrc ) const
+{
+  const AliHLTTPCCAClusterData &data = slices[iDsrc.Slice()]->ClusterData();
+  const int iCl = data.RowOffset( iDsrc.Row() ) + iDsrc.Cluster();
+  AliHLTTPCCAGBHit hit;
+  hit.SetX( data.X( iCl ) );
+  hit.SetY( data.Y( iCl ) );
+  hit.SetZ( data.Z( iCl ) );
+  hit.SetISlice( iDsrc.Slice() );
+  hit.SetIRow( iDsrc.Row() );
+  hit.SetID( data.Id( iCl ) );
+  return hit;
+}
+
 void AliHLTTPCCALooperMerger::FillSegments()
 {
-  int nRecoTracks = fOutput.NTracks();
+  int nRecoTracks = fOutput->NTracks();
   for( int irt = 0; irt < nRecoTracks; irt++ ) {
-      const AliHLTTPCCAMergedTrack &track = fOutput.Track( irt );
+      const AliHLTTPCCAMergedTrack &track = fOutput->Track( irt );
       if( track.Used() ) continue;
     if( fabs( track.InnerParam().QPt() ) < looperQPtCut && fabs( track.OuterParam().QPt() ) < looperQPtCut ) continue;
     int h1(0), h2((track.NClusters()-1)/2), h3(track.NClusters()-1);
     if( track.NClusters() > 7 ) { h1++; h3--; }
-    const DataCompressor::SliceRowCluster &iDsrc1 = fOutput.ClusterIDsrc( track.FirstClusterRef() + h1 );
-    const DataCompressor::SliceRowCluster &iDsrc2 = fOutput.ClusterIDsrc( track.FirstClusterRef() + h2 );
-    const DataCompressor::SliceRowCluster &iDsrc3 = fOutput.ClusterIDsrc( track.FirstClusterRef() + h3 );
-    int iHit1 = fFirstSliceHit[iDsrc1.Slice()] + slices[iDsrc1.Slice()]->ClusterData().RowOffset( iDsrc1.Row() ) + iDsrc1.Cluster();
-    int iHit2 = fFirstSliceHit[iDsrc2.Slice()] + slices[iDsrc2.Slice()]->ClusterData().RowOffset( iDsrc2.Row() ) + iDsrc2.Cluster();
-    int iHit3 = fFirstSliceHit[iDsrc3.Slice()] + slices[iDsrc3.Slice()]->ClusterData().RowOffset( iDsrc3.Row() ) + iDsrc3.Cluster();
-    const AliHLTTPCCAGBHit &hit1r = fGBHits[iHit1];
-    const AliHLTTPCCAGBHit &hit2r = fGBHits[iHit2];
-    const AliHLTTPCCAGBHit &hit3r = fGBHits[iHit3];
+    const DataCompressor::SliceRowCluster &iDsrc1 = fOutput->ClusterIDsrc( track.FirstClusterRef() + h1 );
+    const DataCompressor::SliceRowCluster &iDsrc2 = fOutput->ClusterIDsrc( track.FirstClusterRef() + h2 );
+    const DataCompressor::SliceRowCluster &iDsrc3 = fOutput->ClusterIDsrc( track.FirstClusterRef() + h3 );
+    const AliHLTTPCCAGBHit hit1r = Hit( iDsrc1 );
+    const AliHLTTPCCAGBHit hit2r = Hit( iDsrc2 );
+    const AliHLTTPCCAGBHit hit3r = Hit( iDsrc3 );
 
     float x_seg_1(hit1r.X()), x_seg_2(hit2r.X()), x_seg_3(hit3r.X());
     float y_seg_1(hit1r.Y()), y_seg_2(hit2r.Y()), y_seg_3(hit3r.Y());
@@ -90,7 +101,7 @@ void AliHLTTPCCALooperMerger::FillSegments()
       Cr = sqrt( (x_seg_1_g-Cxg)*(x_seg_1_g-Cxg) + (y_seg_1_g-Cyg)*(y_seg_1_g-Cyg) );
     }
       // Nearest end farthest points of the circle to (0;0)
-    if( fOutput.ClusterIDsrc( track.FirstClusterRef() ).Row() == fOutput.ClusterIDsrc( track.FirstClusterRef()+track.NClusters()-1 ).Row() ) continue;
+    if( fOutput->ClusterIDsrc( track.FirstClusterRef() ).Row() == fOutput->ClusterIDsrc( track.FirstClusterRef()+track.NClusters()-1 ).Row() ) continue;
     float k_cl_g = Cyg / Cxg;
     float b_cl_g = Cyg - k_cl_g*Cxg;
     float d_cl_g = (pow((2*k_cl_g*b_cl_g - 2*Cxg-2*Cyg*k_cl_g),2)-(4+4*k_cl_g*k_cl_g)*(b_cl_g*b_cl_g-Cr*Cr+Cxg*Cxg+Cyg*Cyg-2*Cyg*b_cl_g));
@@ -122,30 +133,30 @@ void AliHLTTPCCALooperMerger::FillSegments()
       z_dn_r = z_seg_1-dz_dn;
       z_up_r = z_seg_3+dz_up;
     }
-    LooperSegment* segment = new LooperSegment;
-    segment->iTr = irt;
-    segment->QPt_abs = fabs( track.InnerParam().QPt() );
-    segment->DzDs_abs = fabs( track.InnerParam().DzDs() );
-    segment->Cx = Cxg;
-    segment->Cy = Cyg;
-    segment->Cr = Cr;
-    segment->x_up = x_up_r_g;
-    segment->y_up = y_up_r_g;
-    segment->z_up = z_up_r;
-    segment->x_dn = x_dn_r_g;
-    segment->y_dn = y_dn_r_g;
-    segment->z_dn = z_dn_r;
-    segment->x_h_up = x_seg_3_g;
-    segment->y_h_up = y_seg_3_g;
-    segment->z_h_up = z_seg_3;
-    segment->x_h_dn = x_seg_1_g;
-    segment->y_h_dn = y_seg_1_g;
-    segment->z_h_dn = z_seg_1;
-    segment->h = h;
-    segment->slice_mid = hit2r.ISlice();
-    segment->iLooper = -1;
-    segment->isUsed = false;
-    fSegments.push_back( *segment );
+    LooperSegment segment;
+    segment.iTr = irt;
+    segment.QPt_abs = fabs( track.InnerParam().QPt() );
+    segment.DzDs_abs = fabs( track.InnerParam().DzDs() );
+    segment.Cx = Cxg;
+    segment.Cy = Cyg;
+    segment.Cr = Cr;
+    segment.x_up = x_up_r_g;
+    segment.y_up = y_up_r_g;
+    segment.z_up = z_up_r;
+    segment.x_dn = x_dn_r_g;
+    segment.y_dn = y_dn_r_g;
+    segment.z_dn = z_dn_r;
+    segment.x_h_up = x_seg_3_g;
+    segment.y_h_up = y_seg_3_g;
+    segment.z_h_up = z_seg_3;
+    segment.x_h_dn = x_seg_1_g;
+    segment.y_h_dn = y_seg_1_g;
+    segment.z_h_dn = z_seg_1;
+    segment.h = h;
+    segment.slice_mid = hit2r.ISlice();
+    segment.iLooper = -1;
+    segment.isUsed = false;
+    fSegments.push_back( segment );
   }
 }
 
@@ -157,7 +168,8 @@ disp.SetTPC( slices[0]->Param() );
 disp.SetTPCView();
 disp.DrawTPC();
 #endif
-  vector<int> loopers;
+  vector<int> &loopers = fLoopers;
+  loopers.clear(); // keeps the capacity
   for( unsigned int iSeg = 0; iSeg < fSegments.size(); iSeg++ ) {
     if( !fSegments[iSeg].isUsed ) {
       fSegments[iSeg].isUsed = true;
@@ -202,16 +214,15 @@ disp.DrawTPC();
     }
   }
 #ifdef DRAW_L
-  int nRecoTracks = fOutput.NTracks();
+  int nRecoTracks = fOutput->NTracks();
   for( int irt = 0; irt < nRecoTracks; irt++ ) {
-    const AliHLTTPCCAMergedTrack &track = fOutput.Track( irt );
+    const AliHLTTPCCAMergedTrack &track = fOutput->Track( irt );
 //        if( track.Used() ) continue;
     if( fabs( track.InnerParam().QPt() ) > 5 || fabs( track.OuterParam().QPt() ) > 5 ) continue;
     float x0, y0, z0;
     for( int ih = 0; ih < track.NClusters(); ih++ ) {
-      const DataCompressor::SliceRowCluster &iDsrc1 = fOutput.ClusterIDsrc( track.FirstClusterRef() + ih );
-      int iHit1 = fFirstSliceHit[iDsrc1.Slice()] + slices[iDsrc1.Slice()]->ClusterData().RowOffset( iDsrc1.Row() ) + iDsrc1.Cluster();
-      const AliHLTTPCCAGBHit &hit1r = fGBHits[iHit1];
+      const DataCompressor::SliceRowCluster &iDsrc1 = fOutput->ClusterIDsrc( track.FirstClusterRef() + ih );
+      const AliHLTTPCCAGBHit hit1r = Hit( iDsrc1 );
       float x_seg_1(hit1r.X());
       float y_seg_1(hit1r.Y());
       float z_seg_1(hit1r.Z());
@@ -231,13 +242,12 @@ disp.DrawTPC();
     if( loopers[i] != 1 ) continue;
     for( int iSeg = 0; iSeg < fSegments.size(); iSeg++ ) {
       if( fSegments[iSeg].iLooper != i ) continue;
-      const AliHLTTPCCAMergedTrack &track = fOutput.Track( fSegments[iSeg].iTr );
+      const AliHLTTPCCAMergedTrack &track = fOutput->Track( fSegments[iSeg].iTr );
       float x0, y0, z0;
       if( track.NClusters() > 65 ) continue;
       for( int ih = 0; ih < track.NClusters(); ih++ ) {
-        const DataCompressor::SliceRowCluster &iDsrc1 = fOutput.ClusterIDsrc( track.FirstClusterRef() + ih );
-        int iHit1 = fFirstSliceHit[iDsrc1.Slice()] + slices[iDsrc1.Slice()]->ClusterData().RowOffset( iDsrc1.Row() ) + iDsrc1.Cluster();
-        const AliHLTTPCCAGBHit &hit1r = fGBHits[iHit1];
+        const DataCompressor::SliceRowCluster &iDsrc1 = fOutput->ClusterIDsrc( track.FirstClusterRef() + ih );
+        const AliHLTTPCCAGBHit hit1r = Hit( iDsrc1 );
         float x_seg_1(hit1r.X());
         float y_seg_1(hit1r.Y());
         float z_seg_1(hit1r.Z());
@@ -262,12 +272,11 @@ disp.DrawTPC();
     int counter = 0;
     for( int iSeg = 0; iSeg < fSegments.size(); iSeg++ ) {
       if( fSegments[iSeg].iLooper != i ) continue;
-      const AliHLTTPCCAMergedTrack &track = fOutput.Track( fSegments[iSeg].iTr );
+      const AliHLTTPCCAMergedTrack &track = fOutput->Track( fSegments[iSeg].iTr );
       float x0, y0, z0;
       for( int ih = 0; ih < track.NClusters(); ih++ ) {
-	const DataCompressor::SliceRowCluster &iDsrc1 = fOutput.ClusterIDsrc( track.FirstClusterRef() + ih );
-	int iHit1 = fFirstSliceHit[iDsrc1.Slice()] + slices[iDsrc1.Slice()]->ClusterData().RowOffset( iDsrc1.Row() ) + iDsrc1.Cluster();
-	const AliHLTTPCCAGBHit &hit1r = fGBHits[iHit1];
+	const DataCompressor::SliceRowCluster &iDsrc1 = fOutput->ClusterIDsrc( track.FirstClusterRef() + ih );
+		const AliHLTTPCCAGBHit hit1r = Hit( iDsrc1 );
 	float x_seg_1(hit1r.X());
 	float y_seg_1(hit1r.Y());
 	float z_seg_1(hit1r.Z());
@@ -349,7 +358,7 @@ void AliHLTTPCCALooperMerger::SaveSegments()
     while( segments[iSeg].iLooper == iLooper && iSeg < fSegments.size() ) {
       int nextTr = -1;
       if( iSeg < fSegments.size()-1 ) if( segments[iSeg+1].iLooper == iLooper ) nextTr = segments[iSeg+1].iTrack;
-      AliHLTTPCCAMergedTrack &track = fOutput.Track( segments[iSeg].iTrack );
+      AliHLTTPCCAMergedTrack &track = fOutput->Track( segments[iSeg].iTrack );
       if( prevTr != nextTr ) {
 	track.SetLooper( prevTr, nextTr );
 	if( segments[iSeg].grow ) track.SetGrow();
@@ -62,10 +62,9 @@ class AliHLTTPCCALooperMerger
   };
  public:
 
-  AliHLTTPCCALooperMerger( AliHLTTPCCAMergerOutput& in_out, AliHLTResizableArray<AliHLTTPCCAGBHit>& hits )
+  AliHLTTPCCALooperMerger()
    : fSliceParam()
-   , fGBHits( hits )
-   , fOutput( in_out )
+   , fOutput( 0 )
    , fNLoopers( 0 )
   {}
 
@@ -75,6 +74,7 @@ class AliHLTTPCCALooperMerger
   }
 
   void SetSliceParam( const AliHLTTPCCAParam &v ) { fSliceParam = v; }
+  void SetOutput( AliHLTTPCCAMergerOutput *out ) { fOutput = out; } // the merged tracks of the event, they get the looper flags
   void SetSlices (int i, AliHLTTPCCATracker *sl )
   {
     //copy sector parameters information
@@ -86,9 +86,11 @@ class AliHLTTPCCALooperMerger
     fkSlices[index] = sliceData;
   }
 
-  void SetFirstSliceHits( int slice, int hit )
+    /// memory of the segments for events with up to maxNTracks merged tracks, it only grows
+  void Reserve( int maxNTracks )
   {
-    fFirstSliceHit[slice] = hit;
+    fSegments.reserve( maxNTracks ); // at most one segment per track
+    fLoopers.reserve( maxNTracks );
   }
 
   void StartLooperTest()
@@ -106,14 +108,15 @@ class AliHLTTPCCALooperMerger
   static const int fgkNSlices = AliHLTTPCCAParameters::NumberOfSlices;       //* N slices
   AliHLTTPCCAParam fSliceParam;           //* slice parameters (geometry, calibr, etc.)
 
-  AliHLTResizableArray<AliHLTTPCCAGBHit>& fGBHits;
-  int fFirstSliceHit[24];
+  /// the hit of the cluster, taken from the cluster data of the slice, which is filled both from Hits() and from SetHitsSoA
+  AliHLTTPCCAGBHit Hit( const DataCompressor::SliceRowCluster &iDsrc ) const;
 
   AliHLTTPCCASliceOutput *fkSlices[fgkNSlices]; //* array of input slice tracks
   AliHLTTPCCATracker *slices[fgkNSlices];
-  AliHLTTPCCAMergerOutput &fOutput;       //* array of output merged tracks
+  AliHLTTPCCAMergerOutput *fOutput;       //* array of output merged tracks
 
-  vector<LooperSegment> fSegments;
+  vector<LooperSegment> fSegments; // kept between events to reuse the memory
+  vector<int> fLoopers; // number of segments of each looper, used by CheckSegments
   int fNLoopers;
 };
 
@@ -60,6 +60,11 @@ using std::endl;
 
 #include "AliHLTTPCCATrackParamVector.h"
 #include "AliHLTTPCCATrackLinearisationVector.h"
+#include "AliHLTTPCCAThreadPool.h"
+
+#ifdef USE_TBB
+#include <tbb/parallel_for.h>
+#endif //USE_TBB
 
 /*struct AliHLTTPCCAMerger::AliHLTTPCCATrackMemory
 {
@@ -92,6 +97,12 @@ AliHLTTPCCAMerger::AliHLTTPCCAMerger()
     , fMaxTrackInfos( 0 )
     , fTrackInfos( 0 )
     , fOutput( 0 )
+    , fThreadPool( 0 )
+    , fBorderPairs()
+    , fArena()
+    , fTmpTrackInfos()
+    , fMergedSegmentsOldIndexes()
+    , fSegmentNumbers()
     , fNMergedSegments( 0 )
     , fNMergedSegmentClusters( 0 )
 #if 0
@@ -124,9 +135,7 @@ const AliHLTTPCCAMerger &AliHLTTPCCAMerger::operator=(const AliHLTTPCCAMerger&)
 
 AliHLTTPCCAMerger::~AliHLTTPCCAMerger()
 {
-  //* destructor
-  if ( fClusterInfos ) delete[] fClusterInfos;
-  if ( fOutput ) delete[] ( ( char* )( fOutput ) );
+  //* destructor, fClusterInfos and fOutput are freed with fArena
 }
 
 void AliHLTTPCCAMerger::Clear()
@@ -134,6 +143,23 @@ void AliHLTTPCCAMerger::Clear()
   for ( int i = 0; i < fgkNSlices; ++i ) {
     fkSlices[i] = 0;
   }
+#ifdef CALC_DCA_ON
+  dca_left.clear(); // keeps the capacity, the AliHLTTPCCAGBTracker copies the vectors
+  dca_right.clear();
+#endif
+}
+
+void AliHLTTPCCAMerger::Reserve( int maxNTracks )
+{
+    // Merging creates fTmpTrackInfos with the merged segments after the slice tracks and swaps it with
+    // fTrackInfos, so both need the memory
+  fTrackInfos.reserve( 2*maxNTracks );
+  fTmpTrackInfos.reserve( 2*maxNTracks );
+  fMergedSegmentsOldIndexes.reserve( maxNTracks );
+#ifdef CALC_DCA_ON
+  dca_left.reserve( maxNTracks );
+  dca_right.reserve( maxNTracks );
+#endif
 }
 
 void AliHLTTPCCAMerger::SetSlices (int i, AliHLTTPCCATracker *sl )
@@ -612,20 +638,19 @@ void AliHLTTPCCAMerger::UnpackSlices()
   }
   // book/clean memory if necessary
   {
+    fArena.Reset(); // memory of the previous event
     {
       fMaxTrackInfos = ( int ) ( nTracksTotal );
       fTrackInfos.resize(fMaxTrackInfos);
     }
 
     {
-      if ( fClusterInfos ) delete[] fClusterInfos;
       fMaxClusterInfos = ( int ) ( nTrackClustersTotal );
-      fClusterInfos = new AliHLTTPCCAClusterInfo [fMaxClusterInfos];
+      fClusterInfos = fArena.Alloc<AliHLTTPCCAClusterInfo>( fMaxClusterInfos );
     }
 
-    if ( fOutput ) delete[] ( ( char* )( fOutput ) );
     int size = fOutput->EstimateSize( nTracksTotal, nTrackClustersTotal );
-    fOutput = ( AliHLTTPCCAMergerOutput* )( new float2[size/sizeof( float2 )+1] );
+    fOutput = ( AliHLTTPCCAMergerOutput* )( fArena.Alloc<float2>( size/sizeof( float2 )+1 ) );
   }
   // unpack track and cluster information
 
@@ -755,8 +780,11 @@ void AliHLTTPCCAMerger::UnpackSlices()
     }
 
 #ifdef DO_TPCCATRACKER_EFF_PERFORMANCE
-    if (slices[iSlice]->fOutTracks1) delete[] slices[iSlice]->fOutTracks1;
-    slices[iSlice]->fOutTracks1 = new AliHLTTPCCAOutTrack [nTracksCurrent-NTracksPrev];
+    if ( slices[iSlice]->fOutTracks1Capacity < nTracksCurrent-NTracksPrev ) { // grows to the maximal event
+      if (slices[iSlice]->fOutTracks1) delete[] slices[iSlice]->fOutTracks1;
+      slices[iSlice]->fOutTracks1 = new AliHLTTPCCAOutTrack [nTracksCurrent-NTracksPrev];
+      slices[iSlice]->fOutTracks1Capacity = nTracksCurrent-NTracksPrev;
+    }
     for (int i=0; i<nTracksCurrent-NTracksPrev; i++)
     {
       slices[iSlice]->fOutTracks1[i].SetStartPoint(fTrackInfos[i+NTracksPrev].InnerParam());
@@ -1307,69 +1335,82 @@ void AliHLTTPCCAMerger::FindMinMaxIndex( int N2, const unsigned int FirstTrIR[],
 }
 
 //#define BACK_ORDER_FOR_0 // little bit faster without it. (but why?)
-void AliHLTTPCCAMerger::MergeBorderTracks( AliHLTTPCCABorderTrack B1[], int N1, unsigned int iSlice1, AliHLTTPCCABorderTrack B2[], int N2, unsigned int iSlice2, int number, const unsigned int FirstTrIR[], const unsigned int LastTrIR[] )
+void AliHLTTPCCAMerger::BorderSearchRange( const AliHLTTPCCABorderPair &p, const AliHLTTPCCABorderTrack &b1,
+                                           int &firstIRow, int &lastIRow, int &dir, int &ifirst2, int &ilast2 )
 {
-// The function creates links to the inner and outer neighbours
-  const float factor2k = 64.f;
-  for ( int i1 = 0; i1 < N1; i1++ ) {
-    AliHLTTPCCABorderTrack &b1 = B1[i1];
+    // Find firts and last row for the nighbours finding. All tracks are sorted by the inner row.
+  lastIRow = fSliceParam.NRows()-1; // row to end finding of a clone
+  firstIRow = 0;
+  dir = -1; // how track2 index is changed from a start to an end row.
+  ifirst2 = -1;
+  ilast2 = p.fN2;
 
-      // Find firts and last row for the nighbours finding. All tracks are sorted by the inner row.
-    int lastIRow = fSliceParam.NRows()-1; // row to end finding of a clone
-    int firstIRow = 0;
-    int dir = -1; // how track2 index is changed from a start to an end row.
-    int ifirst2 = -1;
-    int ilast2 = N2;
+  if(p.fNumber == 1) { // find tracks with <= 1 common rows.
+    dir = -1; // Tracks2 sorted in order of decrease innerRow. For number==1 we'll go in the upper dir, so track indices will decrease
 
-    if(number == 1) { // find tracks with <= 1 common rows.
-      dir = -1; // Tracks2 sorted in order of decrease innerRow. For number==1 we'll go in the upper dir, so track indices will decrease
+    firstIRow = b1.OuterRow() + 0; // row to begin finding of clone
+    lastIRow = b1.OuterRow() + AliHLTTPCCAParameters::MaximumRowGapBetweenClones;
+    lastIRow = (lastIRow < fSliceParam.NRows()) ? lastIRow : fSliceParam.NRows()-1;
 
-      firstIRow = b1.OuterRow() + 0; // row to begin finding of clone
-      lastIRow = b1.OuterRow() + AliHLTTPCCAParameters::MaximumRowGapBetweenClones;
-      lastIRow = (lastIRow < fSliceParam.NRows()) ? lastIRow : fSliceParam.NRows()-1;
-
-      FindMinMaxIndex( N2, FirstTrIR, LastTrIR, firstIRow, lastIRow, ifirst2, ilast2 );
-    }
-    else if(number == 0) { // find tracks with >= 2 common rows.
+    FindMinMaxIndex( p.fN2, p.fFirstTrIR, p.fLastTrIR, firstIRow, lastIRow, ifirst2, ilast2 );
+  }
+  else if(p.fNumber == 0) { // find tracks with >= 2 common rows.
 #ifdef BACK_ORDER_FOR_0
-      dir = 1; // Tracks2 sorted in order of decrease innerRow. For number==0 we'll go in the down dir, so indices will increase
+    dir = 1; // Tracks2 sorted in order of decrease innerRow. For number==0 we'll go in the down dir, so indices will increase
 
-      firstIRow = b1.OuterRow() - 1; // row to begin finding of a clone
-      lastIRow = b1.OuterRow() - AliHLTTPCCAParameters::MaximumRowGapBetweenOverlapingClones;
-      if ( firstIRow < 0 ) {
-        firstIRow = 0;
-        lastIRow = 0;
-      }
-      else if ( lastIRow < 0 ){
-        lastIRow = 0;
-      }
+    firstIRow = b1.OuterRow() - 1; // row to begin finding of a clone
+    lastIRow = b1.OuterRow() - AliHLTTPCCAParameters::MaximumRowGapBetweenOverlapingClones;
+    if ( firstIRow < 0 ) {
+      firstIRow = 0;
+      lastIRow = 0;
+    }
+    else if ( lastIRow < 0 ){
+      lastIRow = 0;
+    }
 
-      FindMinMaxIndex( N2, FirstTrIR, LastTrIR, lastIRow, firstIRow, ilast2, ifirst2 );
+    FindMinMaxIndex( p.fN2, p.fFirstTrIR, p.fLastTrIR, lastIRow, firstIRow, ilast2, ifirst2 );
 #else // BACK_ORDER_FOR_0
-      dir = -1;
+    dir = -1;
 
-      firstIRow = b1.OuterRow() - AliHLTTPCCAParameters::MaximumRowGapBetweenOverlapingClones; // row to begin finding of a clone
-      lastIRow = b1.OuterRow() - 1;
-      if ( lastIRow < 0 ) {
-        firstIRow = 0;
-        lastIRow = 0;
-      }
-      else if ( firstIRow < 0 ){
-        firstIRow = 0;
-      }
+    firstIRow = b1.OuterRow() - AliHLTTPCCAParameters::MaximumRowGapBetweenOverlapingClones; // row to begin finding of a clone
+    lastIRow = b1.OuterRow() - 1;
+    if ( lastIRow < 0 ) {
+      firstIRow = 0;
+      lastIRow = 0;
+    }
+    else if ( firstIRow < 0 ){
+      firstIRow = 0;
+    }
 
-      FindMinMaxIndex( N2, FirstTrIR, LastTrIR, firstIRow, lastIRow, ifirst2, ilast2 );
+    FindMinMaxIndex( p.fN2, p.fFirstTrIR, p.fLastTrIR, firstIRow, lastIRow, ifirst2, ilast2 );
 #endif // BACK_ORDER_FOR_0
-    }
+  }
+}
+
+void AliHLTTPCCAMerger::FindBorderCandidates( AliHLTTPCCABorderPair &p )
+{
+// The function checks all pairs of tracks, which could be neighbours. Only the track parameters are used,
+// so the slice pairs can be processed in parallel. The links are set afterwards by LinkBorderTracks.
+  const float factor2k = 64.f;
+  const float kNoCut = 1e30f; // the cut on the chi2 of the best neighbour is applied by LinkBorderTracks
+  const int number = p.fNumber;
+  const unsigned int iSlice1 = p.fSlice1, iSlice2 = p.fSlice2;
+  const AliHLTTPCCABorderTrack * const B2 = p.fB2;
+
+  p.fCandidates.clear();
+  p.fFirstCandidate.resize( p.fN1 + 1 );
+  for ( int i1 = 0; i1 < p.fN1; i1++ ) {
+    p.fFirstCandidate[i1] = p.fCandidates.size();
+    const AliHLTTPCCABorderTrack &b1 = p.fB1[i1];
+
+    int firstIRow, lastIRow, dir, ifirst2, ilast2;
+    BorderSearchRange( p, b1, firstIRow, lastIRow, dir, ifirst2, ilast2 );
 
     if (dir*ifirst2 > dir*ilast2) continue;
 
       // rarely changed parameters
     const AliHLTTPCCASliceTrackInfo *Tt1 = &fTrackInfos[fSliceTrackInfoStart[iSlice1] + b1.TrackID() ];
 
-    int bestI2 = -1; // index of second tracksegment, which corresponds to minMinLv and bestChi2
-    float bestChi2( std::max( Tt1->ChiNext, Tt1->ChiPrev ) );
-    bool bestIsNext(1e10f);
     float_v minL2v(1e10f);
 
     float Tt2OuterAlpha=0;
@@ -1430,10 +1471,6 @@ void AliHLTTPCCAMerger::MergeBorderTracks( AliHLTTPCCABorderTrack B1[], int N1,
 
         const AliHLTTPCCASliceTrackInfo *Tt2 = &fTrackInfos[ fSliceTrackInfoStart[iSlice2] + b2.TrackID() ];
 
-        if( (Tt1->NextNeighbour() == b2.TrackID() && Tt1->SliceNextNeighbour() == iSlice2) ||
-            (Tt1->PrevNeighbour() == b2.TrackID() && Tt1->SlicePrevNeighbour() == iSlice2) )
-          continue;  // the tracks are already matched
-
         if ( number == 0 ) { // reconstruct only parallel tracks, created because of clusters spliting
           const float &z1I = Tt1->InnerParam().Z();
           const float &z1O = Tt1->OuterParam().Z();
@@ -1534,15 +1571,70 @@ void AliHLTTPCCAMerger::MergeBorderTracks( AliHLTTPCCABorderTrack B1[], int N1,
       InParT1, OutParT1, InAlphaT1, OutAlphaT1,
       InParT2, OutParT2, InAlphaT2, OutAlphaT2,
       dxArr, dyArr, sinS1_E2v, sinS2_E1v,
-      minL2v, bestChi2, min_chi2, active );
+      minL2v, kNoCut, min_chi2, active );
+
+        // store all the checked tracks, since they take place in the vectors of LinkBorderTracks
+      for(int iV=0; iV < nVecElements; iV++) {
+        AliHLTTPCCABorderCandidate c;
+        c.fI2 = b2index[iV];
+        c.fActive = active[iV];
+        c.fChi2 = min_chi2[iV];
+        c.fL2 = minL2v[iV];
+        p.fCandidates.push_back( c );
+      }
+    } // for i2
+  } // for i1
+  p.fFirstCandidate[p.fN1] = p.fCandidates.size();
+}
 
-      if(active.isEmpty()) continue;
+void AliHLTTPCCAMerger::LinkBorderTracks( const AliHLTTPCCABorderPair &p )
+{
+// The function creates links to the inner and outer neighbours using the candidates found by FindBorderCandidates.
+// The tracks are checked in the same order and in the same groups of uint_v::Size as they are checked by the vectorized search,
+// so the links depend only on the order of the slice pairs.
+  const int number = p.fNumber;
+  const unsigned int iSlice1 = p.fSlice1, iSlice2 = p.fSlice2;
+  const AliHLTTPCCABorderTrack * const B2 = p.fB2;
+  const unsigned int * const FirstTrIR = p.fFirstTrIR;
+#ifdef BACK_ORDER_FOR_0
+  const unsigned int * const LastTrIR = p.fLastTrIR;
+#endif
 
-      for(int iV=0; iV < nVecElements; iV++) { // foreach_bit( int iV, active )  is slower since mostly nVecElements < 4
-        if(!active[iV]) continue;
+  for ( int i1 = 0; i1 < p.fN1; i1++ ) {
+    const AliHLTTPCCABorderTrack &b1 = p.fB1[i1];
+
+    int firstIRow, lastIRow, dir, ifirst2, ilast2;
+    BorderSearchRange( p, b1, firstIRow, lastIRow, dir, ifirst2, ilast2 );
+
+    if (dir*ifirst2 > dir*ilast2) continue;
+
+    const AliHLTTPCCASliceTrackInfo *Tt1 = &fTrackInfos[fSliceTrackInfoStart[iSlice1] + b1.TrackID() ];
+
+    int bestI2 = -1; // index of second tracksegment, which corresponds to minMinLv and bestChi2
+    float bestChi2( std::max( Tt1->ChiNext, Tt1->ChiPrev ) );
+    bool bestIsNext(1e10f);
+
+    int iC = p.fFirstCandidate[i1];
+    const int iCEnd = p.fFirstCandidate[i1+1];
+    while ( 1 ) {
+      int nVecElements = 0;
+      int iCV[uint_v::Size];
+      for( ; nVecElements < int(uint_v::Size) && iC < iCEnd && dir*p.fCandidates[iC].fI2 <= dir*ilast2; iC++ ) {
+        const AliHLTTPCCABorderTrack &b2 = B2[p.fCandidates[iC].fI2];
+        if( (Tt1->NextNeighbour() == b2.TrackID() && Tt1->SliceNextNeighbour() == iSlice2) ||
+            (Tt1->PrevNeighbour() == b2.TrackID() && Tt1->SlicePrevNeighbour() == iSlice2) )
+          continue;  // the tracks are already matched
+        iCV[nVecElements++] = iC;
+      }
+      if (nVecElements == 0) break;
+
+      const float bestChi2V = bestChi2; // the cut used for the whole vector
+      for(int iV=0; iV < nVecElements; iV++) {
+        const AliHLTTPCCABorderCandidate &c = p.fCandidates[iCV[iV]];
+        if( !c.fActive || !( ( number == 1 ? c.fL2 : c.fChi2 ) < bestChi2V ) ) continue;
           // determine, whether neighbour is inner or outer
 
-        const AliHLTTPCCABorderTrack &b2iV = B2[(unsigned int)b2index[iV]];
+        const AliHLTTPCCABorderTrack &b2iV = B2[c.fI2];
 
         if( ISUNLIKELY( b1.InnerRow() <= b2iV.InnerRow()+1 && b1.OuterRow() >= b2iV.OuterRow()-1 ) ) continue;
         if( ISUNLIKELY( b2iV.InnerRow() <= b1.InnerRow()+1 && b2iV.OuterRow() >= b1.OuterRow()-1 ) ) continue;
@@ -1555,7 +1647,7 @@ void AliHLTTPCCAMerger::MergeBorderTracks( AliHLTTPCCABorderTrack B1[], int N1,
             b1.OuterRow() == b2iV.OuterRow() &&
             b1.TrackID() < b2iV.TrackID()       );
 
-        AliHLTTPCCASliceTrackInfo *T1, *T2;
+        const AliHLTTPCCASliceTrackInfo *T1, *T2;
         if(IsNext) {
           T1 = &fTrackInfos[fSliceTrackInfoStart[iSlice1] + b1.TrackID() ];
           T2 = &fTrackInfos[fSliceTrackInfoStart[iSlice2] + b2iV.TrackID() ];
@@ -1566,13 +1658,13 @@ void AliHLTTPCCAMerger::MergeBorderTracks( AliHLTTPCCABorderTrack B1[], int N1,
         }
 
           // if current neighbour is better than previus one - save it
-        if(T1->ChiNext > min_chi2[iV] && T2->ChiPrev > min_chi2[iV]) // clone was found
+        if(T1->ChiNext > c.fChi2 && T2->ChiPrev > c.fChi2) // clone was found
         {
             // reestimate end row and index
           if (number == 1) {
               // find end row
             const float x0 = fSliceParam.RowX(b1.OuterRow());
-            for (; fSliceParam.RowX(lastIRow) - x0 > sqrt(minL2v[iV]); lastIRow--);
+            for (; fSliceParam.RowX(lastIRow) - x0 > sqrt(c.fL2); lastIRow--);
               // find end index
             for(; lastIRow >= firstIRow; lastIRow--)
               if(FirstTrIR[lastIRow] != 50000) {
@@ -1584,7 +1676,7 @@ void AliHLTTPCCAMerger::MergeBorderTracks( AliHLTTPCCABorderTrack B1[], int N1,
           else if (number == 0) {
               // find end row
             const float x0 = fSliceParam.RowX(b1.OuterRow());
-            for (; x0 - fSliceParam.RowX(lastIRow) > sqrt(minL2v[iV]); lastIRow++);
+            for (; x0 - fSliceParam.RowX(lastIRow) > sqrt(c.fL2); lastIRow++);
               // find end index
             for(; lastIRow <= firstIRow; lastIRow++)
               if(LastTrIR[lastIRow] != 50000) {
@@ -1594,12 +1686,12 @@ void AliHLTTPCCAMerger::MergeBorderTracks( AliHLTTPCCABorderTrack B1[], int N1,
           }
 #endif
 
-          bestI2 = b2index[iV];
-          bestChi2 = min_chi2[iV];
+          bestI2 = c.fI2;
+          bestChi2 = c.fChi2;
           bestIsNext = IsNext;
         }
       } // for iV
-    } // for i2
+    } // while
 
     if (bestI2 >= 0) {
       const AliHLTTPCCABorderTrack &b2iV = B2[bestI2];
@@ -1653,6 +1745,92 @@ void AliHLTTPCCAMerger::MergeBorderTracks( AliHLTTPCCABorderTrack B1[], int N1,
   } // for i1
 }
 
+  /// Makes the border tracks of one slice, sorts them by the inner row and finds the track range of each row
+class AliHLTTPCCAMerger::MakeBorderTracksTask
+{
+  public:
+    MakeBorderTracksTask( AliHLTTPCCAMerger &merger, AliHLTTPCCABorderTrack *bCurrIR, AliHLTTPCCABorderTrack *bCurrOR, int maxNSliceTracks,
+                          unsigned int *nCurr, unsigned int (*FirstTrIR)[AliHLTTPCCAParameters::MaxNumberOfRows8],
+                          unsigned int (*LastTrIR)[AliHLTTPCCAParameters::MaxNumberOfRows8] )
+        : fMerger( merger ), fCurrIR( bCurrIR ), fCurrOR( bCurrOR ), fMaxNSliceTracks( maxNSliceTracks ),
+        fNCurr( nCurr ), fFirstTrIR( FirstTrIR ), fLastTrIR( LastTrIR ) {}
+
+    void operator()( int i ) const {
+      unsigned char iSl = i;
+      fNCurr[iSl] = 0;
+        // make border tracks for each sector, sort them by inner row
+      AliHLTTPCCABorderTrack * const bCurrSliceIR = fCurrIR + fMaxNSliceTracks*iSl;
+      AliHLTTPCCABorderTrack * const bCurrSliceOR = fCurrOR + fMaxNSliceTracks*iSl;
+      fMerger.MakeBorderTracks(bCurrSliceIR, fNCurr[iSl], iSl);
+      std::sort(bCurrSliceIR, bCurrSliceIR + fNCurr[iSl], CompareInnerRow); // sort such that innerRow decrease
+
+      for(unsigned int itr=0; itr < fNCurr[iSl]; itr++)
+        bCurrSliceOR[itr] = bCurrSliceIR[itr];
+
+        // save track indices range for each row
+      if(fNCurr[iSl] > 0)
+      {
+        unsigned char curRow = bCurrSliceIR[0].InnerRow();
+        fFirstTrIR[iSl][curRow] = 0;
+        for(unsigned int itr = 1; itr < fNCurr[iSl]; itr++)
+        {
+          if( bCurrSliceIR[itr].InnerRow() < curRow )
+          {
+            fLastTrIR[iSl][curRow] = itr - 1;
+            curRow = bCurrSliceIR[itr].InnerRow();
+            fFirstTrIR[iSl][curRow] = itr;
+          }
+        }
+        fLastTrIR[iSl][curRow] = fNCurr[iSl] - 1;
+      }
+    }
+
+  private:
+    AliHLTTPCCAMerger &fMerger;
+    AliHLTTPCCABorderTrack *fCurrIR;
+    AliHLTTPCCABorderTrack *fCurrOR;
+    int fMaxNSliceTracks;
+    unsigned int *fNCurr;
+    unsigned int (*fFirstTrIR)[AliHLTTPCCAParameters::MaxNumberOfRows8];
+    unsigned int (*fLastTrIR)[AliHLTTPCCAParameters::MaxNumberOfRows8];
+};
+
+class AliHLTTPCCAMerger::FindBorderCandidatesTask
+{
+  public:
+    FindBorderCandidatesTask( AliHLTTPCCAMerger &merger ): fMerger( merger ) {}
+    void operator()( int iPair ) const { fMerger.FindBorderCandidates( fMerger.fBorderPairs[iPair] ); }
+  private:
+    AliHLTTPCCAMerger &fMerger;
+};
+
+void AliHLTTPCCAMerger::AddBorderPair( int &nPairs, AliHLTTPCCABorderTrack *B1, int N1, unsigned int iSlice1,
+                                       AliHLTTPCCABorderTrack *B2, int N2, unsigned int iSlice2, int number,
+                                       const unsigned int FirstTrIR[], const unsigned int LastTrIR[] )
+{
+  if ( nPairs >= static_cast<int>( fBorderPairs.size() ) ) fBorderPairs.resize( nPairs + 1 );
+  AliHLTTPCCABorderPair &p = fBorderPairs[nPairs++];
+  p.fB1 = B1;
+  p.fN1 = N1;
+  p.fSlice1 = iSlice1;
+  p.fB2 = B2;
+  p.fN2 = N2;
+  p.fSlice2 = iSlice2;
+  p.fNumber = number;
+  p.fFirstTrIR = FirstTrIR;
+  p.fLastTrIR = LastTrIR;
+}
+
+void AliHLTTPCCAMerger::ParallelFor( int n, const std::function<void( int )> &task )
+{
+#ifdef USE_TBB
+  tbb::parallel_for( 0, n, task );
+#else
+  if ( fThreadPool ) fThreadPool->ParallelFor( n, task );
+  else for ( int i = 0; i < n; i++ ) task( i );
+#endif // USE_TBB
+}
+
 void AliHLTTPCCAMerger::FindNeighbourTracks(int number)
 {
 #ifdef USE_TIMERS
@@ -1690,8 +1868,8 @@ void AliHLTTPCCAMerger::FindNeighbourTracks(int number)
     if ( maxNSliceTracks < fSliceNTrackInfos[iSlice] ) maxNSliceTracks = fSliceNTrackInfos[iSlice];
   }
 
-  AliHLTTPCCABorderTrack *bCurrIR = new AliHLTTPCCABorderTrack[maxNSliceTracks*fgkNSlices];
-  AliHLTTPCCABorderTrack *bCurrOR = new AliHLTTPCCABorderTrack[maxNSliceTracks*fgkNSlices];
+  AliHLTTPCCABorderTrack *bCurrIR = fArena.Alloc<AliHLTTPCCABorderTrack>( maxNSliceTracks*fgkNSlices );
+  AliHLTTPCCABorderTrack *bCurrOR = fArena.Alloc<AliHLTTPCCABorderTrack>( maxNSliceTracks*fgkNSlices );
   unsigned int FirstTrIR[fgkNSlices][AliHLTTPCCAParameters::MaxNumberOfRows8]; // index of the first track on row
   unsigned int LastTrIR[fgkNSlices][AliHLTTPCCAParameters::MaxNumberOfRows8];
 
@@ -1700,41 +1878,16 @@ void AliHLTTPCCAMerger::FindNeighbourTracks(int number)
   std::fill(&(LastTrIR[0][0]),  &(LastTrIR[0][0])  + fgkNSlices*AliHLTTPCCAParameters::MaxNumberOfRows8, 50000);
 
   unsigned int nCurr[fgkNSlices];
-  for(unsigned char iSl=0; iSl<fgkNSlices; iSl++)
-  {
+  ParallelFor( fgkNSlices, MakeBorderTracksTask( *this, bCurrIR, bCurrOR, maxNSliceTracks, nCurr, FirstTrIR, LastTrIR ) );
 
-    nCurr[iSl] = 0;
-      // make border tracks for each sector, sort them by inner row
-    AliHLTTPCCABorderTrack * const bCurrSliceIR = bCurrIR + maxNSliceTracks*iSl;
-    AliHLTTPCCABorderTrack * const bCurrSliceOR = bCurrOR + maxNSliceTracks*iSl;
-    MakeBorderTracks(bCurrSliceIR, nCurr[iSl], iSl);
-    std::sort(bCurrSliceIR, bCurrSliceIR + nCurr[iSl], CompareInnerRow); // sort such that innerRow decrease
-
-    for(unsigned int itr=0; itr < nCurr[iSl]; itr++)
-      bCurrSliceOR[itr] = bCurrSliceIR[itr];
-
-      // save track indices range for each row
-    if(nCurr[iSl] > 0)
-    {
-      unsigned char curRow = bCurrSliceIR[0].InnerRow();
-      FirstTrIR[iSl][curRow] = 0;
-      for(unsigned int itr = 1; itr < nCurr[iSl]; itr++)
-      {
-        if( bCurrSliceIR[itr].InnerRow() < curRow )
-        {
-            // for (int iR = bCurrIR[maxNSliceTracks*iSl+itr].InnerRow() + 1; iR < curRow; iR++) // check for a jump
-            //   FirstTrIR[iSl][iR] = FirstTrIR[iSl][curRow];
-          LastTrIR[iSl][curRow] = itr - 1;
-          curRow = bCurrSliceIR[itr].InnerRow();
-          FirstTrIR[iSl][curRow] = itr;
-        }
-      }
-      LastTrIR[iSl][curRow] = nCurr[iSl] - 1;
-    }
+    // list the pairs of slices in the order their links are created
+  int nPairs = 0;
+  for(int iSl=0; iSl<fgkNSlices; iSl++)
+  {
       // create links to neighbour tracks clones in the same sector
-    MergeBorderTracks( bCurrSliceOR, nCurr[iSl], iSl,
-                       bCurrSliceIR, nCurr[iSl], iSl,
-                       number, FirstTrIR[iSl], LastTrIR[iSl] );
+    AddBorderPair( nPairs, bCurrOR+maxNSliceTracks*iSl, nCurr[iSl], iSl,
+                           bCurrIR+maxNSliceTracks*iSl, nCurr[iSl], iSl,
+                           number, FirstTrIR[iSl], LastTrIR[iSl] );
   }
 
   if (number == 1) { // with number == 0 only parallel tracks are merged, they should be at the same sector
@@ -1742,12 +1895,12 @@ void AliHLTTPCCAMerger::FindNeighbourTracks(int number)
     for(int iSl=0; iSl<fgkNSlices; iSl++)
     {
         //  create links to neighbour tracks in the next sector in the same xy-plane
-      MergeBorderTracks( bCurrOR+maxNSliceTracks*iSl,            nCurr[iSl],            iSl,
-                         bCurrIR+maxNSliceTracks*nextSlice[iSl], nCurr[nextSlice[iSl]], nextSlice[iSl],
-                         number, FirstTrIR[nextSlice[iSl]], LastTrIR[nextSlice[iSl]] ); // merge upper edges
-      MergeBorderTracks( bCurrOR+maxNSliceTracks*nextSlice[iSl], nCurr[nextSlice[iSl]], nextSlice[iSl],
-                         bCurrIR+maxNSliceTracks*iSl,            nCurr[iSl],            iSl,
-                         number, FirstTrIR[iSl],            LastTrIR[iSl] );            // merge lower edges
+      AddBorderPair( nPairs, bCurrOR+maxNSliceTracks*iSl,            nCurr[iSl],            iSl,
+                             bCurrIR+maxNSliceTracks*nextSlice[iSl], nCurr[nextSlice[iSl]], nextSlice[iSl],
+                             number, FirstTrIR[nextSlice[iSl]], LastTrIR[nextSlice[iSl]] ); // merge upper edges
+      AddBorderPair( nPairs, bCurrOR+maxNSliceTracks*nextSlice[iSl], nCurr[nextSlice[iSl]], nextSlice[iSl],
+                             bCurrIR+maxNSliceTracks*iSl,            nCurr[iSl],            iSl,
+                             number, FirstTrIR[iSl],            LastTrIR[iSl] );            // merge lower edges
 
       if(iSl < fgkNSlices / 2)
       {
@@ -1756,20 +1909,20 @@ void AliHLTTPCCAMerger::FindNeighbourTracks(int number)
         for( int ii = -1; ii < 2; ii++ ) {
           //  create links to neighbour tracks with the oposit sector (in z direction)
           if( oppSlice[iSl] + ii >= 0 && oppSlice[iSl] + ii < 24 ) {
-            MergeBorderTracks( bCurrOR+maxNSliceTracks*iSl, nCurr[iSl], iSl,
+            AddBorderPair( nPairs, bCurrOR+maxNSliceTracks*iSl, nCurr[iSl], iSl,
                            bCurrIR+maxNSliceTracks*(oppSlice[iSl]+ii), nCurr[oppSlice[iSl]+ii], oppSlice[iSl]+ii,
                            number, FirstTrIR[oppSlice[iSl]+ii], LastTrIR[oppSlice[iSl]+ii] );
-            MergeBorderTracks( bCurrOR+maxNSliceTracks*(oppSlice[iSl]+ii), nCurr[oppSlice[iSl]+ii], oppSlice[iSl]+ii,
+            AddBorderPair( nPairs, bCurrOR+maxNSliceTracks*(oppSlice[iSl]+ii), nCurr[oppSlice[iSl]+ii], oppSlice[iSl]+ii,
                            bCurrIR+maxNSliceTracks*iSl, nCurr[iSl], iSl,
                            number, FirstTrIR[iSl],           LastTrIR[iSl] );
           }
         }
 #else
           //  create links to neighbour tracks with the oposit sector (in z direction)
-        MergeBorderTracks( bCurrOR+maxNSliceTracks*iSl, nCurr[iSl], iSl,
+        AddBorderPair( nPairs, bCurrOR+maxNSliceTracks*iSl, nCurr[iSl], iSl,
                            bCurrIR+maxNSliceTracks*(oppSlice[iSl]), nCurr[oppSlice[iSl]], oppSlice[iSl],
                            number, FirstTrIR[oppSlice[iSl]], LastTrIR[oppSlice[iSl]] );
-        MergeBorderTracks( bCurrOR+maxNSliceTracks*(oppSlice[iSl]), nCurr[oppSlice[iSl]], oppSlice[iSl],
+        AddBorderPair( nPairs, bCurrOR+maxNSliceTracks*(oppSlice[iSl]), nCurr[oppSlice[iSl]], oppSlice[iSl],
                            bCurrIR+maxNSliceTracks*iSl, nCurr[iSl], iSl,
                            number, FirstTrIR[iSl],           LastTrIR[iSl] );
 #endif
@@ -1778,8 +1931,10 @@ void AliHLTTPCCAMerger::FindNeighbourTracks(int number)
   }
   }
 
-  if ( bCurrIR ) delete[] bCurrIR;
-  if ( bCurrOR ) delete[] bCurrOR;
+    // the expensive search of the candidates runs in parallel, the links are set in the fixed order of the pairs
+  ParallelFor( nPairs, FindBorderCandidatesTask( *this ) );
+  for ( int iPair = 0; iPair < nPairs; iPair++ )
+    LinkBorderTracks( fBorderPairs[iPair] );
 
 #ifdef USE_TIMERS
   timer.Stop();
@@ -2554,13 +2709,14 @@ void AliHLTTPCCAMerger::Merging(int number)
 
   if(number == 0)
   {
-    outTracks = new AliHLTTPCCAMergedTrack[fMaxTrackInfos + fNMergedSegments];
-    outClusterIDsrc = new DataCompressor::SliceRowCluster[fMaxClusterInfos + fNMergedSegmentClusters];
-    outClusterPackedAmp = new UChar_t [fMaxClusterInfos + fNMergedSegmentClusters];
+    outTracks = fArena.Alloc<AliHLTTPCCAMergedTrack>( fMaxTrackInfos + fNMergedSegments );
+    outClusterIDsrc = fArena.Alloc<DataCompressor::SliceRowCluster>( fMaxClusterInfos + fNMergedSegmentClusters );
+    outClusterPackedAmp = fArena.Alloc<UChar_t>( fMaxClusterInfos + fNMergedSegmentClusters );
   }
 
-  AliHLTTPCCAClusterInfo *tmpH = new AliHLTTPCCAClusterInfo[fMaxClusterInfos + fNMergedSegmentClusters];
-  Vc::vector<AliHLTTPCCASliceTrackInfo> tmpT(fMaxTrackInfos + fNMergedSegments);
+  AliHLTTPCCAClusterInfo *tmpH = fArena.Alloc<AliHLTTPCCAClusterInfo>( fMaxClusterInfos + fNMergedSegmentClusters );
+  Vc::vector<AliHLTTPCCASliceTrackInfo> &tmpT = fTmpTrackInfos; // swapped with fTrackInfos at the end
+  tmpT.assign( fMaxTrackInfos + fNMergedSegments, AliHLTTPCCASliceTrackInfo() );
   int nEndTracks = 0; // n tracks after merging.
   int tmpSliceTrackInfoStart[fgkNSlices];
 
@@ -2569,8 +2725,11 @@ void AliHLTTPCCAMerger::Merging(int number)
   int nH = 0;
 
 #ifdef MERGEFIX
-  int oldToNewTrackIndexes[fMaxTrackInfos + fNMergedSegments*2];
-  vector<int> mergedSermentsOldIndexes;
+  int *oldToNewTrackIndexes = fArena.Alloc<int>( fMaxTrackInfos + fNMergedSegments*2 );
+  vector<int> &mergedSermentsOldIndexes = fMergedSegmentsOldIndexes;
+  mergedSermentsOldIndexes.clear();
+  int_v segmentCounter( 0 );
+  vector<int_v> &segmentNumbers = fSegmentNumbers;
 #endif
 
 // merge tracks, using obtained links to neighbours
@@ -2589,7 +2748,7 @@ void AliHLTTPCCAMerger::Merging(int number)
 
 
      // -- Resort tracks to proceed faster
-    vector<unsigned int> firstInChainIndex(fSliceNTrackInfos[iSlice]);
+    unsigned int *firstInChainIndex = fArena.Alloc<unsigned int>( fSliceNTrackInfos[iSlice] );
     int nChains = 0;
       // store tracks, which are not merged. And save indexes of the most previous(inner) merged tracks
     for(int iT=0; iT< fSliceNTrackInfos[iSlice]; iT++) {
@@ -2697,11 +2856,6 @@ void AliHLTTPCCAMerger::Merging(int number)
       nEndTracks++;
     } // if no merged
 
-#ifdef MERGEFIX
-    int_v segmentCounter( 0 );
-    vector<int_v> segmentNumbers;
-#endif
-
     for ( int itr = 0; ; ) {
 #ifdef MERGEFIX
 	segmentCounter = int_v( 0 );
@@ -2945,10 +3099,9 @@ void AliHLTTPCCAMerger::Merging(int number)
   }
 #endif
 
-  if (fClusterInfos) delete[] fClusterInfos;
-  fClusterInfos = tmpH;
+  fClusterInfos = tmpH; // the old one stays in fArena till the next event
 
-  fTrackInfos = tmpT;
+  fTrackInfos.swap( tmpT );
   for(int iSlice=0; iSlice < fgkNSlices; iSlice++ )
   {
     fSliceNTrackInfos[iSlice] = nTrNew[iSlice];
@@ -2957,9 +3110,8 @@ void AliHLTTPCCAMerger::Merging(int number)
 
   if(number == 0)
   {
-    if ( fOutput ) delete[] ( ( char* )( fOutput ) );
     int size = fOutput->EstimateSize( nOutTracks, nOutTrackClusters );
-    fOutput = ( AliHLTTPCCAMergerOutput* )( new float2[size/sizeof( float2 )+1] );
+    fOutput = ( AliHLTTPCCAMergerOutput* )( fArena.Alloc<float2>( size/sizeof( float2 )+1 ) );
 
     fOutput->SetNTracks( nOutTracks );
     fOutput->SetNTrackClusters( nOutTrackClusters );
@@ -2971,10 +3123,6 @@ void AliHLTTPCCAMerger::Merging(int number)
       fOutput->SetClusterIDsrc( ic, outClusterIDsrc[ic] );
       fOutput->SetClusterPackedAmp( ic, outClusterPackedAmp[ic] );
     }
-
-    if (outTracks) delete[] outTracks;
-    if (outClusterIDsrc) delete[] outClusterIDsrc;
-    if (outClusterPackedAmp) delete[] outClusterPackedAmp;
   }
 
 #ifdef USE_TIMERS
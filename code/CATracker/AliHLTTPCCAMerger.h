@@ -32,9 +32,11 @@
 #include "AliHLTTPCCASliceTrackVector.h"
 
 #include "AliHLTTPCCATrackParamVector.h"
+#include "AliHLTTPCCAArena.h"
 
 #include <vector>
 #include <map>
+#include <functional>
 
 #if !defined(HLTCA_GPUCODE)
 #include <iostream>
@@ -48,6 +50,7 @@ class AliHLTTPCCASliceOutput;
 class AliHLTTPCCAMergedTrack;
 class AliHLTTPCCAMergerOutput;
 class AliHLTTPCCATracker;
+class AliHLTTPCCAThreadPool;
 
 /**
  * @class AliHLTTPCCAMerger
@@ -88,6 +91,34 @@ class AliHLTTPCCAMerger
     unsigned int fOuterRow;
   };
 
+    /// Track of B2, which was checked to be a neighbour of a track of B1
+  struct AliHLTTPCCABorderCandidate
+  {
+    int fI2;       // index in B2
+    float fChi2;   // chi2 of the match
+    float fL2;     // squared distance between the tracks
+    bool fActive;  // passed all cuts, except the cut on the chi2 of the current best neighbour
+  };
+
+    /// Two sets of border tracks, which are checked for neighbours by FindNeighbourTracks
+  struct AliHLTTPCCABorderPair
+  {
+    AliHLTTPCCABorderTrack *fB1;
+    int fN1;
+    unsigned int fSlice1;
+    AliHLTTPCCABorderTrack *fB2;
+    int fN2;
+    unsigned int fSlice2;
+    int fNumber;
+    const unsigned int *fFirstTrIR;
+    const unsigned int *fLastTrIR;
+    std::vector<AliHLTTPCCABorderCandidate> fCandidates; // candidates of all B1 tracks
+    std::vector<int> fFirstCandidate;                    // first candidate of each B1 track, fN1+1 entries
+  };
+
+  class MakeBorderTracksTask;
+  class FindBorderCandidatesTask;
+
  public:
   class AliHLTTPCCASliceTrackInfo;
   class AliHLTTPCCASliceTrackInfoV;
@@ -103,6 +134,8 @@ class AliHLTTPCCAMerger
   const AliHLTTPCCAMerger &operator=( const AliHLTTPCCAMerger& ) const;
 
   void Clear();
+    /// memory of the track infos for events with up to maxNTracks slice tracks, it only grows
+  void Reserve( int maxNTracks );
 
     // accsessors
   void SetSliceParam( const AliHLTTPCCAParam &v ) { fSliceParam = v; }
@@ -110,10 +143,15 @@ class AliHLTTPCCAMerger
   void SetSliceData( int index, AliHLTTPCCASliceOutput *SliceData );
   void SetSlices ( int i, AliHLTTPCCATracker *sl );
   static void SetDoNotMergeBorders(int i = 0) {fgDoNotMergeBorders = i;}
+    /// Threads for the neighbours search, the pool is not owned. Without a pool the search is serial.
+  void SetThreadPool( AliHLTTPCCAThreadPool *pool ) { fThreadPool = pool; }
 
   const AliHLTTPCCAMergerOutput * Output() const { return fOutput; }
   AliHLTTPCCAMergerOutput * Output() { return fOutput; }
 
+    /// memory of the current event: fArena.Used(), maximum over events: fArena.HighWater()
+  const AliHLTTPCCAArena &Arena() const { return fArena; }
+
   int NTimers() { return fNTimers; }
   float Timer( int i ) { return fTimers[i]; };
 
@@ -145,8 +183,13 @@ class AliHLTTPCCAMerger
 
   void MakeBorderTracks( AliHLTTPCCABorderTrack B[], unsigned int &nB, unsigned char &iSlice );
 
-  void MergeBorderTracks( AliHLTTPCCABorderTrack B1[], int N1, unsigned int iSlice1, AliHLTTPCCABorderTrack B2[], int N2, unsigned int iSlice2, int number,
-                            const unsigned int FirstTrIR[], const unsigned int LastTrIR[]);
+  void AddBorderPair( int &nPairs, AliHLTTPCCABorderTrack *B1, int N1, unsigned int iSlice1, AliHLTTPCCABorderTrack *B2, int N2, unsigned int iSlice2, int number,
+                      const unsigned int FirstTrIR[], const unsigned int LastTrIR[] );
+  void BorderSearchRange( const AliHLTTPCCABorderPair &p, const AliHLTTPCCABorderTrack &b1, int &firstIRow, int &lastIRow, int &dir, int &ifirst2, int &ilast2 );
+  void FindBorderCandidates( AliHLTTPCCABorderPair &p ); // can run in parallel for different pairs
+  void LinkBorderTracks( const AliHLTTPCCABorderPair &p ); // sets the links, the pairs have to be processed in order
+  void ParallelFor( int n, const std::function<void( int )> &task ); // on fThreadPool if it is set
+  template<typename Task> void ParallelFor( int n, const Task &task ) { ParallelFor( n, std::function<void( int )>( std::cref( task ) ) ); } // no heap copy of the functor
   void FindMinMaxIndex( int N2, const unsigned int FirstTrIR[], const unsigned int LastTrIR[], int minIRow, int maxIRow, int &min, int &max );
   void CheckTracksMatch( int number,
   const AliHLTTPCCATrackParamVector &InParT1, const AliHLTTPCCATrackParamVector &OutParT1, const float_v &OutAlphaT1, const float_v &InAlphaT1,
@@ -202,6 +245,14 @@ class AliHLTTPCCAMerger
 
   AliHLTTPCCAMergerOutput *fOutput;       //* array of output merged tracks
 
+  AliHLTTPCCAThreadPool *fThreadPool;     //* threads for the neighbours search, not owned
+  std::vector<AliHLTTPCCABorderPair> fBorderPairs; //* slice pairs of the current FindNeighbourTracks, kept to reuse the memory
+
+  AliHLTTPCCAArena fArena;                //* memory of the current event, reset by UnpackSlices
+  Vc::vector<AliHLTTPCCASliceTrackInfo> fTmpTrackInfos; //* new fTrackInfos, created by Merging
+  std::vector<int> fMergedSegmentsOldIndexes; //* used by Merging, kept to reuse the memory
+  std::vector<int_v> fSegmentNumbers;         //* used by Merging, kept to reuse the memory
+
 #if 0
   int GetFirstMappedTrackID( unsigned int islice, unsigned int irow ) {
     for( int iRow = irow; iRow < irow + sMaxGape; iRow++ ) {
@@ -24,6 +24,7 @@
 
 
 #include "AliHLTTPCCANeighboursCleaner.h"
+#include "AliHLTTPCCAStartHitsFinder.h"
 #include "AliHLTTPCCAMath.h"
 #include "AliHLTTPCCATracker.h"
 
@@ -31,9 +32,11 @@
 // * kill link to the neighbour if the neighbour is not pointed to the hit
 // *
 #ifndef V6
-void AliHLTTPCCANeighboursCleaner::run( const int numberOfRows, SliceData &data, const AliHLTTPCCAParam &param )
+int AliHLTTPCCANeighboursCleaner::run( const int numberOfRows, SliceData &data, const AliHLTTPCCAParam &param,
+                                       AliHLTTPCCAStartHitId *startHitCandidates )
 #else
-void AliHLTTPCCANeighboursCleaner::run( const int numberOfRows, AliHLTTPCCASliceData &data, const AliHLTTPCCAParam &param, int it, std::vector<hit_link>& save_up_links )
+int AliHLTTPCCANeighboursCleaner::run( const int numberOfRows, AliHLTTPCCASliceData &data, const AliHLTTPCCAParam &param, int it, std::vector<hit_link>& save_up_links,
+                                       AliHLTTPCCAStartHitId *startHitCandidates )
 #endif
 {
   float_v X,Y,Z,Xup,Yup,Zup,Xdown,Ydown,Zdown, X4,Y4,Z4;
@@ -43,6 +46,8 @@ void AliHLTTPCCANeighboursCleaner::run( const int numberOfRows, AliHLTTPCCASlice
   const int rowStep = AliHLTTPCCAParameters::RowStep;
   const int beginRowIndex = rowStep;
   const int endRowIndex = numberOfRows - rowStep;
+  const int lastStartRow = numberOfRows - 2 * rowStep; // the last row of the start hits, see AliHLTTPCCAStartHitsFinder
+  int nCandidates = 0;
   for ( int rowIndex = beginRowIndex; rowIndex < endRowIndex; ++rowIndex ) {
     const AliHLTTPCCARow &row = data.Row( rowIndex );
     const AliHLTTPCCARow &rowUp = data.Row( rowIndex + rowStep );
@@ -58,48 +63,32 @@ void AliHLTTPCCANeighboursCleaner::run( const int numberOfRows, AliHLTTPCCASlice
       const uint_v hitIndexes = uint_v( Vc::IndexesFromZero ) + hitIndex;
       int_m validHitsMask = hitIndexes < numberOfHits;
       assert( ( validHitsMask && ((hitIndexes   >= 0 ) && (hitIndexes   < row.NHits()   )) ) == validHitsMask );
-//      validHitsMask &= ( int_v(data.HitDataIsUsed( row ), hitIndexes, validHitsMask ) == int_v( Vc::Zero ) ); // not-used hits can be connected only with not-used, so only one check is needed
-      int_v hitDataTemp;
-      for( unsigned int i = 0; i < float_v::Size; i++ ) {
-	if( !validHitsMask[i] ) continue;
-	hitDataTemp[i] = data.HitDataIsUsed( row )[(unsigned int)hitIndexes[i]];
-      }
-      validHitsMask &= hitDataTemp == int_v( Vc::Zero );
+        // the hits of the row are contiguous, so their flags and links are loaded as vectors, only the links of the
+        // neighbours are gathered
+      validHitsMask &= data.HitDataIsUsed( row, hitIndex ) == int_v( Vc::Zero ); // not-used hits can be connected only with not-used, so only one check is needed
 
         // collect information
         // up part
       assert( ( validHitsMask && ((hitIndexes   >= 0 ) && (hitIndexes   < row.NHits()   )) ) == validHitsMask );
-      int_v up;
-      for( unsigned int i = 0; i < float_v::Size; i++ ) {
-	if( !validHitsMask[i] ) continue;
-	up[i] = data.HitLinkUpData( row )[(unsigned int)hitIndexes[i]];
-      }
+      int_v up = data.HitLinkUpData( row, hitIndex );
+      up( !validHitsMask ) = minusOne;
       VALGRIND_CHECK_VALUE_IS_DEFINED( up );
       const uint_v upIndexes = up.staticCast<uint_v>();
       assert ( (validHitsMask && (up >= minusOne) ) == validHitsMask );
       int_m upMask = validHitsMask && up >= int_v( Vc::Zero );
       assert( ( upMask && ((upIndexes   >= 0 ) && (upIndexes   < rowUp.NHits()   )) ) == upMask );
-      int_v downFromUp;
-      for( unsigned int i = 0; i < float_v::Size; i++ ) {
-	if( !upMask[i] ) continue;
-	downFromUp[i] = data.HitLinkDownData( rowUp )[(unsigned int)upIndexes[i]];
-      }
+      int_v downFromUp( minusOne );
+      CAGatherScatter::Gather( downFromUp, data.HitLinkDownData( rowUp ), upIndexes, upMask );
         // down part
-      int_v dn;
-      for( unsigned int i = 0; i < float_v::Size; i++ ) {
-      	if( !validHitsMask[i] ) continue;
-      	dn[i] = data.HitLinkDownData( row )[(unsigned int)hitIndexes[i]];
-      }
+      int_v dn = data.HitLinkDownData( row, hitIndex );
+      dn( !validHitsMask ) = minusOne;
       assert ( ( validHitsMask && (dn >= minusOne) ) == validHitsMask );
       VALGRIND_CHECK_VALUE_IS_DEFINED( dn );
       const uint_v downIndexes = dn.staticCast<uint_v>();
       int_m dnMask = validHitsMask && dn >= int_v( Vc::Zero );
       assert( ( dnMask && ((downIndexes   >= 0 ) && (downIndexes   < rowDown.NHits()   )) ) == dnMask );
-      int_v upFromDown;
-      for( unsigned int i = 0; i < float_v::Size; i++ ) {
-      	if( !dnMask[i] ) continue;
-      	upFromDown[i] = data.HitLinkUpData( rowDown )[(unsigned int)downIndexes[i]];
-      }
+      int_v upFromDown( minusOne );
+      CAGatherScatter::Gather( upFromDown, data.HitLinkUpData( rowDown ), downIndexes, dnMask );
 #ifdef V6	// Triplet saver
       if( it == 0 ) {
         int_m trs_mask( upMask && dnMask && int_m( up >= 0 && downFromUp < 0 ) && int_m( dn >= 0 && upFromDown < 0 ) );
@@ -240,5 +229,12 @@ void AliHLTTPCCANeighboursCleaner::run( const int numberOfRows, AliHLTTPCCASlice
       assert( ( badDnMask && ((hitIndexes   >= 0 ) && (hitIndexes   < row.NHits()   )) )  == badDnMask );
       data.SetHitLinkDownData( row, hitIndexes, minusOne, badDnMask );
     } // for iHit
+
+      // the rows below are not changed any more, so the start hits of the row below are found while its links are in the cache
+    nCandidates += AliHLTTPCCAStartHitsFinder::FindCandidates( data, rowIndex - rowStep, startHitCandidates + nCandidates );
   } // for iRow
+  for ( int rowIndex = CAMath::Max( endRowIndex - rowStep, 0 ); rowIndex <= lastStartRow; ++rowIndex ) {
+    nCandidates += AliHLTTPCCAStartHitsFinder::FindCandidates( data, rowIndex, startHitCandidates + nCandidates );
+  }
+  return nCandidates;
 }
@@ -30,16 +30,21 @@
 #include "AliHLTTPCCAParam.h"
 
 class AliHLTTPCCASliceData;
+class AliHLTTPCCAStartHitId;
 
 /**
  * @class AliHLTTPCCANeighboursCleaner
  *
+ * The same pass over the rows collects the candidates of the start hits (AliHLTTPCCAStartHitsFinder::FindCandidates)
+ * of each row as soon as its links are cleaned, they are written to startHitCandidates, the number is returned.
  */
 struct AliHLTTPCCANeighboursCleaner {
 #ifndef V6
-  static void run( const int numberOfRows, AliHLTTPCCASliceData &data, const AliHLTTPCCAParam &param );
+  static int run( const int numberOfRows, AliHLTTPCCASliceData &data, const AliHLTTPCCAParam &param,
+                  AliHLTTPCCAStartHitId *startHitCandidates );
 #else
-  static void run( const int numberOfRows, AliHLTTPCCASliceData &data, const AliHLTTPCCAParam &param, int it, std::vector<hit_link>& save_up_links );
+  static int run( const int numberOfRows, AliHLTTPCCASliceData &data, const AliHLTTPCCAParam &param, int it, std::vector<hit_link>& save_up_links,
+                  AliHLTTPCCAStartHitId *startHitCandidates );
 #endif
 };
 
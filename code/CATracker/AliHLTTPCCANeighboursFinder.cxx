@@ -28,11 +28,6 @@
 #include "AliHLTArray.h"
 #include "AliHLTTPCCADef.h"
 
-#ifdef USE_TBB
-#include <tbb/parallel_for.h>
-#include <tbb/blocked_range.h>
-#endif //USE_TBB
-
 #ifdef MAIN_DRAW
 #include "AliHLTTPCCADisplay.h"
 bool DRAW_EVERY_LINK = false;
@@ -53,13 +48,10 @@ void AliHLTTPCCATracker::NeighboursFinder::execute()
     AliHLTTPCCADisplay::Instance().DrawSliceHits();
   }
 #endif
-  //tbb::affinity_partitioner partitioner;
   const int rowStep = AliHLTTPCCAParameters::RowStep;
-#ifdef USE_TBB  
-  tbb::parallel_for( tbb::blocked_range<int>( rowStep, numberOfRows - rowStep, 1000 ), *this );//, partitioner );
-#else  //USE_TBB  
-  for ( int iRow = rowStep; iRow < numberOfRows - rowStep; ++iRow ) {
-    executeOnRow( iRow );
-  }
-#endif //USE_TBB
+  const int nRows = numberOfRows - 2 * rowStep;
+  if ( nRows <= 0 ) return;
+  int nTruncations[AliHLTTPCCAParameters::MaxNumberOfRows8];
+  fTracker->ParallelFor( nRows, ExecuteOnRow( *this, rowStep, nTruncations ) );
+  for ( int i = 0; i < nRows; i++ ) fTracker->fNNeighbourTruncations += nTruncations[i];
 }
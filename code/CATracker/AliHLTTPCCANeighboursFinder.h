@@ -29,13 +29,10 @@
 #include "AliHLTTPCCAHitArea.h"
 #include <iostream>
 #include <queue>
+#include <vector>
 using std::cout;
 using std::endl;
 
-#ifdef USE_TBB
-#include <tbb/blocked_range.h>
-#endif //USE_TBB
-
 /**
  * @class AliHLTTPCCANeighboursFinder
  */
@@ -44,14 +41,13 @@ class AliHLTTPCCATracker::NeighboursFinder
   public:
     class ExecuteOnRow;
     NeighboursFinder( AliHLTTPCCATracker *tracker, SliceData &sliceData, int iIter ) : fTracker( tracker ), fData( sliceData ), fIter(iIter) {}
-    void execute();
-  
-#ifdef USE_TBB
-    void operator()( const tbb::blocked_range<int> &r ) const;
-#endif //USE_TBB
+    void execute(); // the rows run in parallel, the kernel is selected by AliHLTTPCCATracker::SetDenseNeighboursFinder
   
   private:
-    void executeOnRow( int rowIndex ) const;
+      /// Both return the number of hits with more than MaxNeighboursUp hits in the upper area,
+      /// which are cut by executeOnRow and all taken by executeOnRowDense
+    int executeOnRow( int rowIndex ) const;
+    int executeOnRowDense( int rowIndex ) const;
 #if 0
     void executeOnRowV1( int rowIndex ) const;
 #endif
@@ -61,16 +57,24 @@ class AliHLTTPCCATracker::NeighboursFinder
     int fIter; // current iteration of finding
 };
 
-#ifdef USE_TBB
-inline void AliHLTTPCCATracker::NeighboursFinder::operator()( const tbb::blocked_range<int> &r ) const
+  /// task of one row, the rows only write the links of their own hits
+class AliHLTTPCCATracker::NeighboursFinder::ExecuteOnRow
 {
-  for ( int i = r.begin(); i < r.end(); ++i ) {
-    executeOnRow( i );
-  }
-}
-#endif //USE_TBB
+  public:
+    ExecuteOnRow( const NeighboursFinder &finder, int firstRow, int *nTruncations ):
+      fFinder( finder ), fFirstRow( firstRow ), fNTruncations( nTruncations ) {}
+    void operator()( int i ) const {
+      const int iRow = fFirstRow + i;
+      fNTruncations[i] = fFinder.fTracker->IsDenseNeighboursFinder() ? fFinder.executeOnRowDense( iRow ) : fFinder.executeOnRow( iRow );
+    }
+
+  private:
+    const NeighboursFinder &fFinder;
+    int fFirstRow;
+    int *fNTruncations; // of each row, summed after all rows
+};
 
-inline void AliHLTTPCCATracker::NeighboursFinder::executeOnRow( int rowIndex ) const
+inline int AliHLTTPCCATracker::NeighboursFinder::executeOnRow( int rowIndex ) const
 {
   debugS() << "NeighboursFinder on row " << rowIndex << std::endl;
   const AliHLTTPCCARow &row = fData.Row( rowIndex );
@@ -87,11 +91,11 @@ inline void AliHLTTPCCATracker::NeighboursFinder::executeOnRow( int rowIndex ) c
   const unsigned int numberOfHitsDown = rowDn.NUnusedHits();
   if ( numberOfHits == 0 ) {
     debugS() << "no hits in this row" << std::endl;
-    return;
+    return 0;
   }
   if ( numberOfHitsDown == 0 || numberOfHitsUp == 0 ) {
     debugS() << "no hits in neighbouring rows" << std::endl;
-    return;
+    return 0;
   }
 
   // the axis perpendicular to the rows
@@ -128,9 +132,10 @@ inline void AliHLTTPCCATracker::NeighboursFinder::executeOnRow( int rowIndex ) c
    * The constant ( dx1^2 + dx2^2 ) is multiplied into the chi2Cut
    */
 
-  static const float kAreaSizeY = AliHLTTPCCAParameters::NeighbourAreaSizeTgY[fIter];
-  static const float kAreaSizeZ = AliHLTTPCCAParameters::NeighbourAreaSizeTgZ[fIter];
-  static const int kMaxN = 20; // TODO minimaze
+  const float kAreaSizeY = fTracker->Param().NeighbourAreaSizeTgY( fIter );
+  const float kAreaSizeZ = fTracker->Param().NeighbourAreaSizeTgZ( fIter );
+  static const int kMaxN = AliHLTTPCCAParameters::MaxNeighboursUp; // TODO minimaze
+  int nTruncations = 0;
 
   float koeff = 1.;
 #ifdef ITPC_TCUT
@@ -143,7 +148,7 @@ inline void AliHLTTPCCATracker::NeighboursFinder::executeOnRow( int rowIndex ) c
   const float UpErr2 = (rowIndex - rowStep < AliHLTTPCCAParameters::NumberOfInnerRows) ? 0.06*0.06 : 0.12*0.12,
               DnErr2 = (rowIndex + rowStep < AliHLTTPCCAParameters::NumberOfInnerRows) ? 0.06*0.06 : 0.12*0.12;
 #else // USE_CURV_CUT  
-  const float chi2Cut = AliHLTTPCCAParameters::NeighbourChiCut[fIter]*AliHLTTPCCAParameters::NeighbourChiCut[fIter] * 4.f * ( UpDx * UpDx + DnDx * DnDx ) * koeff;
+  const float chi2Cut = fTracker->Param().NeighbourChiCut( fIter )*fTracker->Param().NeighbourChiCut( fIter ) * 4.f * ( UpDx * UpDx + DnDx * DnDx ) * koeff;
 #endif // USE_CURV_CUT  
   // some step sizes on the current row. the uints in hits multiplied with the step size give
   // the offset on the grid
@@ -208,6 +213,8 @@ inline void AliHLTTPCCATracker::NeighboursFinder::executeOnRow( int rowIndex ) c
 
       if ( ISUNLIKELY(upperNeighbourIndex >= kMaxN) ){
         // std::cout << "W AliHLTTPCCANeighboursFinder: Warning: Too many neighbours, some of them won't be considered \ Too small array. " << std::endl;
+        NeighbourData rest;
+        nTruncations += areaUp.GetNext( &rest ).count(); // hits which still have neighbours
         break;
       }
     }
@@ -288,6 +295,133 @@ inline void AliHLTTPCCATracker::NeighboursFinder::executeOnRow( int rowIndex ) c
     fData.SetUnusedHitLinkDownData( row, rowDn, hitIndexes, bestDn, validHitsMask);
   } // for hitIndex
 
+  return nTruncations;
+}
+
+  /// candidate hits of one hit for executeOnRowDense, in the order of the grid bins
+struct AliHLTTPCCANeighbourCandidates
+{
+  std::vector<float> fY, fZ; // distance to the hit times dx of the other row, padded to float_v::Size
+  std::vector<int> fLinks;   // hit index in the row
+  void Clear() { fY.clear(); fZ.clear(); fLinks.clear(); }
+  void Add( float y, float z, int link ) { fY.push_back( y ); fZ.push_back( z ); fLinks.push_back( link ); }
+};
+
+  /**
+   * The same links as executeOnRow without the MaxNeighboursUp cut. The hit areas are iterated for the vector
+   * of hits as there, but the candidates are only collected per hit. Then for each hit the pairs of a lower
+   * candidate and all upper candidates are evaluated in full vectors, instead of the lanes waiting for each other.
+   * Only the chi2 cut (no USE_CURV_CUT) is implemented.
+   */
+inline int AliHLTTPCCATracker::NeighboursFinder::executeOnRowDense( int rowIndex ) const
+{
+  const AliHLTTPCCARow &row = fData.Row( rowIndex );
+  const int rowStep = AliHLTTPCCAParameters::RowStep;
+  const AliHLTTPCCARow &rowUp = fData.Row( rowIndex + rowStep );
+  const AliHLTTPCCARow &rowDn = fData.Row( rowIndex - rowStep );
+
+  const unsigned int numberOfHits = row.NUnusedHits();
+  if ( numberOfHits == 0 || rowDn.NUnusedHits() == 0 || rowUp.NUnusedHits() == 0 ) return 0;
+
+  const float xDn = fData.RowX( rowIndex - rowStep );
+  const float x   = fData.RowX( rowIndex     );
+  const float xUp = fData.RowX( rowIndex + rowStep );
+  const float UpDx = xUp - x;
+  const float DnDx = xDn - x;
+  const float UpTx = xUp / x;
+  const float DnTx = xDn / x;
+
+  const float kAreaSizeY = fTracker->Param().NeighbourAreaSizeTgY( fIter );
+  const float kAreaSizeZ = fTracker->Param().NeighbourAreaSizeTgZ( fIter );
+  float koeff = 1.;
+#ifdef ITPC_TCUT
+  if( fTracker->Param().NRows() > 45 ) koeff = 3.5;
+#endif
+  const float chi2Cut = fTracker->Param().NeighbourChiCut( fIter )*fTracker->Param().NeighbourChiCut( fIter ) * 4.f * ( UpDx * UpDx + DnDx * DnDx ) * koeff;
+  const float kFar = 1.e10f; // padding of the upper candidates, never passes the cut
+
+  typedef HitArea::NeighbourData NeighbourData;
+  int nTruncations = 0;
+    // kept by each thread for its next rows and events, so the candidates reuse their memory
+  static thread_local AliHLTTPCCANeighbourCandidates up[float_v::Size], dn[float_v::Size];
+
+  for ( unsigned int hitIndex = 0; hitIndex < numberOfHits; hitIndex += int_v::Size ) {
+    const uint_v hitIndexes( uint_v(Vc::IndexesFromZero) + hitIndex );
+    const int_m &validHitsMask = hitIndexes < numberOfHits;
+
+    const float_v y = fData.UnusedHitPDataY( row, hitIndexes, static_cast<float_m>(validHitsMask) );
+    const float_v z = fData.UnusedHitPDataZ( row, hitIndexes, static_cast<float_m>(validHitsMask) );
+
+    for ( unsigned int iV = 0; iV < float_v::Size; iV++ ) {
+      up[iV].Clear();
+      dn[iV].Clear();
+    }
+
+    HitArea areaUp( rowUp, fData, y * UpTx, z * UpTx, UpDx*kAreaSizeY, UpDx*kAreaSizeZ, validHitsMask );
+    NeighbourData neigh;
+    while ( !( areaUp.GetNext( &neigh ) ).isEmpty() ) {
+      const float_v dy = DnDx * ( neigh.fY - y );
+      const float_v dz = DnDx * ( neigh.fZ - z );
+      for ( unsigned int iV = 0; iV < float_v::Size; iV++ ) {
+        if ( neigh.fValid[iV] ) up[iV].Add( dy[iV], dz[iV], neigh.fLinks[iV] );
+      }
+    }
+
+    HitArea areaDn( rowDn, fData, y * DnTx, z * DnTx, -DnDx*kAreaSizeY, -DnDx*kAreaSizeZ, validHitsMask );
+    while ( !( areaDn.GetNext( &neigh ) ).isEmpty() ) {
+      const float_v dy = UpDx * ( neigh.fY - y );
+      const float_v dz = UpDx * ( neigh.fZ - z );
+      for ( unsigned int iV = 0; iV < float_v::Size; iV++ ) {
+        if ( neigh.fValid[iV] && !up[iV].fLinks.empty() ) dn[iV].Add( dy[iV], dz[iV], neigh.fLinks[iV] );
+      }
+    }
+
+    int_v bestUp( -1 );
+    int_v bestDn( -1 );
+    for ( unsigned int iV = 0; iV < float_v::Size; iV++ ) {
+      AliHLTTPCCANeighbourCandidates &u = up[iV];
+      const AliHLTTPCCANeighbourCandidates &d = dn[iV];
+      const unsigned int nUp = u.fLinks.size();
+      if ( nUp > static_cast<unsigned int>( AliHLTTPCCAParameters::MaxNeighboursUp ) ) nTruncations++;
+      if ( d.fLinks.empty() ) continue;
+      const unsigned int nUpV = ( nUp + float_v::Size - 1 ) / float_v::Size * float_v::Size;
+      u.fY.resize( nUpV, kFar );
+      u.fZ.resize( nUpV, kFar );
+
+        // for each lower candidate the first upper one with the smallest distance, as executeOnRow finds it
+      float bestD = chi2Cut;
+      for ( unsigned int iDn = 0; iDn < d.fLinks.size(); iDn++ ) {
+        const float_v dnY( d.fY[iDn] );
+        const float_v dnZ( d.fZ[iDn] );
+        float_v minD( kFar );
+        uint_v minIndex( Vc::Zero );
+        for ( unsigned int iUp = 0; iUp < nUpV; iUp += float_v::Size ) {
+          const float_v dy = dnY - float_v( &u.fY[iUp], Vc::Unaligned );
+          const float_v dz = dnZ - float_v( &u.fZ[iUp], Vc::Unaligned );
+          const float_v dist = dy * dy + dz * dz;
+          const float_m closer = dist < minD;
+          minD( closer ) = dist;
+          minIndex( static_cast<uint_m>( closer ) ) = uint_v( Vc::IndexesFromZero ) + iUp;
+        }
+        const float dMin = minD.min();
+        if ( !( dMin < bestD ) ) continue;
+        unsigned int iBest = nUpV;
+        for ( unsigned int i = 0; i < float_v::Size; i++ ) {
+          if ( minD[i] == dMin && minIndex[i] < iBest ) iBest = minIndex[i];
+        }
+        bestD = dMin;
+        bestUp[iV] = u.fLinks[iBest];
+        bestDn[iV] = d.fLinks[iDn];
+      }
+    }
+
+    assert( ((bestUp >= -1) && (bestUp < rowUp.NUnusedHits()) && validHitsMask) == validHitsMask );
+    assert( ((bestDn >= -1) && (bestDn < rowDn.NUnusedHits()) && validHitsMask) == validHitsMask );
+    fData.SetUnusedHitLinkUpData( row, rowUp, hitIndexes, bestUp, validHitsMask);
+    fData.SetUnusedHitLinkDownData( row, rowDn, hitIndexes, bestDn, validHitsMask);
+  } // for hitIndex
+
+  return nTruncations;
 }
 
 #if 0
@@ -330,11 +464,11 @@ inline void AliHLTTPCCATracker::NeighboursFinder::executeOnRowV1( int rowIndex )
   const float UpTx = xUp / x;
   const float DnTx = xDn / x;
 
-  static const float kAreaSizeY = AliHLTTPCCAParameters::NeighbourAreaSizeTgY[fIter];
-  static const float kAreaSizeZ = AliHLTTPCCAParameters::NeighbourAreaSizeTgZ[fIter];
+  const float kAreaSizeY = fTracker->Param().NeighbourAreaSizeTgY( fIter );
+  const float kAreaSizeZ = fTracker->Param().NeighbourAreaSizeTgZ( fIter );
   static const int kMaxN = 20; // TODO minimaze
 
-  const float chi2Cut = AliHLTTPCCAParameters::NeighbourChiCut[fIter]*AliHLTTPCCAParameters::NeighbourChiCut[fIter] * 4.f * ( UpDx * UpDx + DnDx * DnDx );
+  const float chi2Cut = fTracker->Param().NeighbourChiCut( fIter )*fTracker->Param().NeighbourChiCut( fIter ) * 4.f * ( UpDx * UpDx + DnDx * DnDx );
 
   std::vector<unsigned int> hits0, hits1, hits2, hits2temp;
 
@@ -36,6 +36,7 @@ AliHLTTPCCAParam::AliHLTTPCCAParam()
     fHitPickUpFactor( 1. ),
     fMaxTrackMatchDRow( 4 ), fTrackConnectionFactor( 3.5 ), fTrackChiCut( 3.5 ), fTrackChi2Cut( 10 ) // are rewrited from file. See operator>>()
   ,fRecoType(0) //Default is Sti
+  ,fTuning()
 {
   // constructor
 ///mvz start
@@ -335,6 +336,43 @@ std::istream &operator>>( std::istream &in, AliHLTTPCCAParam &p )
   return in;
 }
 
+AliHLTTPCCAParam::Tuning::Tuning()
+{
+  for ( int i = 0; i < AliHLTTPCCAParameters::MaxNumberOfIterations; i++ ) {
+    fNeighbourAreaSizeTgY[i] = AliHLTTPCCAParameters::NeighbourAreaSizeTgY[i];
+    fNeighbourAreaSizeTgZ[i] = AliHLTTPCCAParameters::NeighbourAreaSizeTgZ[i];
+#ifdef USE_CURV_CUT
+    fNeighbourChiCut[i] = 0; // not used, see AliHLTTPCCAParameters::NeighbourCurvCut
+#else
+    fNeighbourChiCut[i] = AliHLTTPCCAParameters::NeighbourChiCut[i];
+#endif // USE_CURV_CUT
+    fNeighboursChainMinLength[i] = AliHLTTPCCAParameters::NeighboursChainMinLength[i];
+  }
+}
+
+bool AliHLTTPCCAParam::Tuning::Read( std::istream &in )
+{
+  int nIter = 0;
+  in >> nIter;
+  if ( !in || nIter <= 0 || nIter > AliHLTTPCCAParameters::MaxNumberOfIterations ) return 0;
+  Tuning t( *this ); // the iterations which are not in the file keep their values
+  for ( int i = 0; i < nIter; i++ ) {
+    in >> t.fNeighbourAreaSizeTgY[i] >> t.fNeighbourAreaSizeTgZ[i] >> t.fNeighbourChiCut[i] >> t.fNeighboursChainMinLength[i];
+    if ( !in ) return 0;
+  }
+  *this = t;
+  return 1;
+}
+
+void AliHLTTPCCAParam::Tuning::Write( std::ostream &out ) const
+{
+  out << AliHLTTPCCAParameters::MaxNumberOfIterations << std::endl;
+  for ( int i = 0; i < AliHLTTPCCAParameters::MaxNumberOfIterations; i++ ) {
+    out << fNeighbourAreaSizeTgY[i] << " " << fNeighbourAreaSizeTgZ[i] << " "
+        << fNeighbourChiCut[i] << " " << fNeighboursChainMinLength[i] << std::endl;
+  }
+}
+
 #include "BinaryStoreHelper.h"
 
 void AliHLTTPCCAParam::StoreToFile( FILE *f ) const
@@ -27,6 +27,7 @@
 
 #include "AliHLTTPCCADef.h"
 #include "AliHLTTPCCAMath.h"
+#include "AliHLTTPCCAGatherScatter.h"
 #include "AliHLTTPCCATrackParam.h"
 #include "AliHLTTPCCAParameters.h"
 #include <cstdio>
@@ -58,6 +59,23 @@ class AliHLTTPCCAParam
 
     AliHLTTPCCAParam();
 
+      /// Cuts of the iterations of the slice tracker, AliHLTTPCCAParameters gives the defaults. They are not
+      /// a part of the settings file, so they can be changed for a run (see AliHLTTPCCAGBTracker::SetTuning).
+      /// Text format: the number of iterations, then for each one the area sizes in y and z, the chi cut
+      /// of the NeighboursFinder and the minimal chain length of the StartHitsFinder.
+    class Tuning
+    {
+      public:
+        Tuning();
+        bool Read( std::istream &in ); // the tuning is kept if it can't be read
+        void Write( std::ostream &out ) const;
+
+        float fNeighbourAreaSizeTgY[AliHLTTPCCAParameters::MaxNumberOfIterations]; // NeighboursFinder area size = coeff*dx [cm/dx]
+        float fNeighbourAreaSizeTgZ[AliHLTTPCCAParameters::MaxNumberOfIterations];
+        float fNeighbourChiCut[AliHLTTPCCAParameters::MaxNumberOfIterations];      // cut on the change of the slope of the neighbours
+        int fNeighboursChainMinLength[AliHLTTPCCAParameters::MaxNumberOfIterations]; // min length of chain to make tracklet
+    };
+
     void Initialize( int iSlice, int nRows, float rowX[],
                      float alpha, float dAlpha,
                      float rMin, float rMax, float zMin, float zMax,
@@ -104,6 +122,12 @@ class AliHLTTPCCAParam
     int   MaxTrackMatchDRow() const { return fMaxTrackMatchDRow; }
     float HitPickUpFactor() const { return fHitPickUpFactor; }
 
+    const Tuning &GetTuning() const { return fTuning; }
+    float NeighbourAreaSizeTgY( int iIter ) const { return fTuning.fNeighbourAreaSizeTgY[iIter]; }
+    float NeighbourAreaSizeTgZ( int iIter ) const { return fTuning.fNeighbourAreaSizeTgZ[iIter]; }
+    float NeighbourChiCut( int iIter ) const { return fTuning.fNeighbourChiCut[iIter]; }
+    int NeighboursChainMinLength( int iIter ) const { return fTuning.fNeighboursChainMinLength[iIter]; }
+
 
 
     void SetISlice( int v ) {  fISlice = v;}
@@ -131,6 +155,7 @@ class AliHLTTPCCAParam
     void SetMaxTrackMatchDRow( int v ) {  fMaxTrackMatchDRow = v; }
     void SetHitPickUpFactor( float v ) {  fHitPickUpFactor = v; }
     void SetRecoType( int reco)        {  fRecoType = reco; }
+    void SetTuning( const Tuning &tuning ) { fTuning = tuning; }
 
     void GetClusterErrors2( int iRow, const AliHLTTPCCATrackParam &t, float &Err2Y, float &Err2Z ) const;
     void GetClusterErrors2( uint_v rowIndexes, const float_v &X, const float_v &Y, float_v &Z, float_v &Err2Y, float_v &Err2Z ) const;
@@ -180,6 +205,7 @@ class AliHLTTPCCAParam
     int   fRecoType;		   // 0=Sti error parametrization; 1=Stv
     float fParamS0Par[2][4][7] = {{{0}}};    // cluster error parameterization coeficients; 0 -> iTPC, 1 -> oTPC, 2 -> BToF, 3 -> EToF
     float fPolinomialFieldBz[6];   // field coefficients
+    Tuning fTuning; // cuts of the iterations, not in the settings file
 
   private:
   inline int errorType( int row) const {
@@ -291,13 +317,7 @@ inline void AliHLTTPCCAParam::GetClusterErrors2( uint_v rowIndexes, const TrackP
 #endif
   v(v<errmin) = errmin;
   *Err2Y = CAMath::Abs( v );
-#ifdef VC_GATHER_SCATTER
-  v.gather( c+3, type );
-#else
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-      v[i] = c[(unsigned int)type[i] + 3];
-  }
-#endif
+  CAGatherScatter::Gather( v, c + 3, type );
   v += z * v4*(one + tg2Lambda) + v5*tg2Lambda;
 #if 0
   v(v>one) = one;
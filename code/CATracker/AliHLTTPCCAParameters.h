@@ -83,6 +83,16 @@ namespace AliHLTTPCCAParameters
       */
     RowStep = 1,
 
+    /**
+     * Maximal number of hits in the upper area of a hit considered by the NeighboursFinder,
+     * the dense kernel of the NeighboursFinder takes all of them
+     */
+    MaxNeighboursUp = 20,
+    /**
+     * Size of the arrays of the per-iteration cuts below
+     */
+    MaxNumberOfIterations = 3,
+
       /**
        * Number of cells in grid will be GridCreationCoeff*NHitsOnRow
        */
@@ -115,7 +125,8 @@ namespace AliHLTTPCCAParameters
   
   /**
    * Coefficient for size of region on neighbour rows for search neghbour hits. Size = coeff*dx. [cm/dx]
-   * different for different iteration of finding
+   * different for different iteration of finding.
+   * The per-iteration values are the defaults of AliHLTTPCCAParam::Tuning, the tracker uses the ones of its AliHLTTPCCAParam.
    */
   static const float NeighbourAreaSizeTgY[3] = {.6,  2., 2.}; // TODO choose appropriate and use > 1 iterations
   static const float NeighbourAreaSizeTgZ[3] = {2.,  2., 2.};
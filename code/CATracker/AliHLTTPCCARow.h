@@ -28,6 +28,10 @@
 #include "AliHLTTPCCADef.h"
 #include "AliHLTTPCCAGrid.h"
 #include "AliHLTTPCCAPackHelper.h"
+#include "AliHLTTPCCAMath.h"
+#ifdef TUNE_GRID
+#include <atomic>
+#endif // TUNE_GRID
 
 typedef int StoredIsUsed;
 
@@ -56,6 +60,20 @@ class AliHLTTPCCARow
     void RestoreFromFile( FILE *f, char *startPtr );
 
   int NUnusedHits()    const { return fNUnusedHits; }
+    /// Some hits were marked as used since the last AliHLTTPCCASliceData::CleanUsedHits, so it has to update the unused hits of the row
+  bool HasNewUsedHits() const { return fHasNewUsedHits; }
+#ifdef TUNE_GRID
+    /// Queries of the hit areas on the grid of the row, see AliHLTTPCCAGridProfile
+  void AddAreaStatistics( int nQueries, int nHits, int nZLines ) const { // the areas of a row are used by the neighbours finder of the other rows, which can run in parallel
+    fNAreaQueries += nQueries;
+    fNAreaHits += nHits;
+    fNAreaZLines += nZLines;
+  }
+  void ResetAreaStatistics() const { fNAreaQueries = 0; fNAreaHits = 0; fNAreaZLines = 0; }
+  int NAreaQueries() const { return fNAreaQueries; }
+  int NAreaHits() const { return fNAreaHits; }
+  int NAreaZLines() const { return fNAreaZLines; }
+#endif // TUNE_GRID
   unsigned int* HitIndex() const { return fHitIndex; }
   private:
     AliHLTTPCCAGrid fGrid;   // grid of hits
@@ -87,6 +105,10 @@ class AliHLTTPCCARow
     PackHelper::TPackedZ *fUnusedHitPDataZ;
     unsigned int *fHitIndex; // fIndexOfHitByIndexOfUnusedHit
     unsigned int *fFirstUnusedHitInBin; //X
+    mutable bool fHasNewUsedHits; // see HasNewUsedHits(), set by the SetHitAsUsed functions of SliceData
+#ifdef TUNE_GRID
+    mutable std::atomic<int> fNAreaQueries, fNAreaHits, fNAreaZLines; // see AddAreaStatistics()
+#endif // TUNE_GRID
 };
 
 #endif
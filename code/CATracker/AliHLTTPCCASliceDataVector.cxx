@@ -49,12 +49,12 @@ void AliHLTTPCCASliceData::InitFromClusterData( const AliHLTTPCCAClusterData &da
   fNumberOfHits = data.NumberOfClusters();
 
   int numberOfHitsWithPadding = 0;
+  int firstHitInBinSize = 0;
   for ( int row = data.FirstRow(); row <= data.LastRow(); ++row ) {
     numberOfHitsWithPadding += NextMultipleOf<VectorAlignment>( data.NumberOfClusters( row ) );
+    firstHitInBinSize += 23 + static_cast<int>( fGridCreationCoeff[row] * 4 * data.NumberOfClusters( row ) ) + 1;
   }
 
-  const int numberOfRows = data.LastRow() - data.FirstRow() + 1;
-  const int firstHitInBinSize = 23 * numberOfRows + AliHLTTPCCAParameters::GridCreationCoeff * 4 * fNumberOfHits;
   const int memorySize =
     // LinkData
     2 * numberOfHitsWithPadding * sizeof( int ) +
@@ -147,19 +147,18 @@ void AliHLTTPCCASliceData::InitFromClusterData( const AliHLTTPCCAClusterData &da
     row.fFirstHitInBin = firstHitInBin;
 
     row.fNUnusedHits = 0;
+    row.fHasNewUsedHits = 0;
     row.fUnusedHitPDataY = unusedHitPDataY;
     row.fUnusedHitPDataZ = unusedHitPDataZ;
     row.fHitIndex = hitIndex;
     row.fFirstUnusedHitInBin = firstUnusedHitInBin;
   }
 
-  AliHLTResizableArray<float> binSortedHitsY( fNumberOfHits );
-  AliHLTResizableArray<float> binSortedHitsZ( fNumberOfHits );
-  
   int gridContentOffset = 0;
 
-  int binCreationMemorySize = 103 * 2 + fNumberOfHits;
-  AliHLTResizableArray<unsigned int> binCreationMemory( binCreationMemorySize );
+  // fBinCreationMemory only grows, so it is allocated for the first events only
+  AliHLTResizableArray<unsigned int> &binCreationMemory = fBinCreationMemory;
+  int binCreationMemorySize = binCreationMemory.Size();
 
   int hitNumberOffset = 0;
 
@@ -182,6 +181,7 @@ void AliHLTTPCCASliceData::InitFromClusterData( const AliHLTTPCCAClusterData &da
     row.fFirstHitInBin = &firstHitInBin[gridContentOffset];
 
     row.fNUnusedHits = row.fNHits;
+    row.fHasNewUsedHits = 0;
     row.fUnusedHitPDataY = &unusedHitPDataY[hitNumberOffset];
     row.fUnusedHitPDataZ = &unusedHitPDataZ[hitNumberOffset];
     row.fHitIndex = &hitIndex[hitNumberOffset];
@@ -265,6 +265,7 @@ void AliHLTTPCCASliceData::InitFromClusterData( const AliHLTTPCCAClusterData &da
     row.fFirstHitInBin = &firstHitInBin[gridContentOffset];
 
     row.fNUnusedHits = 0;
+    row.fHasNewUsedHits = 0;
     row.fUnusedHitPDataY = &unusedHitPDataY[hitNumberOffset];
     row.fUnusedHitPDataZ = &unusedHitPDataZ[hitNumberOffset];
     row.fHitIndex = &hitIndex[hitNumberOffset];
@@ -24,6 +24,7 @@
 #include "AliHLTTPCCAParam.h"
 #include "AliHLTTPCCADef.h"
 #include "AliHLTTPCCAClusterData.h"
+#include "AliHLTTPCCAGatherScatter.h"
 #include <cstdio>
 
 #include "debug.h"
@@ -47,11 +48,20 @@ typedef unsigned int uint_i;
 class AliHLTTPCCASliceData
 {
   public:
-    AliHLTTPCCASliceData() : fMemorySize( 0 ), fMemory( 0 ), fParam( 0 ) {}
+    AliHLTTPCCASliceData() : fMemorySize( 0 ), fMemory( 0 ), fParam( 0 ), fUnusedHitIndex(), fBinCreationMemory() {
+      for ( int i = 0; i < AliHLTTPCCAParameters::MaxNumberOfRows8; ++i ) fGridCreationCoeff[i] = AliHLTTPCCAParameters::GridCreationCoeff;
+    }
     ~AliHLTTPCCASliceData() { if (fMemory) delete[] fMemory; }
 
     void InitializeRows( const AliHLTTPCCAParam &parameters );
 
+    /**
+     * The grid of the row with n hits gets about coeff * n cells, see AliHLTTPCCAGridProfile.
+     * Used by the next InitFromClusterData.
+     */
+    void SetGridCreationCoeff( int rowIndex, float coeff ) { fGridCreationCoeff[rowIndex] = coeff; }
+    float GridCreationCoeff( int rowIndex ) const { return fGridCreationCoeff[rowIndex]; }
+
     /**
      * (Re)Create the data that is tuned for optimal performance of the algorithm from the cluster
      * data.
@@ -108,6 +118,7 @@ class AliHLTTPCCASliceData
     float HitPDataZS( const AliHLTTPCCARow &row, int hitIndex ) const;
 
     const int *HitDataIsUsed( const AliHLTTPCCARow &row ) const;
+    int_v HitDataIsUsed( const AliHLTTPCCARow &row, const int_i &hitIndex ) const; // the flags of the hits hitIndex.. (a multiple of the vector size)
     float_v HitPDataY( const AliHLTTPCCARow &row, const uint_i &hitIndex ) const;
     float_v HitPDataZ( const AliHLTTPCCARow &row, const uint_i &hitIndex ) const;
     float_v HitPDataY( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const float_m &mask ) const;
@@ -116,7 +127,7 @@ class AliHLTTPCCASliceData
     float_v UnusedHitPDataZ( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const float_m &mask ) const;
     float UnusedHitPDataY( const AliHLTTPCCARow &row, const unsigned int hitIndex );
     float UnusedHitPDataZ( const AliHLTTPCCARow &row, const unsigned int hitIndex );
-    void SetHitAsUsed( const AliHLTTPCCARow &row, const unsigned int hitIndex );
+    void SetHitAsUsed( const AliHLTTPCCARow &row, const unsigned int hitIndex, int isUsed = 1 );
 
     void SetHitAsUsed( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const int_m &mask );
     void SetHitAsUsedInTrackFit( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const int_m &mask );
@@ -124,6 +135,8 @@ class AliHLTTPCCASliceData
 
     void SetHitAsUsedInStartSegment( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const int_m &mask );
 
+      /// Update the unused hits of the row. isFirst - all hits are unused, otherwise only the rows with
+      /// AliHLTTPCCARow::HasNewUsedHits() are updated, by removal of the new used hits from the unused ones.
     void CleanUsedHits( int rowIndex, bool isFirst );
     void CleanUsedHitsType( int rowIndex, int type );
   
@@ -157,6 +170,7 @@ class AliHLTTPCCASliceData
      */
     void MaximizeHitWeight( const AliHLTTPCCARow &row, const uint_v &hitIndex,
         const uint_v &weight );
+    void MaximizeHitWeight( const AliHLTTPCCARow &row, unsigned int hitIndex, unsigned int weight );
 
     /**
      * Return the maximal weight the given hit got from one tracklet
@@ -198,6 +212,9 @@ class AliHLTTPCCASliceData
     int fMemorySize;           // size of the allocated memory in bytes
     char *fMemory;             // pointer to the allocated memory where all the following arrays reside in
     const AliHLTTPCCAParam *fParam;  // pointer to the Param object for gathering X coordinates of rows
+    std::vector<unsigned int> fUnusedHitIndex; // used by CleanUsedHits and CleanUsedHitsType, kept to reuse the memory
+    AliHLTResizableArray<unsigned int> fBinCreationMemory; // used by InitFromClusterData to fill the grids, kept to reuse the memory
+    float fGridCreationCoeff[AliHLTTPCCAParameters::MaxNumberOfRows8]; // see SetGridCreationCoeff()
 };
 
 inline int AliHLTTPCCASliceData::HitLinkUpDataS  ( const AliHLTTPCCARow &row, int hitIndex ) const
@@ -235,18 +252,14 @@ inline int_v AliHLTTPCCASliceData::HitLinkDownData( const AliHLTTPCCARow &row, c
 inline int_v AliHLTTPCCASliceData::HitLinkUpData  ( const AliHLTTPCCARow &row, const uint_v &hitIndexes ) const
 {
   int_v r;
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    r[i] = row.fLinkUpData[(unsigned int)hitIndexes[i]];
-  }
+  CAGatherScatter::Gather( r, row.fLinkUpData, hitIndexes );
   return r;
 }
 
 inline int_v AliHLTTPCCASliceData::HitLinkDownData( const AliHLTTPCCARow &row, const uint_v &hitIndexes ) const
 {
   int_v r;
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    r[i] = row.fLinkDownData[(unsigned int)hitIndexes[i]];
-  }
+  CAGatherScatter::Gather( r, row.fLinkDownData, hitIndexes );
   return r;
 }
 
@@ -256,38 +269,18 @@ inline void AliHLTTPCCASliceData::SetHitLinkUpData( const AliHLTTPCCARow &row, i
 }
 
 inline void AliHLTTPCCASliceData::SetHitLinkUpData  ( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const int_v &value, const int_m &mask )
-{ 
-#ifdef VC_GATHER_SCATTER
-   value.scatter( row.fLinkUpData, hitIndexes, mask );
-#else
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !mask[i] ) continue;
-    row.fLinkUpData[(unsigned int)hitIndexes[i]] = value[i];
-  }
-#endif
+{
+  CAGatherScatter::Scatter( value, row.fLinkUpData, hitIndexes, mask );
 }
 
 inline void AliHLTTPCCASliceData::SetHitLinkDownData( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const int_v &value, const int_m &mask )
-{ 
-#ifdef VC_GATHER_SCATTER
-  value.scatter( row.fLinkDownData, hitIndexes, mask );
-#else
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !mask[i] ) continue;
-    row.fLinkDownData[(unsigned int)hitIndexes[i]] = value[i];
-  }
-#endif
+{
+  CAGatherScatter::Scatter( value, row.fLinkDownData, hitIndexes, mask );
 }
 
 inline void AliHLTTPCCASliceData::SetHitLinkUpData  ( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const int_v &value)
 {
-#ifdef VC_GATHER_SCATTER
-  value.scatter( row.fLinkUpData, hitIndexes);
-#else
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    row.fLinkUpData[(unsigned int)hitIndexes[i]] = value[i];
-  }
-#endif
+  CAGatherScatter::Scatter( value, row.fLinkUpData, hitIndexes );
 }
 
 inline void AliHLTTPCCASliceData::SetHitLinkUpData  ( const AliHLTTPCCARow &row, const unsigned int hitIndex, const int value )
@@ -298,53 +291,25 @@ inline void AliHLTTPCCASliceData::SetHitLinkUpData  ( const AliHLTTPCCARow &row,
 
 inline void AliHLTTPCCASliceData::SetHitLinkDownData( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const int_v &value)
 {
-#ifdef VC_GATHER_SCATTER
-  value.scatter( row.fLinkDownData, hitIndexes);
-#else
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    row.fLinkDownData[(unsigned int)hitIndexes[i]] = value[i];
-  }
-#endif
+  CAGatherScatter::Scatter( value, row.fLinkDownData, hitIndexes );
 }
 
 inline void AliHLTTPCCASliceData::SetUnusedHitLinkUpData( const AliHLTTPCCARow &row, const AliHLTTPCCARow &rowUp, const uint_v &hitIndexes, const int_v &value, const int_m &mask )
 {
-#ifndef VC_GATHER_SCATTER
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !mask[i] ) continue;
-    if( value[i] == -1 ) {
-	row.fLinkUpData[(unsigned int)row.fHitIndex[(unsigned int)hitIndexes[i]]] = -1;
-	continue;
-    }
-    row.fLinkUpData[(unsigned int)row.fHitIndex[(unsigned int)hitIndexes[i]]] = rowUp.fHitIndex[(unsigned int)value[i]];
-  }
-#else
-  const uint_v ind( row.fHitIndex, hitIndexes, mask );
-  uint_v val(rowUp.fHitIndex, static_cast<uint_v>(value), mask && value != -1);
-  int_v val2(val);
-  val2(value == -1) = value;
-  val2.scatter( row.fLinkUpData, ind, mask );
-#endif
+  uint_v ind;
+  CAGatherScatter::Gather( ind, row.fHitIndex, hitIndexes, mask );
+  int_v val( -1 );
+  CAGatherScatter::Gather( val, rowUp.fHitIndex, static_cast<uint_v>( value ), mask && value != -1 );
+  CAGatherScatter::Scatter( val, row.fLinkUpData, ind, mask );
 }
 
 inline void AliHLTTPCCASliceData::SetUnusedHitLinkDownData( const AliHLTTPCCARow &row, const AliHLTTPCCARow &rowDn, const uint_v &hitIndexes, const int_v &value, const int_m &mask )
 {
-#ifndef VC_GATHER_SCATTER
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !mask[i] ) continue;
-    if( value[i] == -1 ) {
-	row.fLinkDownData[(unsigned int)row.fHitIndex[(unsigned int)hitIndexes[i]]] = -1;
-	continue;
-    }
-    row.fLinkDownData[(unsigned int)row.fHitIndex[(unsigned int)hitIndexes[i]]] = rowDn.fHitIndex[(unsigned int)value[i]];
-  }
-#else
-  const uint_v ind( row.fHitIndex, hitIndexes, mask );
-  uint_v val(rowDn.fHitIndex, static_cast<uint_v>(value), mask && value != -1);
-  int_v val2(val);
-  val2(value == -1) = value;
-  val2.scatter( row.fLinkDownData, ind, mask );
-#endif
+  uint_v ind;
+  CAGatherScatter::Gather( ind, row.fHitIndex, hitIndexes, mask );
+  int_v val( -1 );
+  CAGatherScatter::Gather( val, rowDn.fHitIndex, static_cast<uint_v>( value ), mask && value != -1 );
+  CAGatherScatter::Scatter( val, row.fLinkDownData, ind, mask );
 }
 
 inline void AliHLTTPCCASliceData::SetUnusedHitLinkDataScalar( const AliHLTTPCCARow &row, const AliHLTTPCCARow &rowUp, const AliHLTTPCCARow &rowDn, unsigned int *hitIndexes )
@@ -390,41 +355,39 @@ inline const int *AliHLTTPCCASliceData::HitDataIsUsed( const AliHLTTPCCARow &row
   return row.fHitDataIsUsed;
 }
 
+inline int_v AliHLTTPCCASliceData::HitDataIsUsed( const AliHLTTPCCARow &row, const int_i &hitIndex ) const
+{
+  return int_v( &row.fHitDataIsUsed[hitIndex] );
+}
+
 inline void AliHLTTPCCASliceData::SetHitAsUsed( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const int_m &mask )
 {
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !mask[i] ) continue;
-    row.fHitDataIsUsed[(unsigned int)hitIndexes[i]] = 1;
-  }
+  CAGatherScatter::Scatter( int_v( 1 ), row.fHitDataIsUsed, hitIndexes, mask );
+  if ( !mask.isEmpty() ) row.fHasNewUsedHits = 1;
 }
 
-inline void AliHLTTPCCASliceData::SetHitAsUsed( const AliHLTTPCCARow &row, const unsigned int hitIndex )
+inline void AliHLTTPCCASliceData::SetHitAsUsed( const AliHLTTPCCARow &row, const unsigned int hitIndex, int isUsed )
 {
-  row.fHitDataIsUsed[hitIndex] = 1;
+  row.fHitDataIsUsed[hitIndex] = isUsed;
+  row.fHasNewUsedHits = 1;
 }
 
 inline void AliHLTTPCCASliceData::SetHitAsUsedInStartSegment( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const int_m &mask )
 {
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !mask[i] ) continue;
-    row.fHitDataIsUsed[(unsigned int)hitIndexes[i]] = 3;
-  }
+  CAGatherScatter::Scatter( int_v( 3 ), row.fHitDataIsUsed, hitIndexes, mask );
+  if ( !mask.isEmpty() ) row.fHasNewUsedHits = 1;
 }
 
 inline void AliHLTTPCCASliceData::SetHitAsUsedInTrackFit( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const int_m &mask )
 {
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !mask[i] ) continue;
-    row.fHitDataIsUsed[(unsigned int)hitIndexes[i]] = 2;
-  }
+  CAGatherScatter::Scatter( int_v( 2 ), row.fHitDataIsUsed, hitIndexes, mask );
+  if ( !mask.isEmpty() ) row.fHasNewUsedHits = 1;
 }
 
 inline void AliHLTTPCCASliceData::SetHitAsUsedInTrackExtend( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const int_m &mask )
 {
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !mask[i] ) continue;
-    row.fHitDataIsUsed[(unsigned int)hitIndexes[i]] = 3;
-  }
+  CAGatherScatter::Scatter( int_v( 3 ), row.fHitDataIsUsed, hitIndexes, mask );
+  if ( !mask.isEmpty() ) row.fHasNewUsedHits = 1;
 }
 
 inline void AliHLTTPCCASliceData::CleanUsedHits( int rowIndex, bool isFirst )
@@ -441,53 +404,45 @@ inline void AliHLTTPCCASliceData::CleanUsedHits( int rowIndex, bool isFirst )
     for ( unsigned int i = 0; i < numberOfHits; i += uint_v::Size ) {
       const uint_v hitIndexes = uint_v( Vc::IndexesFromZero ) + i;
       const int_m validHitsMask = (hitIndexes < numberOfHits);
-#ifdef VC_GATHER_SCATTER
-      hitIndexes.scatter( row.fHitIndex, hitIndexes, validHitsMask );
-#else
-      for( unsigned int j = 0; j < float_v::Size; j++ ) {
-	if( !validHitsMask[j] ) continue;
-	row.fHitIndex[(unsigned int)hitIndexes[j]] = hitIndexes[j];
-      }
-#endif
+      CAGatherScatter::Scatter( hitIndexes, row.fHitIndex, hitIndexes, validHitsMask );
     }
     row.fNUnusedHits = numberOfHits;
-  }
-  else {
-    std::vector<unsigned int> unusedHitIndex(numberOfHits+1,numberOfHits);
+    row.fHasNewUsedHits = 0;
+  }
+  else if ( row.fHasNewUsedHits ) {
+      // The unused hits are compacted in place: only the hits which were unused before are checked, and the
+      // bin borders are moved from the old to the new unused indices, so the rows without new used hits are skipped.
+    const unsigned int nOldUnusedHits = row.fNUnusedHits;
+    if ( fUnusedHitIndex.size() < nOldUnusedHits + 1 ) fUnusedHitIndex.resize( nOldUnusedHits + 1 );
+    unsigned int *unusedHitIndex = &fUnusedHitIndex[0]; // new unused index of the hits with the old unused index, or of the next unused hit
     unsigned int iUH = 0;
-    for ( unsigned int i = 0; i < numberOfHits; i += uint_v::Size ) {
-      const uint_v hitIndexes = uint_v( Vc::IndexesFromZero ) + i;
-      int_v hitDataTemp;
-      for( unsigned int ii = 0; ii < float_v::Size; ii++ ) {
-	hitDataTemp[ii] = HitDataIsUsed( row )[(unsigned int)hitIndexes[ii]];
+    for ( unsigned int i = 0; i < nOldUnusedHits; i += uint_v::Size ) {
+      const uint_v oldIndexes = uint_v( Vc::IndexesFromZero ) + i;
+      const int_m validHitsMask = oldIndexes < nOldUnusedHits;
+      int_v hitDataTemp( Vc::Zero );
+      for( unsigned int ii = 0; ii < int_v::Size; ii++ ) {
+        if( !validHitsMask[ii] ) continue;
+        hitDataTemp[ii] = row.fHitDataIsUsed[row.fHitIndex[i + ii]];
       }
-      const int_m validHitsMask = (hitIndexes < numberOfHits) && ( hitDataTemp == int_v( Vc::Zero ) );
-      for(unsigned int iV=0; iV<int_v::Size; iV++)
-      {
-        if(!validHitsMask[iV]) continue;
-        row.fUnusedHitPDataY[iUH] = row.fHitPDataY[(unsigned int)hitIndexes[iV]];
-        row.fUnusedHitPDataZ[iUH] = row.fHitPDataZ[(unsigned int)hitIndexes[iV]];
-        row.fHitIndex[iUH] = hitIndexes[iV];
-        unusedHitIndex[hitIndexes[iV]] = iUH;
+      const int_m unusedMask = validHitsMask && ( hitDataTemp == int_v( Vc::Zero ) );
+      for( unsigned int iV = 0; iV < int_v::Size; iV++ ) {
+        if( !validHitsMask[iV] ) continue;
+        unusedHitIndex[i + iV] = iUH;
+        if( !unusedMask[iV] ) continue;
+        row.fUnusedHitPDataY[iUH] = row.fUnusedHitPDataY[i + iV]; // iUH <= i + iV
+        row.fUnusedHitPDataZ[iUH] = row.fUnusedHitPDataZ[i + iV];
+        row.fHitIndex[iUH] = row.fHitIndex[i + iV];
         iUH++;
       }
     }
+    unusedHitIndex[nOldUnusedHits] = iUH;
     row.fNUnusedHits = iUH;
-    unusedHitIndex[numberOfHits] = iUH;
-    { // fill unfilled elements such so firstHitInBin will be correctly filled afterwards
-      unsigned int last = iUH;
-      for ( int i = int(unusedHitIndex.size()-2); i >= 0; i-- ) {
-        if ( unusedHitIndex[i] == numberOfHits )
-          unusedHitIndex[i] = last;
-        else
-          last = unusedHitIndex[i];
-      }
-    }
-  
+
     for ( unsigned int i = 0; i < NFirstHitInBin; i ++ ) {
-      assert( row.fFirstHitInBin[i] < numberOfHits + 1 );
-      row.fFirstUnusedHitInBin[i] = unusedHitIndex[row.fFirstHitInBin[i]];
+      assert( row.fFirstUnusedHitInBin[i] < nOldUnusedHits + 1 );
+      row.fFirstUnusedHitInBin[i] = unusedHitIndex[row.fFirstUnusedHitInBin[i]];
     }
+    row.fHasNewUsedHits = 0;
   }
 }
 
@@ -498,7 +453,8 @@ inline void AliHLTTPCCASliceData::CleanUsedHitsType( int rowIndex, int type )
   if( numberOfHits < 1 ) return;
 
   const unsigned int NFirstHitInBin = row.Grid().N() + row.Grid().Ny() + 3;
-    std::vector<unsigned int> unusedHitIndex(numberOfHits+1,numberOfHits);
+    std::vector<unsigned int> &unusedHitIndex = fUnusedHitIndex; // reuses the memory of CleanUsedHits
+    unusedHitIndex.assign( numberOfHits + 1, numberOfHits );
     unsigned int iUH = 0;
     for ( unsigned int i = 0; i < numberOfHits; i += uint_v::Size ) {
       const uint_v hitIndexes = uint_v( Vc::IndexesFromZero ) + i;
@@ -558,11 +514,7 @@ inline float_v AliHLTTPCCASliceData::HitPDataZ( const AliHLTTPCCARow &row, const
 inline float_v AliHLTTPCCASliceData::HitPDataY( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const float_m &mask ) const
 {
   float_v r;
-  for(unsigned int i=0; i<float_v::Size; i++)
-  {
-    if(!mask[i]) continue;
-    r[i] = row.fHitPDataY[(unsigned int)hitIndexes[i]];
-  }
+  CAGatherScatter::Gather( r, row.fHitPDataY, hitIndexes, mask );
   r *= float_v(1e-2);
   return r;
 }
@@ -570,11 +522,7 @@ inline float_v AliHLTTPCCASliceData::HitPDataY( const AliHLTTPCCARow &row, const
 inline float_v AliHLTTPCCASliceData::HitPDataZ( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const float_m &mask ) const
 {
   float_v r;
-  for(unsigned int i=0; i<float_v::Size; i++)
-  {
-    if(!mask[i]) continue;
-    r[i] = row.fHitPDataZ[(unsigned int)hitIndexes[i]];
-  }
+  CAGatherScatter::Gather( r, row.fHitPDataZ, hitIndexes, mask );
   r *= float_v(1e-2);
   return r;
 }
@@ -582,11 +530,7 @@ inline float_v AliHLTTPCCASliceData::HitPDataZ( const AliHLTTPCCARow &row, const
 inline float_v AliHLTTPCCASliceData::UnusedHitPDataY( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const float_m &mask ) const
 {
   float_v r;
-  for(unsigned int i=0; i<float_v::Size; i++)
-  {
-    if(!mask[i]) continue;
-    r[i] = row.fUnusedHitPDataY[(unsigned int)hitIndexes[i]];
-  }
+  CAGatherScatter::Gather( r, row.fUnusedHitPDataY, hitIndexes, mask );
   r *= float_v(1e-2);
   return r;
 }
@@ -594,11 +538,7 @@ inline float_v AliHLTTPCCASliceData::UnusedHitPDataY( const AliHLTTPCCARow &row,
 inline float_v AliHLTTPCCASliceData::UnusedHitPDataZ( const AliHLTTPCCARow &row, const uint_v &hitIndexes, const float_m &mask ) const
 {
   float_v r;
-  for(unsigned int i=0; i<float_v::Size; i++)
-  {
-    if(!mask[i]) continue;
-    r[i] = row.fUnusedHitPDataZ[(unsigned int)hitIndexes[i]];
-  }
+  CAGatherScatter::Gather( r, row.fUnusedHitPDataZ, hitIndexes, mask );
   r *= float_v(1e-2);
   return r;
 }
@@ -616,9 +556,7 @@ inline float AliHLTTPCCASliceData::UnusedHitPDataZ( const AliHLTTPCCARow &row, c
 inline uint_v AliHLTTPCCASliceData::FirstHitInBin( const AliHLTTPCCARow &row, uint_v binIndexes ) const
 {
   uint_v tmp;
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    tmp[i] = row.fFirstHitInBin[(unsigned int)binIndexes[i]];
-  }
+  CAGatherScatter::Gather( tmp, row.fFirstHitInBin, binIndexes );
   return tmp;
 }
 
@@ -640,9 +578,7 @@ inline unsigned int AliHLTTPCCASliceData::FirstUnusedHitInBin( const AliHLTTPCCA
 inline uint_v AliHLTTPCCASliceData::FirstUnusedHitInBin( const AliHLTTPCCARow &row, uint_v binIndexes ) const
 {
   uint_v tmp;
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    tmp[i] = row.fFirstUnusedHitInBin[(unsigned int)binIndexes[i]];
-  }
+  CAGatherScatter::Gather( tmp, row.fFirstUnusedHitInBin, binIndexes );
   return tmp;
 }
 
@@ -664,21 +600,11 @@ inline const AliHLTTPCCARow &AliHLTTPCCASliceData::Row( int rowIndex ) const
 inline uint_m AliHLTTPCCASliceData::TakeOwnHits( const AliHLTTPCCARow &row,
     const uint_v &hitIndex, const uint_m &mask, const uint_v &weights ) const
 {
-  int_v storedWeights;
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !mask[i] ) continue;
-    storedWeights[i] = row.fHitWeights[(unsigned int)hitIndex[i]];
-  }
+  uint_v storedWeights;
+  CAGatherScatter::Gather( storedWeights, row.fHitWeights, hitIndex, mask );
   const uint_m own = storedWeights == weights && mask;
   const uint_v takenMarker = std::numeric_limits<uint_v>::max();
-#ifdef VC_GATHER_SCATTER
-  takenMarker.scatter( row.fHitWeights, hitIndex, own );
-#else
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !own[i] ) continue;
-    row.fHitWeights[(unsigned int)hitIndex[i]] = takenMarker[i];
-  }
-#endif
+  CAGatherScatter::Scatter( takenMarker, row.fHitWeights, hitIndex, own );
   return own;
 }
 
@@ -694,18 +620,16 @@ inline void AliHLTTPCCASliceData::MaximizeHitWeight( const AliHLTTPCCARow &row,
     }
   }
 #endif
-  // XXX critical section if the TrackletConstructor gets multi-threaded
-  int_v oldWeight;
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !mask[i] ) continue;
-    oldWeight[i] = row.fHitWeights[(unsigned int)hitIndex[i]];
-  }
+  // not thread-safe, the parallel TrackletConstructor collects the weights and applies them after the wave
+  uint_v oldWeight;
+  CAGatherScatter::Gather( oldWeight, row.fHitWeights, hitIndex, mask );
   debugF() << "scatter HitWeigths " << weight << " to " << hitIndex << ( weight > oldWeight && mask ) << " old: " << oldWeight << std::endl;
-  int_m maskTemp = weight > oldWeight && mask;
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !maskTemp[i] ) continue;
-    row.fHitWeights[(unsigned int)hitIndex[i]] = weight[i];
-  }
+  CAGatherScatter::Scatter( weight, row.fHitWeights, hitIndex, weight > oldWeight && mask );
+}
+
+inline void AliHLTTPCCASliceData::MaximizeHitWeight( const AliHLTTPCCARow &row, unsigned int hitIndex, unsigned int weight )
+{
+  if ( weight > row.fHitWeights[hitIndex] ) row.fHitWeights[hitIndex] = weight;
 }
 
 inline uint_v AliHLTTPCCASliceData::HitWeight( const AliHLTTPCCARow &row, const uint_v &hitIndex, const uint_m &mask ) const
@@ -718,13 +642,9 @@ inline uint_v AliHLTTPCCASliceData::HitWeight( const AliHLTTPCCARow &row, const
     }
   }
 #endif
-//  return uint_v( row.fHitWeights, hitIndex, mask );
-  uint_v r;
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !mask[i] ) continue;
-    r[i] = row.fHitWeights[(unsigned int)hitIndex[i]];
-  }
-  return 0;
+  uint_v r( Vc::Zero );
+  CAGatherScatter::Gather( r, row.fHitWeights, hitIndex, mask );
+  return r;
 }
 
 
@@ -741,7 +661,6 @@ static inline float fastInvSqrt( float _x )
 
 inline void AliHLTTPCCASliceData::createGrid( AliHLTTPCCARow *row, const AliHLTTPCCAClusterData &data, const int clusterDataOffset, const int iRow )
 {
-  UNUSED_PARAM1( iRow );
   const float minCellSize = AliHLTTPCCAParameters::MinCellSize;
   if ( row->NHits() <= 0 ) { // no hits or invalid data
     // grid coordinates don't matter, since there are no hits
@@ -754,7 +673,7 @@ inline void AliHLTTPCCASliceData::createGrid( AliHLTTPCCARow *row, const AliHLTT
     return;
   }
 
-  const float norm = fastInvSqrt( AliHLTTPCCAParameters::GridCreationCoeff*row->fNHits ); // TODO parameter
+  const float norm = fastInvSqrt( fGridCreationCoeff[iRow]*row->fNHits );
 
   float yMin =  1.e3f;
   float yMax = -1.e3f;
@@ -35,112 +35,134 @@
 // depends on:
 // - linkUp/linkDown data for the rows above and below the row to process
 //
-// changes atomically:
-// - number of tracklets
-//
-// writes
+// FindCandidates runs in the pass of the NeighboursCleaner, run checks the
+// chains of the candidates afterwards and writes
 // - tracklet start-hit ids
-//
-// only when all rows are done, is NTracklets known
+// - number of tracklets
 //////////////////////////////////////////////////////////////////////////////
 
-void AliHLTTPCCAStartHitsFinder::run( AliHLTTPCCATracker &tracker, SliceData &data, int iter )
+int AliHLTTPCCAStartHitsFinder::FindCandidates( const SliceData &data, int rowIndex, AliHLTTPCCAStartHitId *candidates )
 {
+  const AliHLTTPCCARow &row = data.Row( rowIndex );
+  const int numberOfHits = row.NHits();
+  int nCandidates = 0;
+  for ( int hitIndex = 0; hitIndex < numberOfHits; hitIndex += int_v::Size ) {
+    const int_v hitIndexes = int_v( Vc::IndexesFromZero ) + hitIndex;
+    int_m validHitsMask = hitIndexes < numberOfHits;
+    validHitsMask &= data.HitDataIsUsed( row, hitIndex ) == int_v( Vc::Zero );
+
+      // hits that have a link up but none down == the start of a Track
+    validHitsMask &= ( data.HitLinkDownData( row, hitIndex ) < int_v( Vc::Zero ) ) && ( data.HitLinkUpData( row, hitIndex ) >= int_v( Vc::Zero ) );
+    for ( unsigned int i = 0; i < int_v::Size; i++ ) {
+      if ( !validHitsMask[i] ) continue;
+      candidates[nCandidates++].Set( rowIndex, hitIndex + i, 0 );
+    }
+  }
+  return nCandidates;
+}
 
+void AliHLTTPCCAStartHitsFinder::run( AliHLTTPCCATracker &tracker, SliceData &data, int iter, int nCandidates )
+{
   Vc::vector<AliHLTTPCCAStartHitId>& startHits = tracker.TrackletStartHits();
+  AliHLTTPCCAStartHitId *candidates = startHits.data() + *tracker.NTracklets();
 
-  //TODO parallel_for
   const int rowStep = AliHLTTPCCAParameters::RowStep;
-  const int lastRow = tracker.Param().NRows() - rowStep*2;
-  for ( int rowIndex = 0; rowIndex <= lastRow; ++rowIndex ) {
-    
-#ifdef USE_TBB
-    int hitsStartOffset = CAMath::AtomicAdd( tracker.NTracklets(), 0 );
-#else //USE_TBB
-    const int hitsStartOffset = *tracker.NTracklets(); // number of start hits from other jobs
-#endif //USE_TBB
-    //X   int_m leftMask( Vc::Zero );
+  const int minLength = tracker.Param().NeighboursChainMinLength( iter );
+  int startHitsCount = 0; // the kept start hits overwrite the candidates, which are already read
+  for ( int iCandidate = 0; iCandidate < nCandidates; ) {
+      // a vector of candidates of the same row
+    const int rowIndex = candidates[iCandidate].RowIndex();
     const AliHLTTPCCARow &row = data.Row( rowIndex );
-    int startHitsCount = 0;
+    int_v hitIndexes( Vc::Zero );
+    unsigned int nLanes = 0;
+    for ( ; nLanes < int_v::Size && iCandidate < nCandidates && candidates[iCandidate].RowIndex() == rowIndex; nLanes++ ) {
+      hitIndexes[nLanes] = candidates[iCandidate++].HitIndex();
+    }
+    int_m validHitsMask = int_v( Vc::IndexesFromZero ) < static_cast<int>( nLanes );
+      // the chains of the candidates of the lower rows can have used the hit
+    int_v isUsed( Vc::Zero );
+    CAGatherScatter::Gather( isUsed, data.HitDataIsUsed( row ), static_cast<uint_v>( hitIndexes ), validHitsMask );
+    validHitsMask &= isUsed == int_v( Vc::Zero );
+    int_v middleHitIndexes( -1 );
+    CAGatherScatter::Gather( middleHitIndexes, data.HitLinkUpData( row ), static_cast<uint_v>( hitIndexes ), validHitsMask );
 
+      // find the length
+    int iRow = rowIndex + 1*rowStep;
+    int nRows = 2;
+    int_v upperHitIndexes = middleHitIndexes;
+    for (;!validHitsMask.isEmpty() && nRows < minLength;) {
+      CAGatherScatter::Gather( upperHitIndexes, data.HitLinkUpData( data.Row( iRow ) ), static_cast<uint_v>( upperHitIndexes ), validHitsMask );
+      validHitsMask &= upperHitIndexes >= int_v( Vc::Zero );
+      nRows++;
+      iRow += rowStep;
+    }
+      // check if the length is enough
+    int_m goodChains = validHitsMask;
+    if ( goodChains.isEmpty() ) continue;
 
-    // look through all the hits and look for
-    const int numberOfHits = row.NHits();
-    for ( int hitIndex = 0; hitIndex < numberOfHits; hitIndex += int_v::Size ) {
-      const int_v hitIndexes = int_v( Vc::IndexesFromZero ) + hitIndex;
-      int_m validHitsMask = hitIndexes < numberOfHits;
-      int_v hitDataTemp;
-      for( unsigned int ii = 0; ii < float_v::Size; ii++ ) {
-      	hitDataTemp[ii] = data.HitDataIsUsed( row )[(unsigned int)hitIndexes[ii]];
-      }
-      validHitsMask &= ( hitDataTemp == int_v( Vc::Zero ) );
-      
-      // hits that have a link up but none down == the start of a Track
-      const int_v &middleHitIndexes = data.HitLinkUpData( row, hitIndex );
-      validHitsMask &= ( data.HitLinkDownData( row, hitIndex ) < int_v( Vc::Zero ) ) && ( middleHitIndexes >= int_v( Vc::Zero ) );
-      if ( !validHitsMask.isEmpty() ) { // start hit has been found
+      // set all hits in the chain as used
+    data.SetHitAsUsed( row, static_cast<uint_v>( hitIndexes ), goodChains );
 
-          // find the length
-        int iRow = rowIndex + 1*rowStep;
-        int nRows = 2;
-        int_v upperHitIndexes = middleHitIndexes;
-        for (;!validHitsMask.isEmpty() && nRows < AliHLTTPCCAParameters::NeighboursChainMinLength[iter];) {
-          for( unsigned int i = 0; i < float_v::Size; i++ ) {
-            if( !validHitsMask[i] ) continue;
-            upperHitIndexes[i] = data.HitLinkUpData( data.Row( iRow ) )[(unsigned int)upperHitIndexes[i]];
-          }
-          validHitsMask &= upperHitIndexes >= int_v( Vc::Zero );
-          nRows++;
-          iRow += rowStep;
-        }
-          // check if the length is enough
-        int_m goodChains = validHitsMask;
-        if ( !goodChains.isEmpty() ) { 
-            // set all hits in the chain as used
-          data.SetHitAsUsed( row, static_cast<uint_v>( hitIndexes ), goodChains );
+    int iRow2 = rowIndex + 1*rowStep;
+    uint_v nHits(Vc::Zero);
+    nHits(goodChains) = 2;
+    int_v upperHitIndexes2 = middleHitIndexes;
+    for (;!goodChains.isEmpty();) {
+      const AliHLTTPCCARow &curRow2 = data.Row( iRow2 );
+      data.SetHitAsUsed( curRow2, static_cast<uint_v>( upperHitIndexes2 ), goodChains );
+      CAGatherScatter::Gather( upperHitIndexes2, data.HitLinkUpData( curRow2 ), static_cast<uint_v>( upperHitIndexes2 ), goodChains );
+      goodChains &= upperHitIndexes2 >= int_v( Vc::Zero );
+      nHits(goodChains)++;
+      iRow2 += rowStep;
+    }
 
-          int iRow2 = rowIndex + 1*rowStep;
-          uint_v nHits(Vc::Zero);
-          nHits(goodChains) = 2;
-          AliHLTTPCCARow curRow2;
-          int_v upperHitIndexes2 = middleHitIndexes;
-          for (;!goodChains.isEmpty();) {
-            curRow2 = data.Row( iRow2 );
-
-            data.SetHitAsUsed( curRow2, static_cast<uint_v>( upperHitIndexes2 ), goodChains );
-            for( unsigned int i = 0; i < float_v::Size; i++ ) {
-              if( !goodChains[i] ) continue;
-              upperHitIndexes2[i] = data.HitLinkUpData( curRow2 )[(unsigned int)upperHitIndexes2[i]];
-            }
-            goodChains &= upperHitIndexes2 >= int_v( Vc::Zero );
-            nHits(goodChains)++;
-            iRow2 += rowStep;
-          }
-
-          for( unsigned int i = 0; i < int_v::Size; i++ ) {
-            if(!validHitsMask[i]) continue;
-            startHits[hitsStartOffset + startHitsCount++].Set( rowIndex, hitIndex + i, nHits[i] );
-          }
-
-          //   // check free space
-          // if ( ISUNLIKELY( startHitsCount >= kMaxStartHits ) ) { // TODO take in account stages kMax for one stage should be smaller
-          //   break;
-          // }
-        } // if good Chains
-        
-      } // if start hit
-    } // for iHit
+    for( unsigned int i = 0; i < int_v::Size; i++ ) {
+      if(!validHitsMask[i]) continue;
+      candidates[startHitsCount++].Set( rowIndex, hitIndexes[i], nHits[i] );
+    }
+  } // for iCandidate
 
 #ifdef USE_TBB
-    hitsStartOffset = CAMath::AtomicAdd( tracker.NTracklets(), startHitsCount ); // number of start hits from other jobs
+  CAMath::AtomicAdd( tracker.NTracklets(), startHitsCount );
 #else
-    *tracker.NTracklets() += startHitsCount;
+  *tracker.NTracklets() += startHitsCount;
 #endif //USE_TBB
-  } // for rowIndex
 
 #ifdef USE_TBB
   tbb::parallel_sort( startHits, startHits + *tracker.NTracklets() );
 #else //USE_TBB
   std::sort( &startHits[0], &startHits[0] + *tracker.NTracklets() );
 #endif //USE_TBB
+}
+
+  /// Order of the start hits in buckets of rowBucket start rows (the even and odd rows apart for RowStep 2, as
+  /// operator< of AliHLTTPCCAStartHitId does): inside a bucket the shorter chains go first as in operator<, so only the
+  /// grouping of the rows changes the packing and the lanes of a vector have chains of close lengths.
+  /// The start row and the hit break the ties, so the order is the same for std::sort and tbb::parallel_sort.
+class StartHitBucketLess
+{
+    const int fRowBucket;
+  public:
+    inline StartHitBucketLess( int rowBucket ): fRowBucket( rowBucket ) {}
+    inline bool operator()( const AliHLTTPCCAStartHitId &a, const AliHLTTPCCAStartHitId &b ) const {
+      const int rowStep = AliHLTTPCCAParameters::RowStep;
+      if ( rowStep == 2 && ( a.fRow & 1 ) != ( b.fRow & 1 ) ) return ( a.fRow & 1 ) < ( b.fRow & 1 );
+      const int aBucket = a.fRow / fRowBucket, bBucket = b.fRow / fRowBucket;
+      if ( aBucket != bBucket ) return aBucket < bBucket;
+      if ( a.fLength != b.fLength ) return a.fLength < b.fLength;
+      if ( a.fRow != b.fRow ) return a.fRow < b.fRow;
+      return a.fHit < b.fHit;
+    }
+};
+
+void AliHLTTPCCAStartHitsFinder::Order( AliHLTTPCCATracker &tracker, int firstHit, int endHit )
+{
+  const int rowBucket = tracker.StartHitsRowBucket();
+  if ( rowBucket <= 0 || endHit - firstHit < 2 ) return;
+  AliHLTTPCCAStartHitId *startHits = &tracker.TrackletStartHits()[0];
+#ifdef USE_TBB
+  tbb::parallel_sort( startHits + firstHit, startHits + endHit, StartHitBucketLess( rowBucket ) );
+#else //USE_TBB
+  std::sort( startHits + firstHit, startHits + endHit, StartHitBucketLess( rowBucket ) );
+#endif //USE_TBB
 }
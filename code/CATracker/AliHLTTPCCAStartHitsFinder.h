@@ -29,6 +29,7 @@
 
 class AliHLTTPCCATracker;
 class AliHLTTPCCASliceData;
+class AliHLTTPCCAStartHitId;
 
 /**
  * @class AliHLTTPCCAStartHitsFinder
@@ -36,7 +37,16 @@ class AliHLTTPCCASliceData;
  * find start hits for tracklets
  */
 struct AliHLTTPCCAStartHitsFinder {
-  static void run( AliHLTTPCCATracker &tracker, AliHLTTPCCASliceData &data, int iter );
+    /// candidates of the row: not used hits with a link up and without a link down, the links of the row must be
+    /// final. They are written with the length 0 to candidates, returns the number. Called by the NeighboursCleaner.
+  static int FindCandidates( const AliHLTTPCCASliceData &data, int rowIndex, AliHLTTPCCAStartHitId *candidates );
+    /// the nCandidates candidates of the rows in ascending order are at TrackletStartHits()[*NTracklets()]: the ones
+    /// with chains of at least NeighboursChainMinLength hits are kept as start hits and their chains are marked as used
+  static void run( AliHLTTPCCATracker &tracker, AliHLTTPCCASliceData &data, int iter, int nCandidates );
+
+    /// reorder the start hits [firstHit, endHit) for the packing into the vectors of the TrackletConstructor,
+    /// see AliHLTTPCCATracker::SetStartHitsRowBucket. Nothing is done if the bucket is 0.
+  static void Order( AliHLTTPCCATracker &tracker, int firstHit, int endHit );
 };
 
 #endif
@@ -0,0 +1,207 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "AliHLTTPCCAThreadPool.h"
+
+#include <algorithm>
+
+static thread_local const AliHLTTPCCAThreadPool *gInsideTask = 0; // pool of the executed task
+
+AliHLTTPCCAThreadPool::AliHLTTPCCAThreadPool( int nThreads )
+    : fNThreads( nThreads ), fThreads(), fQueues(), fTask( 0 ), fGeneration( 0 ), fNWorking( 0 ), fNRunning( 0 ), fNestedJobs(), fStop( 0 )
+{
+  if ( fNThreads <= 0 ) fNThreads = std::thread::hardware_concurrency();
+  if ( fNThreads <= 0 ) fNThreads = 1;
+  fQueues = std::vector<Queue>( fNThreads );
+  fThreads.reserve( fNThreads - 1 );
+  for ( int i = 1; i < fNThreads; i++ ) {
+    fThreads.push_back( std::thread( &AliHLTTPCCAThreadPool::Work, this, i ) );
+  }
+}
+
+AliHLTTPCCAThreadPool::~AliHLTTPCCAThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock( fMutex );
+    fStop = 1;
+  }
+  fStart.notify_all();
+  for ( unsigned int i = 0; i < fThreads.size(); i++ ) {
+    fThreads[i].join();
+  }
+}
+
+bool AliHLTTPCCAThreadPool::InsideTask()
+{
+  return gInsideTask != 0;
+}
+
+void AliHLTTPCCAThreadPool::ParallelFor( int nTasks, const std::function<void( int )> &task )
+{
+  if ( nTasks <= 0 ) return;
+  if ( fNThreads > 1 && nTasks > 1 && gInsideTask == this ) {
+    RunNested( nTasks, task );
+    return;
+  }
+  std::unique_lock<std::mutex> job( fJobMutex, std::defer_lock );
+  if ( fNThreads == 1 || nTasks == 1 || gInsideTask || !job.try_lock() ) {
+    for ( int i = 0; i < nTasks; i++ ) task( i );
+    return;
+  }
+
+    // neighbouring tasks go to different threads
+  for ( int i = 0; i < fNThreads; i++ ) {
+    fQueues[i].fTasks.clear();
+    fQueues[i].fFirst = 0;
+  }
+  for ( int i = 0; i < nTasks; i++ ) {
+    fQueues[i % fNThreads].fTasks.push_back( i );
+  }
+
+  {
+    std::lock_guard<std::mutex> lock( fMutex );
+    fTask = &task;
+    fNWorking = fNThreads - 1;
+    fGeneration++;
+  }
+  fStart.notify_all();
+
+  RunTasks( 0 );
+
+  std::unique_lock<std::mutex> lock( fMutex );
+  while ( fNWorking > 0 ) fDone.wait( lock );
+  fTask = 0;
+}
+
+void AliHLTTPCCAThreadPool::Work( int iThread )
+{
+  int generation = 0;
+  std::unique_lock<std::mutex> lock( fMutex );
+  while ( true ) {
+    while ( !fStop && fGeneration == generation ) fStart.wait( lock );
+    if ( fStop ) return;
+    generation = fGeneration;
+    lock.unlock();
+
+    RunTasks( iThread );
+
+    lock.lock();
+    if ( --fNWorking == 0 ) fDone.notify_all();
+  }
+}
+
+void AliHLTTPCCAThreadPool::RunTasks( int iThread )
+{
+  gInsideTask = this;
+  int iTask;
+  std::unique_lock<std::mutex> lock( fMutex, std::defer_lock );
+  while ( true ) {
+    if ( PopTask( iThread, iTask ) ) {
+      lock.lock();
+      fNRunning++;
+      lock.unlock();
+      ( *fTask )( iTask );
+      lock.lock();
+      if ( --fNRunning == 0 ) fNestedWork.notify_all();
+      lock.unlock();
+      continue;
+    }
+      // no tasks of the job are left, help the running ones with their nested jobs
+    lock.lock();
+    if ( RunNestedTask( lock ) ) {
+      lock.unlock();
+      continue;
+    }
+    if ( fNRunning == 0 ) break;
+    fNestedWork.wait( lock );
+    lock.unlock();
+  }
+  gInsideTask = 0;
+}
+
+void AliHLTTPCCAThreadPool::RunNested( int nTasks, const std::function<void( int )> &task )
+{
+  NestedJob job;
+  job.fTask = &task;
+  job.fNTasks = nTasks;
+  job.fNext = 0;
+  job.fNLeft = nTasks;
+
+  std::unique_lock<std::mutex> lock( fMutex );
+  fNestedJobs.push_back( &job );
+  fNestedWork.notify_all();
+  while ( job.fNext < nTasks ) {
+    const int iTask = TakeNestedTask( job );
+    lock.unlock();
+    task( iTask );
+    lock.lock();
+    job.fNLeft--;
+  }
+  while ( job.fNLeft > 0 ) fNestedWork.wait( lock ); // tasks taken by the other threads
+}
+
+bool AliHLTTPCCAThreadPool::RunNestedTask( std::unique_lock<std::mutex> &lock )
+{
+  if ( fNestedJobs.empty() ) return 0;
+  NestedJob &job = *fNestedJobs.back(); // the latest one, all of them have tasks left
+  const int iTask = TakeNestedTask( job );
+  lock.unlock();
+  ( *job.fTask )( iTask );
+  lock.lock();
+  if ( --job.fNLeft == 0 ) fNestedWork.notify_all();
+  return 1;
+}
+
+int AliHLTTPCCAThreadPool::TakeNestedTask( NestedJob &job )
+{
+  const int iTask = job.fNext++;
+  if ( job.fNext == job.fNTasks ) { // all tasks are taken
+    fNestedJobs.erase( std::find( fNestedJobs.begin(), fNestedJobs.end(), &job ) );
+  }
+  return iTask;
+}
+
+bool AliHLTTPCCAThreadPool::PopTask( int iThread, int &iTask )
+{
+    // own queue from the front
+  {
+    Queue &q = fQueues[iThread];
+    std::lock_guard<std::mutex> lock( q.fMutex );
+    if ( !q.Empty() ) {
+      iTask = q.fTasks[q.fFirst++];
+      return 1;
+    }
+  }
+    // steal from the back of the others
+  for ( int i = 1; i < fNThreads; i++ ) {
+    Queue &q = fQueues[( iThread + i ) % fNThreads];
+    std::lock_guard<std::mutex> lock( q.fMutex );
+    if ( !q.Empty() ) {
+      iTask = q.fTasks.back();
+      q.fTasks.pop_back();
+      return 1;
+    }
+  }
+  return 0;
+}
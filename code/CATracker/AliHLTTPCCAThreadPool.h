@@ -0,0 +1,109 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ALIHLTTPCCATHREADPOOL_H
+#define ALIHLTTPCCATHREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class AliHLTTPCCAThreadPool
+ *
+ * Persistent pool of worker threads, used by the tracker when it is built without TBB.
+ *
+ * The threads are created once and sleep between the jobs. ParallelFor() distributes the tasks
+ * over per-thread queues; a thread which has finished its own queue steals tasks from the end
+ * of the queues of the other threads. The calling thread works as thread 0.
+ *
+ * ParallelFor() called from a task of the pool starts a nested job: the calling thread works on it
+ * and the threads which have no tasks of the current job left join it, e.g. the rows of a busy slice
+ * are processed by the threads which have finished the other slices. Called while the pool is busy
+ * with a job of another thread, ParallelFor() runs the tasks serially in the calling thread.
+ */
+class AliHLTTPCCAThreadPool
+{
+  public:
+      /// nThreads is the total number of threads including the calling one, 0 means all hardware threads
+    explicit AliHLTTPCCAThreadPool( int nThreads = 0 );
+    ~AliHLTTPCCAThreadPool();
+
+    int NThreads() const { return fNThreads; }
+
+      /// run task(iTask) for iTask = 0..nTasks-1 and wait for all of them
+    void ParallelFor( int nTasks, const std::function<void( int )> &task );
+      /// the same for a functor, which is called by reference, so std::function doesn't copy it to the heap
+    template<typename Task> void ParallelFor( int nTasks, const Task &task ) { ParallelFor( nTasks, std::function<void( int )>( std::cref( task ) ) ); }
+
+      /// is the current thread executing a task of some pool
+    static bool InsideTask();
+
+  private:
+      /// tasks fTasks[fFirst..end), taken from both ends; the vector keeps its memory for the next jobs
+    struct Queue {
+      Queue(): fTasks(), fFirst( 0 ), fMutex() {}
+      bool Empty() const { return fFirst == static_cast<int>( fTasks.size() ); }
+      std::vector<int> fTasks;
+      int fFirst;
+      std::mutex fMutex;
+    };
+
+      /// job started from a task, lives on the stack of its ParallelFor
+    struct NestedJob {
+      const std::function<void( int )> *fTask;
+      int fNTasks;
+      int fNext;  // next task to be taken
+      int fNLeft; // tasks not finished yet
+    };
+
+    void Work( int iThread );      // loop of the worker thread
+    void RunTasks( int iThread );  // execute own, stolen and nested tasks until the job is done
+    bool PopTask( int iThread, int &iTask );
+    void RunNested( int nTasks, const std::function<void( int )> &task );
+    bool RunNestedTask( std::unique_lock<std::mutex> &lock ); // one task of any nested job, fMutex is locked
+    int TakeNestedTask( NestedJob &job ); // fMutex is locked, the job is removed from fNestedJobs with its last task
+
+    int fNThreads;                                  //* total number of threads, the caller included
+    std::vector<std::thread> fThreads;              //* worker threads
+    std::vector<Queue> fQueues;                     //* task queues, one per thread
+    const std::function<void( int )> *fTask;        //* current job
+    int fGeneration;                                //* number of the current job
+    int fNWorking;                                  //* workers still running the current job
+    int fNRunning;                                  //* tasks of the current job being executed, they can start nested jobs
+    std::vector<NestedJob*> fNestedJobs;            //* nested jobs with tasks to be taken
+    bool fStop;                                     //* workers have to exit
+    std::mutex fMutex;
+    std::mutex fJobMutex;                           //* owned by the thread which runs the current job
+    std::condition_variable fStart;
+    std::condition_variable fDone;
+    std::condition_variable fNestedWork;            //* a nested job is started, or finished, or fNRunning is 0
+
+    AliHLTTPCCAThreadPool( const AliHLTTPCCAThreadPool& );
+    AliHLTTPCCAThreadPool &operator=( const AliHLTTPCCAThreadPool& );
+};
+
+#endif
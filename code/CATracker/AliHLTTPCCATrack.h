@@ -36,24 +36,22 @@
  *
  * The class describes the [partially] reconstructed TPC track [candidate].
  * The class is dedicated for internal use by the AliHLTTPCCATracker algorithm.
+ * The hit ids are not stored in the track, they are kept contiguously in one buffer
+ * of the slice tracker, filled by AliHLTTPCCATrackletSelector.
  */
 class AliHLTTPCCATrack
 {
   friend class AliHLTTPCCATrackletSelector;
   public:
-    AliHLTTPCCATrack() : fNumberOfHits( 0 ) {}
+    AliHLTTPCCATrack() : fHitIds( 0 ), fNumberOfHits( 0 ) {}
     short NumberOfHits() const { return fNumberOfHits; }
     const AliHLTTPCCATrackParam &Param() const { return fParam; };
-    const AliHLTTPCCAHitId &HitId( int i ) const { return fHitIdArray[i]; }
+    const AliHLTTPCCAHitId &HitId( int i ) const { return fHitIds[i]; }
 
   private:
     AliHLTTPCCATrackParam fParam; // track parameters
-    AliHLTFixedArray<AliHLTTPCCAHitId, AliHLTArraySize<AliHLTTPCCAParameters::MaxNumberOfRows8> > fHitIdArray;
+    const AliHLTTPCCAHitId *fHitIds; // first hit id of the track in the buffer of the slice tracker
     short fNumberOfHits;      // number of hits in the track
-
-    // disallow copy
-    AliHLTTPCCATrack( const AliHLTTPCCATrack & );
-    AliHLTTPCCATrack &operator=( const AliHLTTPCCATrack & );
 };
 
 typedef AliHLTTPCCATrack Track;
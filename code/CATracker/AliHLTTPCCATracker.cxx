@@ -37,10 +37,16 @@
 #include "AliHLTTPCCASliceOutput.h"
 #include "AliHLTTPCCADataCompressor.h"
 #include "AliHLTTPCCAClusterData.h"
+#include "AliHLTTPCCAGridProfile.h"
+#include "AliHLTTPCCAThreadPool.h"
+#ifdef USE_TBB
+#include <tbb/parallel_for.h>
+#endif //USE_TBB
 
 #include "AliHLTTPCCATrackParam.h"
 
 #include <iostream>
+#include <algorithm>
 
 #ifdef HLTCA_INTERNAL_PERFORMANCE
 #include "AliHLTTPCCAPerformance.h"
@@ -53,6 +59,7 @@ AliHLTTPCCATracker::AliHLTTPCCATracker()
 #ifdef DO_TPCCATRACKER_EFF_PERFORMANCE
     fNOutTracks1( 0 ),
     fOutTracks1( 0 ),
+    fOutTracks1Capacity( 0 ),
 #endif //DO_TPCCATRACKER_EFF_PERFORMANCE
     fParam(),
     fClusterData( 0 ),
@@ -60,9 +67,26 @@ AliHLTTPCCATracker::AliHLTTPCCATracker()
     fHitMemorySize( 0 ),
     fTrackMemory( 0 ),
     fTrackMemorySize( 0 ),
+    fTrackMemoryCapacity( 0 ),
     fTrackletStartHits( 0 ),
     fNTracklets( 0 ),
+    fTrackletVectors(),
+    fNTrackletVectors( 0 ),
+    fTrackletRowHits(),
+    fTrackletWideRowHits(),
+    fTracks(),
+    fTrackHitIds(),
     fNTrackHits( 0 ),
+    fIsDenseNeighboursFinder( 0 ),
+    fNNeighbourTruncations( 0 ),
+    fIsRefillTrackletConstructor( 0 ),
+    fStartHitsRowBucket( 0 ),
+    fParallelTrackletVectors( 0 ),
+    fHitClaims(),
+    fArena(),
+    fNTrackletLaneSteps( 0 ),
+    fNTrackletActiveLaneSteps( 0 ),
+    fThreadPool( 0 ),
     fOutput( 0 )
 {
   // constructor
@@ -81,30 +105,58 @@ AliHLTTPCCATracker::~AliHLTTPCCATracker()
 
 
 // ----------------------------------------------------------------------------------
-void AliHLTTPCCATracker::Initialize( const AliHLTTPCCAParam &param )
+void AliHLTTPCCATracker::Initialize( const AliHLTTPCCAParam &param, const AliHLTTPCCAGridProfile *gridProfile )
 {
   // initialisation
   fParam = param;
   fParam.Update();
   fData.InitializeRows( fParam );
+  if ( gridProfile ) {
+    SetGridProfile( *gridProfile );
+  } else {
+    SetGridProfile( AliHLTTPCCAGridProfile() );
+  }
 
   StartEvent();
 }
 
+void AliHLTTPCCATracker::SetGridProfile( const AliHLTTPCCAGridProfile &gridProfile )
+{
+  for ( int iRow = 0; iRow < fParam.NRows(); iRow++ ) {
+    fData.SetGridCreationCoeff( iRow, gridProfile.Coeff( iRow ) );
+  }
+}
+
+void AliHLTTPCCATracker::AddGridStatistics( AliHLTTPCCAGridProfile *gridProfile ) const
+{
+  // the statistics of the rows are cleaned for the next event
+#ifdef TUNE_GRID
+  for ( int iRow = 0; iRow < fParam.NRows(); iRow++ ) {
+    const AliHLTTPCCARow &row = fData.Row( iRow );
+    gridProfile->AddStatistics( iRow, fData.GridCreationCoeff( iRow ), row.NAreaQueries(), row.NAreaHits(), row.NAreaZLines() );
+    row.ResetAreaStatistics();
+  }
+#else
+  UNUSED_PARAM1( gridProfile );
+#endif // TUNE_GRID
+}
+
 void AliHLTTPCCATracker::StartEvent()
 {
   // start new event and fresh the memory
 
   SetupCommonMemory();
   fNTrackHits = 0;
+  fNNeighbourTruncations = 0;
+  fNTrackletLaneSteps = 0;
+  fNTrackletActiveLaneSteps = 0;
 }
 
 void  AliHLTTPCCATracker::SetupCommonMemory()
 {
 //   if (fHitMemory) delete[] fHitMemory;
 //   fHitMemory = 0;
-  if (fTrackMemory) delete[] fTrackMemory;
-  fTrackMemory = 0;
+  // fTrackMemory is reused by the next event, see AllocateTrackMemory
 
   fData.Clear();
   fNTracklets = 0;
@@ -138,11 +190,71 @@ void AliHLTTPCCATracker::RecalculateTrackMemorySize( int MaxNTracks, int MaxNHit
   fTrackMemorySize += AliHLTTPCCASliceOutput::EstimateSize( MaxNTracks, MaxNHits );
 }
 
+void AliHLTTPCCATracker::AllocateTrackMemory()
+{
+  const int size = fTrackMemorySize + 1600; // TODO rid of 1600
+  if ( size <= fTrackMemoryCapacity ) return;
+  debugWO() << "AllocateTrackMemory: " << fTrackMemoryCapacity << " -> " << size << " bytes" << endl;
+  if (fTrackMemory) delete[] fTrackMemory;
+  fTrackMemory = new char[size];
+  fTrackMemoryCapacity = size;
+}
+
+void AliHLTTPCCATracker::ResizeTrackletVectors( int nVectors )
+{
+  if ( fTrackletVectors.Size() < nVectors ) fTrackletVectors.Resize( nVectors ); // grows to the maximal event
+  fNTrackletVectors = nVectors;
+  const int nRows = fParam.NRows();
+  const int nRowHits = nVectors * nRows * uint_v::Size;
+    // the 16 bit row hits can't keep the hit indices of a row with kInvalidRowHit hits or more
+  bool isWide = 0;
+  for ( int iRow = 0; iRow < nRows && !isWide; iRow++ ) {
+    isWide = ( fData.Row( iRow ).NHits() >= TrackletVector::kInvalidRowHit );
+  }
+  if ( isWide ) {
+    if ( fTrackletWideRowHits.Size() < nRowHits ) fTrackletWideRowHits.Resize( nRowHits );
+    std::fill( fTrackletWideRowHits.Data(), fTrackletWideRowHits.Data() + nRowHits, TrackletVector::kInvalidWideRowHit );
+  } else {
+    if ( fTrackletRowHits.Size() < nRowHits ) fTrackletRowHits.Resize( nRowHits );
+    std::fill( fTrackletRowHits.Data(), fTrackletRowHits.Data() + nRowHits, TrackletVector::kInvalidRowHit );
+  }
+  for ( int iV = 0; iV < nVectors; iV++ ) {
+    fTrackletVectors[iV] = TrackletVector(); // the lanes without a tracklet mustn't keep the hits of the previous event
+    if ( isWide ) {
+      fTrackletVectors[iV].SetRowHitsMemory( fTrackletWideRowHits.Data() + iV * nRows * uint_v::Size, nRows );
+    } else {
+      fTrackletVectors[iV].SetRowHitsMemory( fTrackletRowHits.Data() + iV * nRows * uint_v::Size, nRows );
+    }
+  }
+}
+
+void AliHLTTPCCATracker::ReserveWorkMemory( int MaxNTracklets, int MaxNHits )
+{
+  const int nVectors = ( MaxNTracklets + uint_v::Size - 1 ) / uint_v::Size;
+  const int nRowHits = nVectors * fParam.NRows() * uint_v::Size;
+  if ( fTrackletVectors.Size() < nVectors ) fTrackletVectors.Resize( nVectors );
+  if ( fTrackletRowHits.Size() < nRowHits ) fTrackletRowHits.Resize( nRowHits );
+  if ( fTrackHitIds.Size() < nRowHits ) fTrackHitIds.Resize( nRowHits ); // the TrackletSelector books a hit id per row of a lane
+  fTracks.reserve( MaxNTracklets );
+#ifdef V6
+  fSaveUpLinks.reserve( 2 * MaxNHits ); // two links per seed, a hit starts one seed at most
+#else
+  UNUSED_PARAM1( MaxNHits );
+#endif
+}
+
+void AliHLTTPCCATracker::ReserveOutputMemory( int MaxNTracks, int MaxNHits )
+{
+  RecalculateTrackMemorySize( MaxNTracks, MaxNHits );
+  AllocateTrackMemory();
+}
+
 void  AliHLTTPCCATracker::SetPointersTracks( int MaxNTracks, int MaxNHits )
 {
   debugWO() << "SetPointersTracks( " << MaxNTracks << ", " << MaxNHits << ")" << endl;
   assert( fTrackMemory );
   assert( fTrackMemorySize > 0 );
+  assert( fTrackMemorySize <= fTrackMemoryCapacity );
 
   // set all pointers to the tracks memory
 
@@ -174,6 +286,16 @@ void AliHLTTPCCATracker::ReadEvent( AliHLTTPCCAClusterData *clusterData )
   }
 }
 
+void AliHLTTPCCATracker::ParallelFor( int n, const std::function<void( int )> &task ) const
+{
+#ifdef USE_TBB
+  tbb::parallel_for( 0, n, task );
+#else
+  if ( fThreadPool ) fThreadPool->ParallelFor( n, task );
+  else for ( int i = 0; i < n; i++ ) task( i );
+#endif // USE_TBB
+}
+
 void AliHLTTPCCATracker::Reconstruct()
 {
 #ifdef USE_TBB
@@ -199,7 +321,7 @@ void AliHLTTPCCATracker::WriteOutput()
 
   debugWO() << "WriteOutput| "
     << fNumberOfTracks << " tracks found, "
-    << fTrackletVectors.Size() << " TrackletVectors, "
+    << fNTrackletVectors << " TrackletVectors, "
     << fNTrackHits << " track hits "
     << std::endl;
 
@@ -218,7 +340,7 @@ void AliHLTTPCCATracker::WriteOutput()
   TrSort* tr_sort_helper = new TrSort[fNumberOfTracks];
   for ( int trackIndex = 0; trackIndex < tracksSize; ++trackIndex ) {
     if( trackIndex >= fNumberOfTracks ) continue;
-    const Track &track = *fTracks[trackIndex];
+    const Track &track = fTracks[trackIndex];
     tr_sort_helper[trackIndex].nHits = track.NumberOfHits();
     tr_sort_helper[trackIndex].trId = trackIndex;
   }
@@ -227,7 +349,7 @@ void AliHLTTPCCATracker::WriteOutput()
   for ( int trackIndex = 0; trackIndex < tracksSize; ++trackIndex ) {
     // if (!fTracks[trackIndex]) continue;
 #ifndef TETA
-    const Track &track = *fTracks[trackIndex];
+    const Track &track = fTracks[trackIndex];
     const int numberOfHits = track.NumberOfHits();
 
     {
@@ -240,7 +362,7 @@ void AliHLTTPCCATracker::WriteOutput()
       fOutput->SetTrack( iTr, out );
     }
 #else
-    const Track &track = *fTracks[tr_sort_helper[trackIndex].trId];
+    const Track &track = fTracks[tr_sort_helper[trackIndex].trId];
     const int numberOfHits = track.NumberOfHits();
     sFirstClusterRef[nTrackV] = nStoredHits;
     sNClusters[nTrackV] = numberOfHits;
@@ -306,9 +428,6 @@ void AliHLTTPCCATracker::WriteOutput()
       fOutput->SetClusterUnpackedX( hitStoreIndex, hUnpackedX );
       ++hitStoreIndex;
     }
-#ifndef TETA
-    if (fTracks[trackIndex]) delete fTracks[trackIndex];
-#endif
   }
 #ifdef TETA
   _mm_free(sFirstClusterRef);
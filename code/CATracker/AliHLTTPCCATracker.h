@@ -39,12 +39,17 @@
 #include <cstdio>
 #include "AliHLTTPCCASliceDataVector.h"
 #include <vector>
+#include <functional>
 
 #include "AliHLTTPCCASliceOutput.h"
+#include "AliHLTTPCCAHitClaims.h"
+#include "AliHLTTPCCAArena.h"
 
 class AliHLTTPCCATrack;
 class AliHLTTPCCATrackParam;
+class AliHLTTPCCAGridProfile;
 class AliHLTTPCCAClusterData;
+class AliHLTTPCCAThreadPool;
 
 /**
  * @class AliHLTTPCCATracker
@@ -71,7 +76,50 @@ class AliHLTTPCCATracker
 
     ~AliHLTTPCCATracker();
 
-    void Initialize( const AliHLTTPCCAParam &param );
+    void Initialize( const AliHLTTPCCAParam &param, const AliHLTTPCCAGridProfile *gridProfile = 0 ); // default grid without the profile
+    void SetGridProfile( const AliHLTTPCCAGridProfile &gridProfile ); // used from the next event
+    void SetGridCreationCoeff( int iRow, float coeff ) { fData.SetGridCreationCoeff( iRow, coeff ); }
+    void AddGridStatistics( AliHLTTPCCAGridProfile *gridProfile ) const; // give the hit area statistics of the event to the tuning, TUNE_GRID only
+    void SetTuning( const AliHLTTPCCAParam::Tuning &tuning ) { fParam.SetTuning( tuning ); } // cuts of the iterations, see AliHLTTPCCAParam
+
+      /// NeighboursFinder kernel: the vector of hits iterates the hit areas together and takes at most
+      /// MaxNeighboursUp upper hits (default), or the dense one evaluates all candidate pairs of each hit
+    void SetDenseNeighboursFinder( bool b ) { fIsDenseNeighboursFinder = b; }
+    bool IsDenseNeighboursFinder() const { return fIsDenseNeighboursFinder; }
+      /// Hits of the last event with more than MaxNeighboursUp hits in the upper area
+    int NNeighbourTruncations() const { return fNNeighbourTruncations; }
+
+      /// TrackletConstructor: the lanes of the vector keep the tracklets of the vector until all of them are done (default),
+      /// or the lane of a done tracklet is refilled with the next tracklet which starts at the current row
+    void SetRefillTrackletConstructor( bool b ) { fIsRefillTrackletConstructor = b; }
+    bool IsRefillTrackletConstructor() const { return fIsRefillTrackletConstructor; }
+      /// Packing of the start hits into the vectors of the TrackletConstructor: 0 - in the order of the start rows (default),
+      /// n > 0 - in buckets of n start rows ordered by the chain length, see AliHLTTPCCAStartHitsFinder::Order
+    void SetStartHitsRowBucket( int n ) { fStartHitsRowBucket = n; }
+    int StartHitsRowBucket() const { return fStartHitsRowBucket; }
+      /// TrackletConstructor: 0 - the vectors of tracklets are constructed one after another (default), n > 0 - in waves of
+      /// n vectors running in parallel. The vectors of a wave don't see the hits used by each other, the used flags and weights
+      /// are applied after the wave in the order of the vectors, so the result doesn't depend on the threads, n = 1 is the serial one.
+      /// The refilled lanes are always serial.
+    void SetParallelTrackletVectors( int n ) { fParallelTrackletVectors = n; fHitClaims.resize( n > 0 ? n : 0 ); }
+    int ParallelTrackletVectors() const { return fParallelTrackletVectors; }
+      /// Lane utilisation of the TrackletConstructor in the last event: row steps of the vectors times the vector size
+      /// and the lanes among them which fit or extrapolate a tracklet
+    int NTrackletLaneSteps() const { return fNTrackletLaneSteps; }
+    int NTrackletActiveLaneSteps() const { return fNTrackletActiveLaneSteps; }
+    void AddTrackletLaneSteps( int nSteps, int nActive ) { fNTrackletLaneSteps += nSteps; fNTrackletActiveLaneSteps += nActive; }
+      /// claims of the vectors of a parallel wave, ParallelTrackletVectors() of them
+    AliHLTTPCCAHitClaims *TrackletHitClaims() { return &fHitClaims[0]; }
+      /// memory of the refilled TrackletConstructor, reset by each run
+    AliHLTTPCCAArena &Arena() { return fArena; }
+
+      /// Threads for the rows of the NeighboursFinder, the pool is not owned. The slices run as tasks of
+      /// the same pool, so the rows of a busy slice are taken by the threads which are done with their slices.
+      /// Without a pool (and without TBB) the rows are processed serially.
+    void SetThreadPool( AliHLTTPCCAThreadPool *pool ) { fThreadPool = pool; }
+    void ParallelFor( int n, const std::function<void( int )> &task ) const;
+      /// the functor is passed by reference, so std::function doesn't copy it to the heap
+    template<typename Task> void ParallelFor( int n, const Task &task ) const { ParallelFor( n, std::function<void( int )>( std::cref( task ) ) ); }
 
     void StartEvent();
 
@@ -88,6 +136,14 @@ class AliHLTTPCCATracker
     void SetPointersHits( int MaxNHits );
     void RecalculateTrackMemorySize( int MaxNTracks, int MaxNHits );
     void SetPointersTracks( int MaxNTracks, int MaxNHits );
+    void AllocateTrackMemory(); // grows fTrackMemory up to fTrackMemorySize if needed
+
+      /// Allocate the output memory for an event with up to MaxNTracks tracks and MaxNHits track hits,
+      /// so events which are not larger don't allocate any memory. The memory only grows.
+    void ReserveOutputMemory( int MaxNTracks, int MaxNHits );
+      /// Allocate the tracklet and seed memory for up to MaxNTracklets tracklets and MaxNHits hits, it only grows as well
+    void ReserveWorkMemory( int MaxNTracklets, int MaxNHits );
+    int OutputMemoryCapacity() const { return fTrackMemoryCapacity; }
 
     void WriteTracks( std::ostream &out ) ;
     void ReadTracks( std::istream &in );
@@ -110,7 +166,7 @@ class AliHLTTPCCATracker
     const Vc::vector<AliHLTTPCCAStartHitId>& TrackletStartHits() const { return fTrackletStartHits; }
 
     size_t NTracks() const { return fTracks.size(); }
-    const std::vector<AliHLTTPCCATrack *> &Tracks() const { return fTracks; }
+    const std::vector<AliHLTTPCCATrack> &Tracks() const { return fTracks; }
 
     const AliHLTTPCCASliceOutput * Output() const { return fOutput; }
     AliHLTTPCCASliceOutput * Output() { return fOutput; }
@@ -118,6 +174,7 @@ class AliHLTTPCCATracker
 //#ifdef DO_TPCCATRACKER_EFF_PERFORMANCE
     int fNOutTracks1; // number of tracks in fOutTracks array
     AliHLTTPCCAOutTrack *fOutTracks1; // output array of the reconstructed tracks
+    int fOutTracks1Capacity; // size of fOutTracks1, kept between events
 
     int NOutTracks1() const { return fNOutTracks1; }
     AliHLTTPCCAOutTrack *OutTracks1() const { return  fOutTracks1; }
@@ -128,6 +185,9 @@ class AliHLTTPCCATracker
 
   private:
     void SetupCommonMemory();
+      /// nVectors TrackletVectors without hits, their row hits take the rows of the slice in fTrackletRowHits,
+      /// or in fTrackletWideRowHits if a row has AliHLTTPCCATrackletVector::kInvalidRowHit (0xffff) hits or more
+    void ResizeTrackletVectors( int nVectors );
 
 #ifdef TETA
     void ConvertPTrackParamToVector( const AliHLTTPCCATrackParam *t0[uint_v::Size], AliHLTTPCCATrackParamVector &t, const int &nTracksV);
@@ -146,21 +206,40 @@ class AliHLTTPCCATracker
     char *fHitMemory; // event memory for hits
     int   fHitMemorySize; // size of the event memory [bytes]
 
-    char *fTrackMemory; // event memory for tracks
+    char *fTrackMemory; // event memory for tracks, kept between events
     int   fTrackMemorySize; // size of the event memory [bytes]
+    int   fTrackMemoryCapacity; // size of the allocated fTrackMemory [bytes]
 
 
     Vc::vector<AliHLTTPCCAStartHitId> fTrackletStartHits;   // start hits for the tracklets
 
     int fNTracklets;     // number of tracklets
-    AliHLTResizableArray<TrackletVector> fTrackletVectors; // tracklet data
+#ifdef V6
+    std::vector<hit_link> fSaveUpLinks; // 3-hit seeds saved by the NeighboursCleaner, kept between events
+#endif
+    AliHLTResizableArray<TrackletVector> fTrackletVectors; // tracklet data, grows to the maximal event
+    int fNTrackletVectors; // number of fTrackletVectors used in the current event, see ResizeTrackletVectors
+    AliHLTResizableArray<TrackletVector::RowHit> fTrackletRowHits; // row hits of fTrackletVectors, grows to the maximal event
+    AliHLTResizableArray<unsigned int> fTrackletWideRowHits; // the same with 32 bit hit indices, for the slices with big rows
 
     //
     int fNumberOfTracks;
-    std::vector<AliHLTTPCCATrack *> fTracks;  // reconstructed tracks
+    std::vector<AliHLTTPCCATrack> fTracks;  // reconstructed tracks, the memory is kept between events
+    AliHLTResizableArray<AliHLTTPCCAHitId> fTrackHitIds; // hit ids of fTracks, grows to the maximal event
 
     int fNTrackHits; // number of track hits
 
+    bool fIsDenseNeighboursFinder; // see SetDenseNeighboursFinder
+    int fNNeighbourTruncations; // see NNeighbourTruncations
+    bool fIsRefillTrackletConstructor; // see SetRefillTrackletConstructor
+    int fStartHitsRowBucket; // see SetStartHitsRowBucket
+    int fParallelTrackletVectors; // see SetParallelTrackletVectors
+    std::vector<AliHLTTPCCAHitClaims> fHitClaims; // one per vector of a wave, kept for the next waves and events
+    AliHLTTPCCAArena fArena; // see Arena
+    int fNTrackletLaneSteps; // see NTrackletLaneSteps
+    int fNTrackletActiveLaneSteps; // see NTrackletActiveLaneSteps
+    AliHLTTPCCAThreadPool *fThreadPool; // see SetThreadPool
+
     // output
 
     AliHLTTPCCASliceOutput *fOutput;
@@ -48,7 +48,7 @@ class AliHLTTPCCATracklet
       fParam( tv.Param(), i )
     {
       for ( int row = 0; row < AliHLTTPCCAParameters::MaxNumberOfRows8; ++row ) {
-        fRowHits[row] = tv.HitIndexAtRow( row )[i];
+        fRowHits[row] = ( row < tv.MaxNRows() ) ? static_cast<int>( tv.HitIndexAtRow( row, i ) ) : -1;
       }
     }
 
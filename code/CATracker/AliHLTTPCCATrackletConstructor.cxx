@@ -34,6 +34,7 @@
 #include "AliHLTArray.h"
 #include "debug.h"
 #include <iomanip>
+#include <algorithm>
 
 #include "AliHLTTPCCAHitArea.h"
 
@@ -93,6 +94,22 @@ struct AliHLTTPCCATrackletConstructor::TrackMemory {
     fIsFragile( Vc::Zero )
   {}
 
+    // copy the tracklet from the lane j of m into the lane i
+  void SetLane( int i, const TrackMemory &m, int j ) {
+    fStartRow[i] = m.fStartRow[j];
+    fEndRow[i] = m.fEndRow[j];
+    fFirstRow[i] = m.fFirstRow[j];
+    fLastRow[i] = m.fLastRow[j];
+    fCurrentHitIndex[i] = m.fCurrentHitIndex[j];
+    fStage[i] = m.fStage[j];
+    fNHits[i] = m.fNHits[j];
+    fRemainingGap[i] = m.fRemainingGap[j];
+    fLastY[i] = m.fLastY[j];
+    fLastZ[i] = m.fLastZ[j];
+    fIsFragile[i] = m.fIsFragile[j];
+    fParam.SetTrackParam( TrackParamVector( TrackParam( m.fParam, j ) ), static_cast<float_m>( int_v( Vc::IndexesFromZero ) == int_v( i ) ) );
+  }
+
   int_m IsInvalid() {
     return fNHits < 3 ||
            static_cast<int_m>( CAMath::Abs( fParam.SinPhi() ) > .999f  ||
@@ -122,16 +139,16 @@ struct AliHLTTPCCATrackletConstructor::TrackMemory {
 class InitTracklets
 {
   public:
-    InitTracklets( AliHLTTPCCATrackletConstructor::TrackMemory &_r, SliceData &data,
-        const Tracker &tracker,
+    InitTracklets( AliHLTTPCCATrackletConstructor::TrackMemory &_r, AliHLTTPCCATrackletConstructor &constructor,
         TrackletVector &trackletVector, const uint_v &_trackIndex, uint_m mask )
-      : r( _r ), fData( data ), fTracker( tracker ),
+      : r( _r ), fConstructor( constructor ), fData( constructor.fData ), fTracker( constructor.fTracker ),
       fTrackletVector( trackletVector ), trackIndex( _trackIndex ), tMask(mask) {}
 
     void operator()( int rowIndex );
 
   private:
     AliHLTTPCCATrackletConstructor::TrackMemory &r;
+    AliHLTTPCCATrackletConstructor &fConstructor; // marks the used hits
     SliceData &fData;
     const Tracker &fTracker;
     TrackletVector &fTrackletVector;
@@ -163,10 +180,7 @@ void AliHLTTPCCATrackletConstructor::FitTracklet( TrackMemory &r, const int rowI
   const uint_v oldHitIndex = static_cast<uint_v>( r.fCurrentHitIndex );
 
   int_v isUsed;
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !active[i] ) continue;
-    isUsed[i] = fData.HitDataIsUsed( row )[(unsigned int)oldHitIndex[i]];
-  }
+  CAGatherScatter::Gather( isUsed, fData.HitDataIsUsed( row ), oldHitIndex, active );
   const int_m fitMask = active && ( (isUsed != int_v(2)) && (isUsed != int_v(3)) ); // mask to add a new hit. // don't take hits from other tracks. In order to reduce calculations.
 
   const float_v x = fData.RowX( rowIndex ); // convert to float_v once now
@@ -203,22 +217,15 @@ void AliHLTTPCCATrackletConstructor::FitTracklet( TrackMemory &r, const int rowI
   {
     fTracker.GetErrors2( rowIndex, r.fParam, &err2Y, &err2Z );
     const int_m hitAdded = static_cast<int_m>( r.fParam.Filter( activeF, y, z, err2Y, err2Z, .99f ) );
-    trackletVector.SetRowHits( rowIndex, trackIndex, static_cast<uint_v>(r.fCurrentHitIndex), hitAdded );
+    SetRowHits( trackletVector, rowIndex, trackIndex, static_cast<uint_v>(r.fCurrentHitIndex), hitAdded );
     ++r.fNHits( static_cast<uint_m>(hitAdded) );
     r.fEndRow( hitAdded ) = rowIndex;
       
     ASSERT( ( (row.NHits() > static_cast<uint_v>(oldHitIndex) ) && hitAdded ) == hitAdded,
       row.NHits() << static_cast<uint_v>(oldHitIndex) << hitAdded );
-    fData.SetHitAsUsedInTrackFit( row, static_cast<uint_v>( oldHitIndex ), hitAdded );
-  }
-#ifdef VC_GATHER_SCATTER
-  r.fCurrentHitIndex.gather( fData.HitLinkUpData( row ), static_cast<uint_v>( oldHitIndex ), active ); // set to next linked hit
-#else
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !active[i] ) continue;
-    r.fCurrentHitIndex[i] = fData.HitLinkUpData( row )[(unsigned int)oldHitIndex[i]];
+    SetHitsAsUsed( rowIndex, static_cast<uint_v>( oldHitIndex ), 2, hitAdded );
   }
-#endif
+  CAGatherScatter::Gather( r.fCurrentHitIndex, fData.HitLinkUpData( row ), static_cast<uint_v>( oldHitIndex ), active ); // set to next linked hit
 
   const int_m fittingDone = r.fCurrentHitIndex < 0 && active;
   debugF() << "fittingDone = " << fittingDone << endl;
@@ -385,9 +392,9 @@ int_m AliHLTTPCCATrackletConstructor::ExtrapolateTracklet( TrackMemory &r, const
 
   ASSERT( ( (row.NHits() > r.fCurrentHitIndex) && active) == active,
           row.NHits() << r.fCurrentHitIndex << active );
-  fData.SetHitAsUsedInTrackExtend( row, static_cast<uint_v>(r.fCurrentHitIndex), active );
+  SetHitsAsUsed( rowIndex, static_cast<uint_v>(r.fCurrentHitIndex), 3, active );
   
-  trackletVector.SetRowHits( rowIndex, trackIndex,  static_cast<uint_v>(r.fCurrentHitIndex), active );
+  SetRowHits( trackletVector, rowIndex, trackIndex,  static_cast<uint_v>(r.fCurrentHitIndex), active );
   ++r.fNHits( static_cast<uint_m>(active) );
   r.fRemainingGap( active ) = AliHLTTPCCAParameters::MaximumExtrapolationRowGap;
   ++r.fStage( r.fRemainingGap == 0 && mask ); // go to WaitingForExtrapolateDown or DoneStage if the gap got too big
@@ -431,10 +438,7 @@ int_m AliHLTTPCCATrackletConstructor::ExtendTracklet( TrackMemory &r, const int
   const float_v x = fData.RowX( rowIndex );
 //  const int_v isUsed(fData.HitDataIsUsed( row ), static_cast<uint_v>(oldHitIndex), activeFitMask); // Here it takes a lot of time...
   int_v isUsed;
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !activeFitMask[i] ) continue;
-    isUsed[i] = fData.HitDataIsUsed( row )[(unsigned int)oldHitIndex[i]];
-  }
+  CAGatherScatter::Gather( isUsed, fData.HitDataIsUsed( row ), oldHitIndex, activeFitMask );
   const int_m fitMask = activeFitMask && (isUsed != int_v(2)) && (isUsed != int_v(3)) && (r.fCurrentHitIndex >= 0); // mask to add a new hit. // don't take hits from other tracks. In order to reduce calculations.
 
   float_m activeFitMaskF( static_cast<float_m>( fitMask ) ); // create float_v mask
@@ -475,14 +479,7 @@ int_m AliHLTTPCCATrackletConstructor::ExtendTracklet( TrackMemory &r, const int
 #endif
     
       // end with chain fit
-#ifdef VC_GATHER_SCATTER
-    r.fCurrentHitIndex.gather( fData.HitLinkUpData( row ), static_cast<uint_v>( oldHitIndex ), activeFitMask ); // prepare new hit for fit // TODO 2 dir??
-#else
-    for( unsigned int i = 0; i < float_v::Size; i++ ) {
-      if( !activeFitMask[i] ) continue;
-      r.fCurrentHitIndex[i] = fData.HitLinkUpData( row )[(unsigned int)oldHitIndex[i]];
-    }
-#endif
+    CAGatherScatter::Gather( r.fCurrentHitIndex, fData.HitLinkUpData( row ), static_cast<uint_v>( oldHitIndex ), activeFitMask ); // prepare new hit for fit // TODO 2 dir??
     
     const int_m fittingDone = r.fCurrentHitIndex < 0 && activeFitMask;
     ++r.fStage( fittingDone ); // goes to ExtrapolateUp if fitting is done (no other hit linked)
@@ -546,21 +543,14 @@ int_m AliHLTTPCCATrackletConstructor::ExtendTracklet( TrackMemory &r, const int
 
   
     // -- SAVE THE NEXT HIT --
-  trackletVector.SetRowHits( rowIndex, trackIndex,  static_cast<uint_v>(r.fCurrentHitIndex), activeExtraMask || hitAdded );
-#ifdef VC_GATHER_SCATTER
-  r.fCurrentHitIndex.gather( fData.HitLinkUpData( row ), static_cast<uint_v>( oldHitIndex ), uint_m(activeFitMask) ); // prepare new hit for fit
-#else
-  for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    if( !activeFitMask[i] ) continue;
-    r.fCurrentHitIndex[i] = fData.HitLinkUpData( row )[(unsigned int)oldHitIndex[i]];
-  }
-#endif
+  SetRowHits( trackletVector, rowIndex, trackIndex,  static_cast<uint_v>(r.fCurrentHitIndex), activeExtraMask || hitAdded );
+  CAGatherScatter::Gather( r.fCurrentHitIndex, fData.HitLinkUpData( row ), static_cast<uint_v>( oldHitIndex ), uint_m(activeFitMask) ); // prepare new hit for fit
   
 
   ASSERT( ( (row.NHits() > r.fCurrentHitIndex) && activeExtraMask) == activeExtraMask,
           row.NHits() << r.fCurrentHitIndex << activeExtraMask );
-  fData.SetHitAsUsedInTrackExtend( row, static_cast<uint_v>( r.fCurrentHitIndex ), activeExtraMask ); // TODO 1 function
-  fData.SetHitAsUsedInTrackFit(    row, static_cast<uint_v>( oldHitIndex ),        hitAdded );
+  SetHitsAsUsed( rowIndex, static_cast<uint_v>( r.fCurrentHitIndex ), 3, activeExtraMask ); // TODO 1 function
+  SetHitsAsUsed( rowIndex, static_cast<uint_v>( oldHitIndex ),        2, hitAdded );
   
   ++r.fNHits( static_cast<uint_m>( activeExtraMask || hitAdded ) );
   r.fRemainingGap( activeExtraMask ) = AliHLTTPCCAParameters::MaximumExtrapolationRowGap;
@@ -627,10 +617,10 @@ void AliHLTTPCCATrackletConstructor::CreateStartSegmentV( const int rowIndex, co
 
   std::vector<int> hitsDn, hitsMid, hitsUp;
 
-  static const float kAreaSizeY = AliHLTTPCCAParameters::NeighbourAreaSizeTgY[iter];
-  static const float kAreaSizeZ = AliHLTTPCCAParameters::NeighbourAreaSizeTgZ[iter];
+  const float kAreaSizeY = fTracker.Param().NeighbourAreaSizeTgY( iter );
+  const float kAreaSizeZ = fTracker.Param().NeighbourAreaSizeTgZ( iter );
   static const int kMaxN = 20; // TODO minimaze
-  const float chi2Cut = AliHLTTPCCAParameters::NeighbourChiCut[iter]*AliHLTTPCCAParameters::NeighbourChiCut[iter] * 4.f * ( UpDx * UpDx + DnDx * DnDx );
+  const float chi2Cut = fTracker.Param().NeighbourChiCut( iter )*fTracker.Param().NeighbourChiCut( iter ) * 4.f * ( UpDx * UpDx + DnDx * DnDx );
 
   typedef HitArea::NeighbourData NeighbourData;
   for ( unsigned int hitIndex = 0; hitIndex < numberOfHits; hitIndex += int_v::Size ) {
@@ -792,360 +782,499 @@ void AliHLTTPCCATrackletConstructor::CreateStartSegmentV( const int rowIndex, co
 }
 
 
-#ifdef MAIN_DRAW
-#include "AliHLTTPCCADisplay.h"
-#include "TApplication.h"
-#endif //DRAW
+/**
+ * Start hits and initial parameters of the tracklets, lanes which are not active get the NullStage
+ */
+void AliHLTTPCCATrackletConstructor::InitTrackMemory( TrackMemory &r, const uint_v &trackIndex, const uint_m &active )
+{
+  r.fStage( !active ) = NullStage;
 
-#ifdef V7
-void AliHLTTPCCATrackletConstructor::run( unsigned int firstRow, unsigned int &tracksSaved, unsigned int i_it )
+    // if rowStep = 2 TrackletStartHits need to be sorted such that all even start rows come first. The odd start rows - last.
+  uint_v length(Vc::Zero);
+  for( unsigned int i = 0; i < float_v::Size; i++ ) {
+    if( !active[i] ) continue;
+    r.fStartRow[i] = fTracker.TrackletStartHit((unsigned int)trackIndex[i]).fRow;
+    r.fCurrentHitIndex[i] = fTracker.TrackletStartHit((unsigned int)trackIndex[i]).fHit;
+    length[i] = fTracker.TrackletStartHit((unsigned int)trackIndex[i]).fLength;
+  }
+  r.fEndRow = static_cast<uint_v>( r.fStartRow );
+  r.fLastRow = static_cast<uint_v>( r.fStartRow );
+//    r.fStartRow( !active ) = std::numeric_limits<int_v>::max();
+  r.fStartRow( !active ) = std::numeric_limits<int>::max();
+  r.fFirstRow = r.fStartRow;
+
+#ifdef EXTEND_ALL_TRAKCS
+r.fIsFragile = uint_m(true);
 #else
-void AliHLTTPCCATrackletConstructor::run( unsigned int firstRow, unsigned int &tracksSaved )
+  const uint_v MaxNHitsForFragileTracklet(6);
+  r.fIsFragile = (length < MaxNHitsForFragileTracklet);
 #endif
+  const float_v zero( Vc::Zero );
+  const float_v one( Vc::One );
+  r.fParam.SetSinPhi(  zero );
+  r.fParam.SetDzDs(    zero );
+  r.fParam.SetQPt(     zero );
+  r.fParam.SetSignCosPhi( one );
+  r.fParam.SetChi2(    zero );
+  r.fParam.SetNDF(       -3 );
+  r.fParam.SetCov(  0,  one );
+  r.fParam.SetCov(  1, zero );
+  r.fParam.SetCov(  2,  one );
+  r.fParam.SetCov(  3, zero );
+  r.fParam.SetCov(  4, zero );
+  r.fParam.SetCov(  5,  one );
+  r.fParam.SetCov(  6, zero );
+  r.fParam.SetCov(  7, zero );
+  r.fParam.SetCov(  8, zero );
+  r.fParam.SetCov(  9,  one );
+  r.fParam.SetCov( 10, zero );
+  r.fParam.SetCov( 11, zero );
+  r.fParam.SetCov( 12, zero );
+  r.fParam.SetCov( 13, zero );
+  r.fParam.SetCov( 14, 10.f );
+}
+
+void AliHLTTPCCATrackletConstructor::PrepareExtrapolateDown( TrackMemory &r )
 {
+  r.fRemainingGap = AliHLTTPCCAParameters::MaximumExtrapolationRowGap; // allow full gaps again
+  ++r.fStage( r.fStage == ExtrapolateUp ); // FitLinkedHits/ExtrapolateUp went so high that no gap put the tracklet into WaitingForExtrapolateDown
+  const int_m ready = r.fStage == WaitingForExtrapolateDown;
+  debugF() << "ready to extrapolate downwards: " << ready << endl;
+  ++r.fStage( ready ); // the wait is over
+
+  if(1){ // set track parameters to x of end row of the fitting stage
+    //const float_v x( fData.RowX(), float_v::IndexType( r.fEndRow ) );
+    const float_v x( fData.RowX(), float_v::IndexType( r.fStartRow ), static_cast<float_m>(ready));
+    debugF() << x << float_v::IndexType( r.fEndRow ) << float_v( fData.RowX(), float_v::IndexType( Vc::IndexesFromZero ) ) << endl;
+    assert( ( x == 0 && static_cast<float_m>( ready ) ).isEmpty() );
+    const int_m transported = static_cast<int_m>( r.fParam.TransportToX(
+                                                        x, fTracker.Param().cBz(), .999f, static_cast<float_m>( ready ) ) );
+    ++r.fStage( !transported ); // all those where transportation failed go to DoneStage
+  }
+}
 
-#ifdef V7
-  if( i_it >= 0 ) {
-    fData.CleanUsedHits( 1+firstRow, false );
-    fData.CleanUsedHits( 2+firstRow, false );
-    fData.CleanUsedHits( 3+firstRow, false );
-    CreateStartSegmentV( 2+firstRow, i_it );
+int AliHLTTPCCATrackletConstructor::StoreTracklets( TrackMemory &r, unsigned int trackIteration, const uint_m &active, bool markUsed )
+{
+  int nStored = 0;
+  float_m trackletOkF( r.fNHits >= uint_v(AliHLTTPCCAParameters::MinimumHitsForTracklet) );
+  for ( int i = 0; i < 15; ++i ) {
+    trackletOkF &= CAMath::Finite( r.fParam.Cov()[i] );
+  }
+  for ( int i = 0; i < 5; ++i ) {
+    trackletOkF &= CAMath::Finite( r.fParam.Par()[i] );
+  }
+
+    // 80 is row 0; if X is that small this track is garbage.
+    // XXX does this happen at all? If yes, under what conditions?
+  assert( ( r.fParam.X() > 50.f && trackletOkF ) == trackletOkF );
+  trackletOkF &= r.fParam.X() > 50.f // TODO: read from file!!!
+
+
+      // there must be errors and they must be positive or this track is garbage
+    && r.fParam.Err2QPt()    > float_v(Vc::Zero);
+  trackletOkF &= r.fParam.Err2Y()      > float_v(Vc::Zero) && r.fParam.Err2Z()      > float_v(Vc::Zero);
+  trackletOkF &= r.fParam.Err2SinPhi() > float_v(Vc::Zero) && r.fParam.Err2DzDs()   > float_v(Vc::Zero);
+//    trackletOkF &= ( r.fParam.Chi2()/static_cast<float_v>(r.fParam.NDF()) < 25.f ); // TODO
+  debugF() << r.fParam << "-> trackletOk: " << trackletOkF << endl;
+
+  const int_m trackletOk( trackletOkF );
+  r.fNHits.setZero( !trackletOk );
+
+    //////////////////////////////////////////////////////////////////////
+    //
+    //////////////////////////////////////////////////////////////////////
+  TrackletVector &tracklet = fTrackletVectors[trackIteration];
+  tracklet.SetNHits( r.fNHits, active );
+
+  if ( !( r.fNHits > 0 ).isEmpty() ) {
 #ifdef MAIN_DRAW
-    if ( AliHLTTPCCADisplay::Instance().DrawType() == 1 )
-    {
-      AliHLTTPCCADisplay &disp = AliHLTTPCCADisplay::Instance();
-      disp.ClearView();
-      disp.SetSliceView();
-      disp.SetCurrentSlice( &fTracker );
-      disp.DrawSlice( &fTracker, 0 );
-      disp.DrawSliceHits(1, 0.5);
-      disp.DrawSliceLinks(-1,-1,1);
-      AliHLTTPCCADisplay::Instance().SaveCanvasToFile("NFinderTestXYZ.pdf");
-      disp.Ask();
+    if ( AliHLTTPCCADisplay::Instance().DrawType() == 10 ) {
+      for(int ii=0; ii<int_v::Size; ii++)
+      {
+        if(!(r.fStage[ii] < DoneStage)) continue;
+//         foreach_bit( int ii, r.fStage < DoneStage ) {
+        TrackParam t( r.fParam, ii );
+        AliHLTTPCCADisplay::Instance().ClearView();
+        AliHLTTPCCADisplay::Instance().DrawSlice( &fTracker, 0 );
+        AliHLTTPCCADisplay::Instance().DrawSliceHits();
+        AliHLTTPCCADisplay::Instance().DrawTrackParam( t, 2 );
+//          AliHLTTPCCADisplay::Instance().Ask();
+      }
+      AliHLTTPCCADisplay::Instance().Ask();
     }
 #endif
+      // start and end rows of the tracklet
+    tracklet.SetFirstRow( static_cast<uint_v>( r.fFirstRow ), active );
+    tracklet.SetLastRow( r.fLastRow, active );
+
+      ///mvz start 25.01.2010
+    const float_m MinQPt = CAMath::Abs(r.fParam.QPt()) < AliHLTTPCCAParameters::MinimumQPt;
+    float_v NewQPt = r.fParam.QPt();
+    NewQPt(MinQPt) = AliHLTTPCCAParameters::MinimumQPt;
+    r.fParam.SetQPt(NewQPt);
+      //      r.fParam.SetQPt( CAMath::Max( AliHLTTPCCAParameters::MinimumQPt, r.fParam.QPt() ) );
+      ///mvz end 25.01.2010
+    tracklet.SetParam( r.fParam, (float_m)active );
+
+    for( unsigned int iV = 0; iV < float_v::Size; iV++ ) {
+	if( active[iV] ) nStored++;
+    }
+
+    debugTS() << r.fFirstRow << r.fLastRow << endl;
+    debugTS() << "set hit weigths from row " << r.fFirstRow.min() << " until row " << r.fLastRow.max() << endl;
+//      const uint_v &weight = SliceData::CalculateHitWeight( r.fNHits, trackIndex );
+      // for all rows where we have a hit let the fTracker know what weight our hits have
+    for ( unsigned int rowIndex = r.fFirstRow.min(); rowIndex <= r.fLastRow.max(); ++rowIndex ) {
+      const uint_v &hitIndex = tracklet.HitIndexAtRow( rowIndex );
+      MaximizeHitWeight( rowIndex, hitIndex, r.fNHits );
+      if( markUsed ) {
+        SetHitsAsUsed( rowIndex, hitIndex, 1, int_m(hitIndex<fData.Row( rowIndex ).NHits()) );
+      }
+    }
   }
-#else
-  UNUSED_PARAM1(firstRow);
-#endif
-  //
-  assert( *fTracker.NTracklets() < 32768 );
-  const unsigned int nTracks = *fTracker.NTracklets();
+  return nStored;
+}
 
-#ifndef NO_NTRACKLET_FIX
-  int newTr = 0;
-#endif
+void AliHLTTPCCATrackletConstructor::SetRowHits( TrackletVector &trackletVector, int rowIndex, const uint_v &trackIndex,
+                                                 const uint_v &hitIndex, const int_m &mask )
+{
+  if ( !fTracker.IsRefillTrackletConstructor() ) {
+    trackletVector.SetRowHits( rowIndex, trackIndex, hitIndex, mask );
+    return;
+  }
+    // the lanes belong to different tracklet vectors
+  for ( unsigned int i = 0; i < uint_v::Size; ++i ) {
+    if ( !mask[i] ) continue;
+    fTrackletVectors[trackIndex[i] / uint_v::Size].SetRowHit( rowIndex, trackIndex[i] % uint_v::Size, hitIndex[i] );
+  }
+}
 
-  unsigned int tracksSavedV = tracksSaved / float_v::Size;
-  for ( unsigned int trackIteration = tracksSavedV; trackIteration * uint_v::Size < nTracks; ++trackIteration ) {
-    const uint_v trackIndex( uint_v( Vc::IndexesFromZero ) + uint_v(trackIteration * uint_v::Size) );
-    const uint_m active = trackIndex < nTracks && trackIndex >= tracksSaved;
-    if( active.isEmpty() ) continue;
-    TrackMemory r;
-    r.fStage( !active ) = NullStage;
-
-      // if rowStep = 2 TrackletStartHits need to be sorted such that all even start rows come first. The odd start rows - last.
-    uint_v length(Vc::Zero);
-    for( unsigned int i = 0; i < float_v::Size; i++ ) {
-      if( !active[i] ) continue;
-      r.fStartRow[i] = fTracker.TrackletStartHit((unsigned int)trackIndex[i]).fRow;
-      r.fCurrentHitIndex[i] = fTracker.TrackletStartHit((unsigned int)trackIndex[i]).fHit;
-      length[i] = fTracker.TrackletStartHit((unsigned int)trackIndex[i]).fLength;
+void AliHLTTPCCATrackletConstructor::SetHitsAsUsed( int rowIndex, const uint_v &hitIndex, int isUsed, const int_m &mask )
+{
+  const AliHLTTPCCARow &row = fData.Row( rowIndex );
+  if ( !fClaims ) {
+    switch ( isUsed ) {
+      case 1: fData.SetHitAsUsed( row, hitIndex, mask ); break;
+      case 2: fData.SetHitAsUsedInTrackFit( row, hitIndex, mask ); break;
+      default: fData.SetHitAsUsedInTrackExtend( row, hitIndex, mask );
     }
-    r.fEndRow = static_cast<uint_v>( r.fStartRow );
-    r.fLastRow = static_cast<uint_v>( r.fStartRow );
-//    r.fStartRow( !active ) = std::numeric_limits<int_v>::max();
-    r.fStartRow( !active ) = std::numeric_limits<int>::max();
-    r.fFirstRow = r.fStartRow;
+    return;
+  }
+  for ( unsigned int i = 0; i < uint_v::Size; ++i ) {
+    if ( !mask[i] ) continue;
+    const HitClaims::Claim c = { rowIndex, hitIndex[i], static_cast<unsigned int>( isUsed ) };
+    fClaims->fIsUsed.push_back( c );
+  }
+}
 
-#ifdef EXTEND_ALL_TRAKCS
-r.fIsFragile = uint_m(true);
-#else
-    const uint_v MaxNHitsForFragileTracklet(6);
-    r.fIsFragile = (length < MaxNHitsForFragileTracklet);
-#endif
-    const float_v zero( Vc::Zero );
-    const float_v one( Vc::One );
-    r.fParam.SetSinPhi(  zero );
-    r.fParam.SetDzDs(    zero );
-    r.fParam.SetQPt(     zero );
-    r.fParam.SetSignCosPhi( one );
-    r.fParam.SetChi2(    zero );
-    r.fParam.SetNDF(       -3 );
-    r.fParam.SetCov(  0,  one );
-    r.fParam.SetCov(  1, zero );
-    r.fParam.SetCov(  2,  one );
-    r.fParam.SetCov(  3, zero );
-    r.fParam.SetCov(  4, zero );
-    r.fParam.SetCov(  5,  one );
-    r.fParam.SetCov(  6, zero );
-    r.fParam.SetCov(  7, zero );
-    r.fParam.SetCov(  8, zero );
-    r.fParam.SetCov(  9,  one );
-    r.fParam.SetCov( 10, zero );
-    r.fParam.SetCov( 11, zero );
-    r.fParam.SetCov( 12, zero );
-    r.fParam.SetCov( 13, zero );
-    r.fParam.SetCov( 14, 10.f );
+void AliHLTTPCCATrackletConstructor::MaximizeHitWeight( int rowIndex, const uint_v &hitIndex, const uint_v &weight )
+{
+  if ( !fClaims ) {
+    fData.MaximizeHitWeight( fData.Row( rowIndex ), hitIndex, weight );
+    return;
+  }
+  const uint_m mask = validHitIndexes( hitIndex );
+  for ( unsigned int i = 0; i < uint_v::Size; ++i ) {
+    if ( !mask[i] ) continue;
+    const HitClaims::Claim c = { rowIndex, hitIndex[i], weight[i] };
+    fClaims->fWeights.push_back( c );
+  }
+}
 
-    {
-      InitTracklets init( r, fData, fTracker, fTrackletVectors[trackIteration], trackIndex, active );
-      r.fStartRow.callWithValuesSorted( init );
+int AliHLTTPCCATrackletConstructor::ApplyClaims( const HitClaims &claims )
+{
+  for ( unsigned int i = 0; i < claims.fIsUsed.size(); ++i ) {
+    const HitClaims::Claim &c = claims.fIsUsed[i];
+    fData.SetHitAsUsed( fData.Row( c.fRow ), c.fHit, c.fValue );
+  }
+  for ( unsigned int i = 0; i < claims.fWeights.size(); ++i ) {
+    const HitClaims::Claim &c = claims.fWeights[i];
+    fData.MaximizeHitWeight( fData.Row( c.fRow ), c.fHit, c.fValue );
+  }
+  fNLaneSteps += claims.fNLaneSteps;
+  fNActiveLaneSteps += claims.fNActiveLaneSteps;
+  return claims.fNStored;
+}
+
+  /// task of one vector of a parallel wave, the vector writes only its own tracklets and claims
+class AliHLTTPCCATrackletConstructor::ConstructWave
+{
+  public:
+    ConstructWave( const AliHLTTPCCATrackletConstructor &constructor, unsigned int firstVector,
+                   unsigned int tracksSaved, unsigned int nTracks, bool markUsed, HitClaims *claims ):
+      fConstructor( constructor ), fFirstVector( firstVector ), fTracksSaved( tracksSaved ), fNTracks( nTracks ),
+      fMarkUsed( markUsed ), fClaims( claims ) {}
+    void operator()( int i ) const {
+      HitClaims &claims = fClaims[i];
+      claims.fIsUsed.clear();
+      claims.fWeights.clear();
+      AliHLTTPCCATrackletConstructor constructor( fConstructor );
+      constructor.fClaims = &claims;
+      constructor.fNLaneSteps = 0;
+      constructor.fNActiveLaneSteps = 0;
+      claims.fNStored = constructor.ConstructVector( fFirstVector + i, fTracksSaved, fNTracks, fMarkUsed );
+      claims.fNLaneSteps = constructor.fNLaneSteps;
+      claims.fNActiveLaneSteps = constructor.fNActiveLaneSteps;
     }
-    
+  private:
+    const AliHLTTPCCATrackletConstructor &fConstructor;
+    unsigned int fFirstVector;
+    unsigned int fTracksSaved;
+    unsigned int fNTracks;
+    bool fMarkUsed;
+    HitClaims *fClaims;
+};
+
+#ifdef MAIN_DRAW
+#include "AliHLTTPCCADisplay.h"
+#include "TApplication.h"
+#endif //DRAW
+
+int AliHLTTPCCATrackletConstructor::ConstructVector( unsigned int trackIteration, unsigned int tracksSaved,
+                                                     unsigned int nTracks, bool markUsed )
+{
+  const uint_v trackIndex( uint_v( Vc::IndexesFromZero ) + uint_v(trackIteration * uint_v::Size) );
+  const uint_m active = trackIndex < nTracks && trackIndex >= tracksSaved;
+  if( active.isEmpty() ) return 0;
+  TrackMemory r;
+  InitTrackMemory( r, trackIndex, active );
+
+  {
+    InitTracklets init( r, *this, fTrackletVectors[trackIteration], trackIndex, active );
+    r.fStartRow.callWithValuesSorted( init );
+  }
+  
 //#define USE_COUNTERS
 #ifdef USE_COUNTERS
-    static unsigned int counters[6] = { 0, 0, 0, 0, 0, 0 };
-    counters[0]++;
+  static unsigned int counters[6] = { 0, 0, 0, 0, 0, 0 };
+  counters[0]++;
 #endif // USE_COUNTERS
 
-    const int rowStep = AliHLTTPCCAParameters::RowStep;
-    { // fit and extrapolate upwards
-      int rowIndex = r.fStartRow.min() + rowStep*2;
-      const int_v activationRow = r.fStartRow + rowStep*2;
-      debugF() << "============================================= Start Fitting Upwards =============================================" << endl;
-      // TODO think about getting parameters of all tracks (fragile and !fragile) in the same point (begin or end of track). Needed by Merger
+  const int rowStep = AliHLTTPCCAParameters::RowStep;
+  { // fit and extrapolate upwards
+    int rowIndex = r.fStartRow.min() + rowStep*2;
+    const int_v activationRow = r.fStartRow + rowStep*2;
+    debugF() << "============================================= Start Fitting Upwards =============================================" << endl;
+    // TODO think about getting parameters of all tracks (fragile and !fragile) in the same point (begin or end of track). Needed by Merger
 // #define DISABLE_HIT_SEARCH
 #ifdef DISABLE_HIT_SEARCH
-     while ( rowIndex < fTracker.Param().NRows() && !( r.fStage <= FitLinkedHits ).isEmpty() ) {
+   while ( rowIndex < fTracker.Param().NRows() && !( r.fStage <= FitLinkedHits ).isEmpty() ) {
 #ifdef USE_COUNTERS
-       counters[1]++;
+     counters[1]++;
 #endif // USE_COUNTERS
-       
-        ++r.fStage( rowIndex == activationRow ); // goes to FitLinkedHits on activation row
-        FitTracklet( r, rowIndex, trackIndex, fTrackletVectors[trackIteration] );
-        ++rowIndex;
-      }
+     
+      ++r.fStage( rowIndex == activationRow ); // goes to FitLinkedHits on activation row
+      FitTracklet( r, rowIndex, trackIndex, fTrackletVectors[trackIteration] );
+      ++rowIndex;
+    }
 
 
-      const int_m ready = r.fStage <= DoneStage;
-      const float_v x( fData.RowX(), float_v::IndexType( r.fEndRow ) );
+    const int_m ready = r.fStage <= DoneStage;
+    const float_v x( fData.RowX(), float_v::IndexType( r.fEndRow ) );
 //      const float_v x( fData.RowX(), float_v::IndexType( r.fStartRow ) );
-      debugF() << x << float_v::IndexType( r.fEndRow ) << float_v( fData.RowX(), float_v::IndexType( Vc::IndexesFromZero ) ) << endl;
-      assert( ( x == 0 && static_cast<float_m>( ready ) ).isEmpty() );
-      //assert ( ( (r.fParam.X() == x) && static_cast<float_m>( ready )) == static_cast<float_m>( ready ));
+    debugF() << x << float_v::IndexType( r.fEndRow ) << float_v( fData.RowX(), float_v::IndexType( Vc::IndexesFromZero ) ) << endl;
+    assert( ( x == 0 && static_cast<float_m>( ready ) ).isEmpty() );
+    //assert ( ( (r.fParam.X() == x) && static_cast<float_m>( ready )) == static_cast<float_m>( ready ));
 
-      const int_m transported = static_cast<int_m>( r.fParam.TransportToX(
-                                                           x, fTracker.Param().cBz(), .999f, static_cast<float_m>( ready ) ) );
-      
-      debugF() << "============================================= Stop Fitting Upwards ==============================================" << endl;
+    const int_m transported = static_cast<int_m>( r.fParam.TransportToX(
+                                                         x, fTracker.Param().cBz(), .999f, static_cast<float_m>( ready ) ) );
+    
+    debugF() << "============================================= Stop Fitting Upwards ==============================================" << endl;
 #ifdef MAIN_DRAW
-      if ( AliHLTTPCCADisplay::Instance().DrawType() == 10 ) {
-        foreach_bit( int ii, r.fStage < DoneStage ) {
-          TrackParam t( r.fParam, ii );
-          AliHLTTPCCADisplay::Instance().ClearView();
-          AliHLTTPCCADisplay::Instance().DrawSlice( &fTracker, 0 );
-          AliHLTTPCCADisplay::Instance().DrawSliceHits();
-          AliHLTTPCCADisplay::Instance().DrawTrackParam( t );
-        }
-        AliHLTTPCCADisplay::Instance().Ask();
+    if ( AliHLTTPCCADisplay::Instance().DrawType() == 10 ) {
+      foreach_bit( int ii, r.fStage < DoneStage ) {
+        TrackParam t( r.fParam, ii );
+        AliHLTTPCCADisplay::Instance().ClearView();
+        AliHLTTPCCADisplay::Instance().DrawSlice( &fTracker, 0 );
+        AliHLTTPCCADisplay::Instance().DrawSliceHits();
+        AliHLTTPCCADisplay::Instance().DrawTrackParam( t );
       }
+      AliHLTTPCCADisplay::Instance().Ask();
+    }
 #endif
 #else // DISABLE_HIT_SEARCH
-        // fit all chains
-      while ( rowIndex < fTracker.Param().NRows() && ( r.fStage == ExtrapolateUp ).isEmpty() ) {
+      // fit all chains
+    while ( rowIndex < fTracker.Param().NRows() && ( r.fStage == ExtrapolateUp ).isEmpty() ) {
 #ifdef USE_COUNTERS
-        counters[1]++;
+      counters[1]++;
 #endif // USE_COUNTERS
-        
-        r.fStage( rowIndex == activationRow ) = FitLinkedHits; // goes to FitLinkedHits on activation row
+      
+      r.fStage( rowIndex == activationRow ) = FitLinkedHits; // goes to FitLinkedHits on activation row
 
-        ExtendTracklet( r, rowIndex, trackIndex, fTrackletVectors[trackIteration], 1, int_m(Vc::Zero) );
-        ++rowIndex;
-      }
+      CountLanes( r.fStage == FitLinkedHits );
+      ExtendTracklet( r, rowIndex, trackIndex, fTrackletVectors[trackIteration], 1, int_m(Vc::Zero) );
+      ++rowIndex;
+    }
 
-      debugF() << "========================================== Start Extrapolating Upwards ==========================================" << endl;
+    debugF() << "========================================== Start Extrapolating Upwards ==========================================" << endl;
 
-        // some chains are fitted, some - are extrapolated
-      assert( (r.fRemainingGap >= 0).isFull() );
-      while ( rowIndex < fTracker.Param().NRows() && !( r.fStage <= ExtrapolateUp ).isEmpty() ) {
+      // some chains are fitted, some - are extrapolated
+    assert( (r.fRemainingGap >= 0).isFull() );
+    while ( rowIndex < fTracker.Param().NRows() && !( r.fStage <= ExtrapolateUp ).isEmpty() ) {
 #ifdef USE_COUNTERS
-       counters[2]++;
+     counters[2]++;
 #endif // USE_COUNTERS
 
-        r.fStage( rowIndex == activationRow ) = FitLinkedHits; // goes to FitLinkedHits on activation row
-        const int_m toExtrapolate = (r.fStage == ExtrapolateUp);
-        ExtendTracklet( r, rowIndex, trackIndex, fTrackletVectors[trackIteration], 1, toExtrapolate );
-        ++rowIndex;
-      }
+      r.fStage( rowIndex == activationRow ) = FitLinkedHits; // goes to FitLinkedHits on activation row
+      const int_m toExtrapolate = (r.fStage == ExtrapolateUp);
+      CountLanes( r.fStage == FitLinkedHits || toExtrapolate );
+      ExtendTracklet( r, rowIndex, trackIndex, fTrackletVectors[trackIteration], 1, toExtrapolate );
+      ++rowIndex;
+    }
 
-      debugF() << "============================================= Stop Fitting Upwards ==============================================" << endl;
+    debugF() << "============================================= Stop Fitting Upwards ==============================================" << endl;
 
-        // end extrapolate chains
-      int_m mask;
-      assert( (r.fRemainingGap >= 0).isFull() );
-      while ( rowIndex < fTracker.Param().NRows() && !( mask = r.fStage == ExtrapolateUp ).isEmpty() ) {
+      // end extrapolate chains
+    int_m mask;
+    assert( (r.fRemainingGap >= 0).isFull() );
+    while ( rowIndex < fTracker.Param().NRows() && !( mask = r.fStage == ExtrapolateUp ).isEmpty() ) {
 #ifdef USE_COUNTERS
-        counters[3]++;
+      counters[3]++;
 #endif // USE_COUNTERS
 
-        assert ( (r.fStage != FitLinkedHits).isFull() );
-        ExtrapolateTracklet( r, rowIndex, trackIndex, fTrackletVectors[trackIteration], 1, mask );
-        ++rowIndex;
-      }
-      debugF() << "=========================================== Stop Extrapolating Upwards ==========================================" << endl;
+      assert ( (r.fStage != FitLinkedHits).isFull() );
+      CountLanes( mask );
+      ExtrapolateTracklet( r, rowIndex, trackIndex, fTrackletVectors[trackIteration], 1, mask );
+      ++rowIndex;
     }
-      // r.fStage (r.fNHits < MaxNHitsForFragileTracklet) = DoneStage; // TODO investigate
-    { // extrapolate downwards
-      r.fRemainingGap = AliHLTTPCCAParameters::MaximumExtrapolationRowGap; // allow full gaps again
-      ++r.fStage( r.fStage == ExtrapolateUp ); // FitLinkedHits/ExtrapolateUp went so high that no gap put the tracklet into WaitingForExtrapolateDown
-      const int_m ready = r.fStage == WaitingForExtrapolateDown;
-      debugF() << "ready to extrapolate downwards: " << ready << endl;
-      ++r.fStage( ready ); // the wait is over
-
-      if(1){ // set track parameters to x of end row of the fitting stage
-        //const float_v x( fData.RowX(), float_v::IndexType( r.fEndRow ) );
-        const float_v x( fData.RowX(), float_v::IndexType( r.fStartRow ), static_cast<float_m>(ready));
-        debugF() << x << float_v::IndexType( r.fEndRow ) << float_v( fData.RowX(), float_v::IndexType( Vc::IndexesFromZero ) ) << endl;
-        assert( ( x == 0 && static_cast<float_m>( ready ) ).isEmpty() );
-        const int_m transported = static_cast<int_m>( r.fParam.TransportToX(
-                                                            x, fTracker.Param().cBz(), .999f, static_cast<float_m>( ready ) ) );
-        ++r.fStage( !transported ); // all those where transportation failed go to DoneStage
-      }
+    debugF() << "=========================================== Stop Extrapolating Upwards ==========================================" << endl;
+  }
+    // r.fStage (r.fNHits < MaxNHitsForFragileTracklet) = DoneStage; // TODO investigate
+  { // extrapolate downwards
+    PrepareExtrapolateDown( r );
 #ifdef MAIN_DRAW
-      if ( AliHLTTPCCADisplay::Instance().DrawType() == 1 ) {
-        for(int ii=0; ii<int_v::Size; ii++)
-        {
-          if(!(r.fStage[ii] < DoneStage)) continue;
-          TrackParam t( r.fParam, ii );
-          AliHLTTPCCADisplay::Instance().ClearView();
-          AliHLTTPCCADisplay::Instance().DrawSlice( &fTracker, 0 );
-          AliHLTTPCCADisplay::Instance().DrawSliceHits();
-          AliHLTTPCCADisplay::Instance().DrawTrackParam( t, 2 );
-        }
-        AliHLTTPCCADisplay::Instance().Ask();
+    if ( AliHLTTPCCADisplay::Instance().DrawType() == 1 ) {
+      for(int ii=0; ii<int_v::Size; ii++)
+      {
+        if(!(r.fStage[ii] < DoneStage)) continue;
+        TrackParam t( r.fParam, ii );
+        AliHLTTPCCADisplay::Instance().ClearView();
+        AliHLTTPCCADisplay::Instance().DrawSlice( &fTracker, 0 );
+        AliHLTTPCCADisplay::Instance().DrawSliceHits();
+        AliHLTTPCCADisplay::Instance().DrawTrackParam( t, 2 );
       }
+      AliHLTTPCCADisplay::Instance().Ask();
+    }
 #endif
-      debugF() << "========================================= Start Extrapolating Downwards =========================================" << endl;
-      int_v tmpRow(r.fStartRow); // take only one hit from fitted chain
-      tmpRow(!active) = fTracker.Param().NRows()-1;
-      int rowIndex = tmpRow.max();
-        // extrapolate along fitted chains
-      int_m mask; 
-      const int minMaskedExtrRow = r.fStartRow.min();
-      while ( rowIndex >= minMaskedExtrRow && !( mask = r.fStage == ExtrapolateDown ).isEmpty() ) {
+    debugF() << "========================================= Start Extrapolating Downwards =========================================" << endl;
+    int_v tmpRow(r.fStartRow); // take only one hit from fitted chain
+    tmpRow(!active) = fTracker.Param().NRows()-1;
+    int rowIndex = tmpRow.max();
+      // extrapolate along fitted chains
+    int_m mask; 
+    const int minMaskedExtrRow = r.fStartRow.min();
+    while ( rowIndex >= minMaskedExtrRow && !( mask = r.fStage == ExtrapolateDown ).isEmpty() ) {
 #ifdef USE_COUNTERS
-       counters[4]++;
+     counters[4]++;
 #endif // USE_COUNTERS
-       mask &= rowIndex < r.fStartRow + 1;
+     mask &= rowIndex < r.fStartRow + 1;
 //       mask &= ( ( rowIndex - r.fStartRow ) & int_v( std::numeric_limits<int_v::EntryType>::min() + 1 ) ) != int_v( Vc::Zero ); // CHECKME why do we need this?
-       mask &= ( ( rowIndex - r.fStartRow ) != int_v( Vc::Zero ) & int_v( std::numeric_limits<int_v::EntryType>::min() + 1 ) != int_v( Vc::Zero ) ); // CHECKME why do we need this?
-       ExtrapolateTracklet( r, rowIndex, trackIndex, fTrackletVectors[trackIteration], 0, mask );
-       --rowIndex;
-      }
-        // extrapolote downwards and find addition hits TODO try to delete that in new version
-      while ( rowIndex >= 0 && !( mask = r.fStage == ExtrapolateDown ).isEmpty() ) {
+     mask &= ( ( rowIndex - r.fStartRow ) != int_v( Vc::Zero ) & int_v( std::numeric_limits<int_v::EntryType>::min() + 1 ) != int_v( Vc::Zero ) ); // CHECKME why do we need this?
+     CountLanes( mask );
+     ExtrapolateTracklet( r, rowIndex, trackIndex, fTrackletVectors[trackIteration], 0, mask );
+     --rowIndex;
+    }
+      // extrapolote downwards and find addition hits TODO try to delete that in new version
+    while ( rowIndex >= 0 && !( mask = r.fStage == ExtrapolateDown ).isEmpty() ) {
 #ifdef USE_COUNTERS
-       counters[5]++;
+     counters[5]++;
 #endif // USE_COUNTERS
-       ExtrapolateTracklet( r, rowIndex, trackIndex, fTrackletVectors[trackIteration], 0, mask );
-        --rowIndex;
-      }
-      r.fFirstRow = CAMath::Min( r.fFirstRow, r.fStartRow );
+     CountLanes( mask );
+     ExtrapolateTracklet( r, rowIndex, trackIndex, fTrackletVectors[trackIteration], 0, mask );
+      --rowIndex;
+    }
+    r.fFirstRow = CAMath::Min( r.fFirstRow, r.fStartRow );
 #ifdef MAIN_DRAW
-      if ( AliHLTTPCCADisplay::Instance().DrawType() == 10 ) {
-        for(int ii=0; ii<int_v::Size; ii++)
-        {
-          if(!(r.fStage[ii] < NullStage)) continue;
+    if ( AliHLTTPCCADisplay::Instance().DrawType() == 10 ) {
+      for(int ii=0; ii<int_v::Size; ii++)
+      {
+        if(!(r.fStage[ii] < NullStage)) continue;
 //         foreach_bit( int ii, r.fStage < NullStage ) {
-          TrackParam t( r.fParam, ii );
-          AliHLTTPCCADisplay::Instance().ClearView();
-          AliHLTTPCCADisplay::Instance().DrawSlice( &fTracker, 0 );
-          AliHLTTPCCADisplay::Instance().DrawSliceHits();
-          AliHLTTPCCADisplay::Instance().DrawTrackParam( t, 4 );
+        TrackParam t( r.fParam, ii );
+        AliHLTTPCCADisplay::Instance().ClearView();
+        AliHLTTPCCADisplay::Instance().DrawSlice( &fTracker, 0 );
+        AliHLTTPCCADisplay::Instance().DrawSliceHits();
+        AliHLTTPCCADisplay::Instance().DrawTrackParam( t, 4 );
 //          AliHLTTPCCADisplay::Instance().Ask();
-        }
-        AliHLTTPCCADisplay::Instance().Ask();
       }
+      AliHLTTPCCADisplay::Instance().Ask();
+    }
 #endif
 
 #endif // DISABLE_HIT_SEARCH
-    }
+  }
 #ifdef USE_COUNTERS
-    std::cout << "Counters= " << counters[0] << " " << counters[1] << " " << counters[2] << " " << counters[3] << " " << counters[4] << " " << counters[5] << std::endl;
+  std::cout << "Counters= " << counters[0] << " " << counters[1] << " " << counters[2] << " " << counters[3] << " " << counters[4] << " " << counters[5] << std::endl;
 #endif // USE_COUNTERS
-       
-    float_m trackletOkF( r.fNHits >= uint_v(AliHLTTPCCAParameters::MinimumHitsForTracklet) );
-    for ( int i = 0; i < 15; ++i ) {
-      trackletOkF &= CAMath::Finite( r.fParam.Cov()[i] );
-    }
-    for ( int i = 0; i < 5; ++i ) {
-      trackletOkF &= CAMath::Finite( r.fParam.Par()[i] );
-    }
 
-      // 80 is row 0; if X is that small this track is garbage.
-      // XXX does this happen at all? If yes, under what conditions?
-    assert( ( r.fParam.X() > 50.f && trackletOkF ) == trackletOkF );
-    trackletOkF &= r.fParam.X() > 50.f // TODO: read from file!!!
-
-
-        // there must be errors and they must be positive or this track is garbage
-      && r.fParam.Err2QPt()    > float_v(Vc::Zero);
-    trackletOkF &= r.fParam.Err2Y()      > float_v(Vc::Zero) && r.fParam.Err2Z()      > float_v(Vc::Zero);
-    trackletOkF &= r.fParam.Err2SinPhi() > float_v(Vc::Zero) && r.fParam.Err2DzDs()   > float_v(Vc::Zero);
-//    trackletOkF &= ( r.fParam.Chi2()/static_cast<float_v>(r.fParam.NDF()) < 25.f ); // TODO
-    debugF() << r.fParam << "-> trackletOk: " << trackletOkF << endl;
-
-    const int_m trackletOk( trackletOkF );
-    r.fNHits.setZero( !trackletOk );
+  return StoreTracklets( r, trackIteration, active, markUsed );
+}
 
-      //////////////////////////////////////////////////////////////////////
-      //
-      //////////////////////////////////////////////////////////////////////
-    TrackletVector &tracklet = fTrackletVectors[trackIteration];
-    tracklet.SetNHits( r.fNHits, active );
+#ifdef V7
+void AliHLTTPCCATrackletConstructor::run( unsigned int firstRow, unsigned int &tracksSaved, unsigned int i_it )
+#else
+void AliHLTTPCCATrackletConstructor::run( unsigned int firstRow, unsigned int &tracksSaved )
+#endif
+{
 
-    if ( !( r.fNHits > 0 ).isEmpty() ) {
+#ifdef V7
+  if( i_it >= 0 ) {
+    fData.CleanUsedHits( 1+firstRow, false );
+    fData.CleanUsedHits( 2+firstRow, false );
+    fData.CleanUsedHits( 3+firstRow, false );
+    CreateStartSegmentV( 2+firstRow, i_it );
 #ifdef MAIN_DRAW
-      if ( AliHLTTPCCADisplay::Instance().DrawType() == 10 ) {
-        for(int ii=0; ii<int_v::Size; ii++)
-        {
-          if(!(r.fStage[ii] < DoneStage)) continue;
-//         foreach_bit( int ii, r.fStage < DoneStage ) {
-          TrackParam t( r.fParam, ii );
-          AliHLTTPCCADisplay::Instance().ClearView();
-          AliHLTTPCCADisplay::Instance().DrawSlice( &fTracker, 0 );
-          AliHLTTPCCADisplay::Instance().DrawSliceHits();
-          AliHLTTPCCADisplay::Instance().DrawTrackParam( t, 2 );
-//          AliHLTTPCCADisplay::Instance().Ask();
-        }
-        AliHLTTPCCADisplay::Instance().Ask();
-      }
+    if ( AliHLTTPCCADisplay::Instance().DrawType() == 1 )
+    {
+      AliHLTTPCCADisplay &disp = AliHLTTPCCADisplay::Instance();
+      disp.ClearView();
+      disp.SetSliceView();
+      disp.SetCurrentSlice( &fTracker );
+      disp.DrawSlice( &fTracker, 0 );
+      disp.DrawSliceHits(1, 0.5);
+      disp.DrawSliceLinks(-1,-1,1);
+      AliHLTTPCCADisplay::Instance().SaveCanvasToFile("NFinderTestXYZ.pdf");
+      disp.Ask();
+    }
 #endif
-        // start and end rows of the tracklet
-      tracklet.SetFirstRow( static_cast<uint_v>( r.fFirstRow ), active );
-      tracklet.SetLastRow( r.fLastRow, active );
-
-        ///mvz start 25.01.2010
-      const float_m MinQPt = CAMath::Abs(r.fParam.QPt()) < AliHLTTPCCAParameters::MinimumQPt;
-      float_v NewQPt = r.fParam.QPt();
-      NewQPt(MinQPt) = AliHLTTPCCAParameters::MinimumQPt;
-      r.fParam.SetQPt(NewQPt);
-        //      r.fParam.SetQPt( CAMath::Max( AliHLTTPCCAParameters::MinimumQPt, r.fParam.QPt() ) );
-        ///mvz end 25.01.2010
-      tracklet.SetParam( r.fParam, (float_m)active );
-
-#ifndef NO_NTRACKLET_FIX
-      for( unsigned int iV = 0; iV < float_v::Size; iV++ ) {
-	if( active[iV] ) newTr++;
-      }
+  }
+#else
+  UNUSED_PARAM1(firstRow);
 #endif
+  //
+  assert( *fTracker.NTracklets() < 32768 );
+  const unsigned int nTracks = *fTracker.NTracklets();
 
-      debugTS() << r.fFirstRow << r.fLastRow << endl;
-      debugTS() << "set hit weigths from row " << r.fFirstRow.min() << " until row " << r.fLastRow.max() << endl;
-//      const uint_v &weight = SliceData::CalculateHitWeight( r.fNHits, trackIndex );
-        // for all rows where we have a hit let the fTracker know what weight our hits have
-      for ( unsigned int rowIndex = r.fFirstRow.min(); rowIndex <= r.fLastRow.max(); ++rowIndex ) {
-        const uint_v &hitIndex = tracklet.HitIndexAtRow( rowIndex );
-        fData.MaximizeHitWeight( fData.Row( rowIndex ), hitIndex, r.fNHits );
+  int newTr = 0;
 #ifdef V7
-        if( i_it >= 0 ) {
-          fData.SetHitAsUsed( fData.Row( rowIndex ), hitIndex, int_m(hitIndex<fData.Row( rowIndex ).NHits()) );
-        }
+  const bool markUsed = ( i_it >= 0 );
+#else
+  const bool markUsed = 0;
 #endif
-      }
+
+  unsigned int tracksSavedV = tracksSaved / float_v::Size;
+  if ( fTracker.IsRefillTrackletConstructor() && tracksSaved < nTracks ) {
+    newTr = RunRefilled( tracksSaved, nTracks, markUsed );
+    tracksSavedV = ( nTracks + uint_v::Size - 1 ) / uint_v::Size; // all tracklets are done
+  }
+  const int nWave = fTracker.ParallelTrackletVectors();
+  const unsigned int endV = ( nTracks + uint_v::Size - 1 ) / uint_v::Size;
+  if ( nWave > 0 && tracksSavedV < endV ) {
+      // the vectors of a wave don't see the hits used by each other, their claims are applied in the order of the vectors
+    HitClaims *claims = fTracker.TrackletHitClaims();
+    for ( unsigned int firstV = tracksSavedV; firstV < endV; firstV += nWave ) {
+      const int n = CAMath::Min( static_cast<int>( endV - firstV ), nWave );
+      fTracker.ParallelFor( n, ConstructWave( *this, firstV, tracksSaved, nTracks, markUsed, claims ) );
+      for ( int i = 0; i < n; i++ ) newTr += ApplyClaims( claims[i] );
+    }
+  } else {
+    for ( unsigned int trackIteration = tracksSavedV; trackIteration < endV; ++trackIteration ) {
+      newTr += ConstructVector( trackIteration, tracksSaved, nTracks, markUsed );
     }
   }
+  fTracker.AddTrackletLaneSteps( fNLaneSteps, fNActiveLaneSteps );
+  fNLaneSteps = 0;
+  fNActiveLaneSteps = 0;
 
 #ifndef NO_NTRACKLET_FIX
   *fTracker.NTracklets() -= ( nTracks - tracksSaved - newTr );
@@ -1155,6 +1284,144 @@ r.fIsFragile = uint_m(true);
 #endif
 }
 
+  /// tracklets in the order of the start rows, the lowest (or with down the highest) first, the same rows in the order
+  /// of the tracklets, so std::sort gives the order of std::stable_sort without its temporary buffer
+class StartRowOrder
+{
+  public:
+    StartRowOrder( const Tracker &tracker, bool down ): fTracker( tracker ), fDown( down ) {}
+    bool operator()( unsigned int a, unsigned int b ) const {
+      const int rowA = fTracker.TrackletStartHit( a ).fRow;
+      const int rowB = fTracker.TrackletStartHit( b ).fRow;
+      if ( rowA != rowB ) return fDown ? rowA > rowB : rowA < rowB;
+      return a < b;
+    }
+  private:
+    const Tracker &fTracker;
+    bool fDown;
+};
+
+/*
+ * The lanes of a vector in run() are bound to its tracklets, so the vector walks over the rows until its longest
+ * tracklet is done. Here the state of each tracklet is kept in the lane of its TrackletVector and a row walk has lanes
+ * which are not bound: a tracklet takes a free lane at its first row and gives it back when it is done with the
+ * direction. The hits are the same as in run(), up to the order in which the tracklets take shared hits.
+ */
+int AliHLTTPCCATrackletConstructor::RunRefilled( unsigned int firstTrack, unsigned int nTracks, bool markUsed )
+{
+  const unsigned int firstVector = firstTrack / uint_v::Size;
+  const int nVectors = ( nTracks + uint_v::Size - 1 ) / uint_v::Size - firstVector;
+  const int rowStep = AliHLTTPCCAParameters::RowStep;
+  const int nRows = fTracker.Param().NRows();
+    // the memory of the previous run is reused, so only a bigger event allocates
+  AliHLTTPCCAArena &arena = fTracker.Arena();
+  arena.Reset();
+  TrackMemory *memory = arena.Alloc<TrackMemory>( nVectors );
+  unsigned int *queue = arena.Alloc<unsigned int>( nTracks - firstTrack );
+  unsigned int *deferred = arena.Alloc<unsigned int>( nTracks - firstTrack );
+  int nQueue = 0;
+
+  for ( int iV = 0; iV < nVectors; ++iV ) {
+    TrackMemory &r = memory[iV];
+    const uint_v trackIndex( uint_v( Vc::IndexesFromZero ) + uint_v( ( firstVector + iV ) * uint_v::Size ) );
+    const uint_m active = trackIndex < nTracks && trackIndex >= firstTrack;
+    InitTrackMemory( r, trackIndex, active );
+    InitTracklets init( r, *this, fTrackletVectors[firstVector + iV], trackIndex, active );
+    r.fStartRow.callWithValuesSorted( init );
+    for ( unsigned int i = 0; i < uint_v::Size; ++i ) {
+      if ( active[i] && r.fStartRow[i] + rowStep*2 < nRows ) queue[nQueue++] = trackIndex[i];
+    }
+  }
+  std::sort( queue, queue + nQueue, StartRowOrder( fTracker, 0 ) );
+  RunLanes( memory, firstVector, queue, deferred, nQueue, 1 ); // fit and extrapolate upwards
+
+  nQueue = 0;
+  for ( int iV = 0; iV < nVectors; ++iV ) {
+    TrackMemory &r = memory[iV];
+    PrepareExtrapolateDown( r );
+    for ( unsigned int i = 0; i < uint_v::Size; ++i ) {
+      if ( r.fStage[i] == ExtrapolateDown && r.fStartRow[i] > 0 ) queue[nQueue++] = ( firstVector + iV ) * uint_v::Size + i;
+    }
+  }
+  std::sort( queue, queue + nQueue, StartRowOrder( fTracker, 1 ) ); // the highest start rows first
+  RunLanes( memory, firstVector, queue, deferred, nQueue, 0 ); // extrapolate downwards
+
+  int nStored = 0;
+  for ( int iV = 0; iV < nVectors; ++iV ) {
+    TrackMemory &r = memory[iV];
+    const uint_v trackIndex( uint_v( Vc::IndexesFromZero ) + uint_v( ( firstVector + iV ) * uint_v::Size ) );
+    const uint_m active = trackIndex < nTracks && trackIndex >= firstTrack;
+    r.fFirstRow = CAMath::Min( r.fFirstRow, r.fStartRow );
+    nStored += StoreTracklets( r, firstVector + iV, active, markUsed );
+  }
+  return nStored;
+}
+
+void AliHLTTPCCATrackletConstructor::RunLanes( TrackMemory *memory, unsigned int firstVector,
+                                               unsigned int *queue, unsigned int *deferred, int nQueue, bool dir )
+{
+  const int nRows = fTracker.Param().NRows();
+  const int rowStep = AliHLTTPCCAParameters::RowStep;
+  const int step = dir ? rowStep : -rowStep;
+    // upwards the tracklet starts with the fit at the activation row, downwards below the start row
+  const int firstRowShift = dir ? rowStep*2 : -rowStep;
+
+  while ( nQueue > 0 ) {
+    TrackMemory r;
+    r.fStage = NullStage;
+    uint_v trackIndex( Vc::Zero );
+    int laneTrack[uint_v::Size]; // tracklet of the lane, -1 for a free lane
+    for ( unsigned int i = 0; i < uint_v::Size; ++i ) laneTrack[i] = -1;
+
+    int nDeferred = 0;
+    int next = 0;
+    int rowIndex = fTracker.TrackletStartHit( queue[0] ).fRow + firstRowShift;
+    while ( rowIndex >= 0 && rowIndex < nRows ) {
+        // no lane was free at the first row of these tracklets, they wait for the next walk
+      while ( next < nQueue && ( fTracker.TrackletStartHit( queue[next] ).fRow + firstRowShift - rowIndex ) * step < 0 ) {
+        deferred[nDeferred++] = queue[next++];
+      }
+
+      int_m active = dir ? ( r.fStage == FitLinkedHits || r.fStage == ExtrapolateUp ) : ( r.fStage == ExtrapolateDown );
+      for ( unsigned int i = 0; i < uint_v::Size; ++i ) {
+        if ( laneTrack[i] >= 0 && !active[i] ) { // done, the lane is free
+          memory[laneTrack[i] / uint_v::Size - firstVector].SetLane( laneTrack[i] % uint_v::Size, r, i );
+          laneTrack[i] = -1;
+          r.fStage[i] = NullStage;
+        }
+        if ( laneTrack[i] < 0 && next < nQueue && fTracker.TrackletStartHit( queue[next] ).fRow + firstRowShift == rowIndex ) {
+          laneTrack[i] = queue[next++];
+          trackIndex[i] = laneTrack[i];
+          r.SetLane( i, memory[laneTrack[i] / uint_v::Size - firstVector], laneTrack[i] % uint_v::Size );
+          if ( dir ) r.fStage[i] = FitLinkedHits; // goes to FitLinkedHits on activation row
+          active[i] = true;
+        }
+      }
+      if ( active.isEmpty() ) { // go to the first row of the next tracklet
+        if ( next == nQueue ) break;
+        rowIndex = fTracker.TrackletStartHit( queue[next] ).fRow + firstRowShift;
+        continue;
+      }
+
+      CountLanes( active );
+        // the row hits are written into the vectors of trackIndex, see SetRowHits
+      if ( dir ) {
+        ExtendTracklet( r, rowIndex, trackIndex, fTrackletVectors[firstVector], 1, r.fStage == ExtrapolateUp );
+      } else {
+        ExtrapolateTracklet( r, rowIndex, trackIndex, fTrackletVectors[firstVector], 0, active );
+      }
+      rowIndex += step;
+    }
+
+    for ( unsigned int i = 0; i < uint_v::Size; ++i ) {
+      if ( laneTrack[i] >= 0 ) memory[laneTrack[i] / uint_v::Size - firstVector].SetLane( laneTrack[i] % uint_v::Size, r, i );
+    }
+    while ( next < nQueue ) deferred[nDeferred++] = queue[next++];
+    std::swap( queue, deferred );
+    nQueue = nDeferred;
+  }
+}
+
 void InitTracklets::operator()( int rowIndex )
 {
   if ( ISUNLIKELY( rowIndex >= fTracker.Param().NRows() || rowIndex < 0 ) ) {
@@ -1180,19 +1447,9 @@ void InitTracklets::operator()( int rowIndex )
 
       // mark first hit as used
     int_v isUsed;
-    for( unsigned int i = 0; i < float_v::Size; i++ ) {
-      if( !mask[i] ) continue;
-      isUsed[i] = fData.HitDataIsUsed( row )[(unsigned int)r.fCurrentHitIndex[i]];
-    }
-    fData.SetHitAsUsedInTrackFit( row, static_cast<uint_v>( r.fCurrentHitIndex ), mask && ( isUsed == int_v(1) ) );
-#ifdef VC_GATHER_SCATTER
-    r.fCurrentHitIndex.gather( fData.HitLinkUpData( row ), hitIndex, mask ); // set to next linked hit
-#else
-    for( unsigned int i = 0; i < float_v::Size; i++ ) {
-      if( !mask[i] ) continue;
-      r.fCurrentHitIndex[i] = fData.HitLinkUpData( row )[(unsigned int)hitIndex[i]];
-    }
-#endif
+    CAGatherScatter::Gather( isUsed, fData.HitDataIsUsed( row ), static_cast<uint_v>( r.fCurrentHitIndex ), mask );
+    fConstructor.SetHitsAsUsed( rowIndex, static_cast<uint_v>( r.fCurrentHitIndex ), 2, mask && ( isUsed == int_v(1) ) );
+    CAGatherScatter::Gather( r.fCurrentHitIndex, fData.HitLinkUpData( row ), hitIndex, mask ); // set to next linked hit
     // the first hit in the Tracklet is guaranteed to have a link up, since StartHitsFinder
     // ensures it
     assert( ( r.fCurrentHitIndex >= 0 && mask ) == mask );
@@ -1232,19 +1489,9 @@ void InitTracklets::operator()( int rowIndex )
     
       // mark 2-nd hit as used
     int_v isUsed;
-    for( unsigned int i = 0; i < float_v::Size; i++ ) {
-      if( !mask[i] ) continue;
-      isUsed[i] = fData.HitDataIsUsed( row )[(unsigned int)r.fCurrentHitIndex[i]];
-    }
-    fData.SetHitAsUsedInTrackFit( row, static_cast<uint_v>( r.fCurrentHitIndex ), static_cast<int_m>(mask) && ( isUsed == int_v(1) ) );
-#ifdef VC_GATHER_SCATTER
-    r.fCurrentHitIndex.gather( fData.HitLinkUpData( row ), hitIndex, mask ); // set to next linked hit
-#else
-    for( unsigned int i = 0; i < float_v::Size; i++ ) {
-      if( !mask[i] ) continue;
-      r.fCurrentHitIndex[i] = fData.HitLinkUpData( row )[(unsigned int)hitIndex[i]];
-    }
-#endif
+    CAGatherScatter::Gather( isUsed, fData.HitDataIsUsed( row ), static_cast<uint_v>( r.fCurrentHitIndex ), mask );
+    fConstructor.SetHitsAsUsed( rowIndex, static_cast<uint_v>( r.fCurrentHitIndex ), 2, static_cast<int_m>(mask) && ( isUsed == int_v(1) ) );
+    CAGatherScatter::Gather( r.fCurrentHitIndex, fData.HitLinkUpData( row ), hitIndex, mask ); // set to next linked hit
     // the second hit in the Tracklet is also guaranteed to have a link up, since StartHitsFinder
     // ensures it
     assert( ( r.fCurrentHitIndex >= 0 && mask ) == mask );
@@ -27,6 +27,7 @@
 
 #include "AliHLTTPCCADef.h"
 #include <AliHLTArray.h>
+#include "AliHLTTPCCAHitClaims.h"
 
 class AliHLTTPCCASliceData;
 
@@ -38,7 +39,7 @@ class AliHLTTPCCATrackletConstructor {
  public:
   inline AliHLTTPCCATrackletConstructor( Tracker &tracker, SliceData &data,
   AliHLTArray<TrackletVector> trackletVectors )
-    : fTracker( tracker ), fTrackletVectors( trackletVectors ), fData( data ) {}
+    : fTracker( tracker ), fTrackletVectors( trackletVectors ), fData( data ), fClaims( 0 ), fNLaneSteps( 0 ), fNActiveLaneSteps( 0 ) {}
 
 #ifdef V7
   void run( unsigned int firstRow, unsigned int &tracksSaved, unsigned int i_it );
@@ -48,6 +49,11 @@ class AliHLTTPCCATrackletConstructor {
 
   struct TrackMemory;
  private:
+  friend class InitTracklets;
+  class ConstructWave;
+
+  typedef AliHLTTPCCAHitClaims HitClaims;
+
     // add one hit from chain to track
   void FitTracklet( TrackMemory &r, const int rowIndex, const uint_v trackIndex, TrackletVector &trackletVector );
     // find nearest hit on row and set it as currentHit (see TrackMemory)
@@ -62,9 +68,37 @@ class AliHLTTPCCATrackletConstructor {
     // new
   void CreateStartSegmentV( const int rowIndex, const int iter );
 
+    // set the start hits of the tracklets trackIndex and the initial parameters
+  void InitTrackMemory( TrackMemory &r, const uint_v &trackIndex, const uint_m &active );
+    // tracklets which are done with the upwards extrapolation wait for the downwards one at the start row
+  void PrepareExtrapolateDown( TrackMemory &r );
+    // check the tracklets and write them into the vector, returns the number of the kept ones
+  int StoreTracklets( TrackMemory &r, unsigned int trackIteration, const uint_m &active, bool markUsed );
+    // fit, extend and store the tracklets of one vector, returns the number of the kept ones
+  int ConstructVector( unsigned int trackIteration, unsigned int tracksSaved, unsigned int nTracks, bool markUsed );
+    // set the isUsed flag (1 - start hit, 2 - fitted, 3 - extrapolated) and the weight of the hits,
+    // directly or, in the parallel waves, by fClaims
+  void SetHitsAsUsed( int rowIndex, const uint_v &hitIndex, int isUsed, const int_m &mask );
+  void MaximizeHitWeight( int rowIndex, const uint_v &hitIndex, const uint_v &weight );
+    // apply the claims of one vector of a wave, returns the number of the kept tracklets
+  int ApplyClaims( const HitClaims &claims );
+    // row hits of the lanes, trackIndex is the tracklet of each lane in the refill mode
+  void SetRowHits( TrackletVector &trackletVector, int rowIndex, const uint_v &trackIndex, const uint_v &hitIndex, const int_m &mask );
+
+    // construction with refilled lanes, see AliHLTTPCCATracker::SetRefillTrackletConstructor
+  int RunRefilled( unsigned int firstTrack, unsigned int nTracks, bool markUsed );
+    // walk over the rows upwards (dir) or downwards, the nQueue tracklets of the queue take the free lanes at their first row,
+    // deferred has the same size and keeps the tracklets for the next walk
+  void RunLanes( TrackMemory *memory, unsigned int firstVector, unsigned int *queue, unsigned int *deferred, int nQueue, bool dir );
+
+  void CountLanes( const int_m &active ) { fNLaneSteps += int_v::Size; fNActiveLaneSteps += active.count(); }
+
   Tracker &fTracker;
   AliHLTArray<TrackletVector> fTrackletVectors;
   SliceData &fData;
+  HitClaims *fClaims; // 0 - the hits are marked directly
+  int fNLaneSteps; // lane utilisation, see AliHLTTPCCATracker::NTrackletLaneSteps
+  int fNActiveLaneSteps;
 };
 
 #endif
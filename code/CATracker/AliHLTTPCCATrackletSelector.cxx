@@ -46,19 +46,27 @@ using std::endl;
 
 void AliHLTTPCCATrackletSelector::run()
 {
-  fTracks.resize( fNumberOfTracks * uint_v::Size * AliHLTTPCCAParameters::MaxNumberOfRows8 / AliHLTTPCCAParameters::MinimumHitsForTrack ); // should be less, the factor is for safety, since the tracks can be broken into pieces
+  const unsigned int NTracklets = fTracker.NTracklets();
+
+    // book the hit ids: a lane can't save more hits, than the number of rows, which are looked through
+  int maxNHitIds = 0;
+  for ( unsigned int iTrackletV = 0; iTrackletV * int_v::Size < NTracklets; ++iTrackletV ) {
+    const TrackletVector &tracklet = fTrackletVectors[iTrackletV];
+    maxNHitIds += ( tracklet.LastRow().max() - tracklet.FirstRow().min() + 1 ) * uint_v::Size;
+  }
+  if ( fHitIds.Size() < maxNHitIds ) fHitIds.Resize( maxNHitIds ); // the old ids aren't needed
+  AliHLTTPCCAHitId *hitIds = fHitIds.Data();
+  int nHitIdsBooked = 0;
+
+  fTracks.clear(); // keeps the capacity
 #ifdef USE_TBB
-  tbb::atomic<int> numberOfTracks;
   tbb::fatomic<int> NHitsTotal;
 #else //USE_TBB
-  int numberOfTracks;
   int NHitsTotal;
 #endif //USE_TBB
 
-  numberOfTracks = 0;
   NHitsTotal = 0;
 
-  const unsigned int NTracklets = fTracker.NTracklets();
   for ( unsigned int iTrackletV = 0; iTrackletV * int_v::Size < NTracklets; ++iTrackletV ) {
     const TrackletVector &tracklet = fTrackletVectors[iTrackletV];
     const uint_v trackIndexes = uint_v( Vc::IndexesFromZero ) + uint_v(iTrackletV * int_v::Size);
@@ -73,11 +81,13 @@ void AliHLTTPCCATrackletSelector::run()
 
     uint_v nTrackHits( Vc::Zero );
 
-    Track *trackCandidates[int_v::Size];
+    AliHLTTPCCAHitId *trackHitIds[int_v::Size]; // hit ids of the current track candidates
     for( unsigned int iV=0; iV<uint_v::Size; iV++ ) {
       if(!validTracklets[iV]) continue;
-      trackCandidates[iV] = new Track;
+      trackHitIds[iV] = hitIds + nHitIdsBooked;
+      nHitIdsBooked += lastRow.max() - firstRow.min() + 1;
     }
+    assert( nHitIdsBooked <= maxNHitIds );
 
     uint_v gap( Vc::Zero ); // count how many rows are missing a hit
     uint_v nShared( Vc::Zero );
@@ -94,17 +104,18 @@ void AliHLTTPCCATrackletSelector::run()
         if(!validTracklets[iV]) continue;
         if ( saveHitMask[iV] ) {
           assert( hitIndexes[iV] < fData.Row( rowIndex ).NHits() );
-          trackCandidates[iV]->fHitIdArray[nTrackHits[iV]].Set( rowIndex, hitIndexes[iV] );
+          trackHitIds[iV][nTrackHits[iV]].Set( rowIndex, hitIndexes[iV] );
         } 
         else if ( brokenTrackMask[iV] ) { // save part of the track and create new track from the rest
           NHitsTotal += nTrackHits[iV];
 
-          fTracks[numberOfTracks] = trackCandidates[iV];
-          fTracks[numberOfTracks]->fNumberOfHits = nTrackHits[iV];
-          fTracks[numberOfTracks]->fParam = TrackParam( tracklet.Param(), iV );
-          numberOfTracks++;
-        
-          trackCandidates[iV] = new Track;
+          fTracks.push_back( Track() );
+          Track &track = fTracks.back();
+          track.fHitIds = trackHitIds[iV];
+          track.fNumberOfHits = nTrackHits[iV];
+          track.fParam = TrackParam( tracklet.Param(), iV );
+
+          trackHitIds[iV] += nTrackHits[iV]; // the rest follows the saved part
         } // if save
       } // for i
       nTrackHits( saveHitMask )++;
@@ -117,18 +128,16 @@ void AliHLTTPCCATrackletSelector::run()
       if(!validTracklets[iV]) continue;
       if ( nTrackHits[iV] >= static_cast<unsigned int>(AliHLTTPCCAParameters::MinimumHitsForTrack) ) {
         NHitsTotal += nTrackHits[iV];
-        
-        fTracks[numberOfTracks] = trackCandidates[iV];
-        fTracks[numberOfTracks]->fNumberOfHits = nTrackHits[iV];
-        fTracks[numberOfTracks]->fParam = TrackParam( tracklet.Param(), iV );
-        numberOfTracks++;
-      } else {
-        delete trackCandidates[iV];
+
+        fTracks.push_back( Track() );
+        Track &track = fTracks.back();
+        track.fHitIds = trackHitIds[iV];
+        track.fNumberOfHits = nTrackHits[iV];
+        track.fParam = TrackParam( tracklet.Param(), iV );
       }
     }
 
   } // for iTrackletV
   fNumberOfHits = NHitsTotal;
-  fTracks.resize( numberOfTracks );
-  fNumberOfTracks = numberOfTracks;
+  fNumberOfTracks = fTracks.size();
 }
@@ -33,13 +33,17 @@
 /**
  * @class AliHLTTPCCATrackletSelector
  *
+ * Creates the tracks from the tracklets. The tracks are stored by value and their hit ids
+ * are written to one buffer, both are reused for the next events, so no memory is allocated
+ * once the largest event is processed.
  */
 class AliHLTTPCCATrackletSelector {
   public:
-    inline AliHLTTPCCATrackletSelector( const Tracker &tracker, std::vector<AliHLTTPCCATrack *> *tracks,
+    inline AliHLTTPCCATrackletSelector( const Tracker &tracker, std::vector<AliHLTTPCCATrack> *tracks,
+        AliHLTResizableArray<AliHLTTPCCAHitId> *hitIds,
         int *numberOfHits, int *numberOfTracks, const SliceData &data,
         AliHLTArray<TrackletVector> &trackletVectors )
-      : fTracker( tracker ), fTracks( *tracks ), fNumberOfHits( *numberOfHits ),
+      : fTracker( tracker ), fTracks( *tracks ), fHitIds( *hitIds ), fNumberOfHits( *numberOfHits ),
       fNumberOfTracks( *numberOfTracks ), fTrackletVectors( trackletVectors ), fData( data )
     {}
 
@@ -47,7 +51,8 @@ class AliHLTTPCCATrackletSelector {
 
   private:
     const Tracker &fTracker;
-    std::vector<AliHLTTPCCATrack *> &fTracks;
+    std::vector<AliHLTTPCCATrack> &fTracks;
+    AliHLTResizableArray<AliHLTTPCCAHitId> &fHitIds;
     int &fNumberOfHits;
     int &fNumberOfTracks;
     const AliHLTArray<TrackletVector> fTrackletVectors;
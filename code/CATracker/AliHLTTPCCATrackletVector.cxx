@@ -19,10 +19,6 @@
 #include "AliHLTTPCCATrackletVector.h"
 
 AliHLTTPCCATrackletVector::AliHLTTPCCATrackletVector()
-    : fNHits( Vc::Zero ), fFirstRow( Vc::Zero ), fLastRow( Vc::Zero )
+    : fNHits( Vc::Zero ), fFirstRow( Vc::Zero ), fLastRow( Vc::Zero ), fRowHits( 0 ), fWideRowHits( 0 ), fNRows( 0 )
 {
-  const uint_v x = std::numeric_limits<uint_v>::max();
-  for ( unsigned int i = 0; i < fRowHits.size(); ++i ) {
-    reinterpret_cast<uint_v&>(fRowHits[i]) = x;
-  }
 }
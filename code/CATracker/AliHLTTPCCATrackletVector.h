@@ -29,11 +29,26 @@
 //#include <valgrind/memcheck.h>
 //#endif
 
+/**
+ * The hit indices of the rows are 16 bit, lane after lane for each row of the slice. They are kept outside of the
+ * vector (see AliHLTTPCCATracker::ResizeTrackletVectors), so only the rows the slice has are written and read.
+ * A 16 bit index has to be below kInvalidRowHit = 0xffff, so for a slice with a row of 0xffff hits or more
+ * the tracker gives the vectors 32 bit row hits instead.
+ */
 class AliHLTTPCCATrackletVector
 {
   public:
+    typedef unsigned short RowHit;
+    static const RowHit kInvalidRowHit = 0xffff; // no hit in the row, the rows have less hits
+    static const unsigned int kInvalidWideRowHit = 0xffffffff; // the same for the 32 bit row hits
+
     AliHLTTPCCATrackletVector();
 
+      /// rowHits - nRows * uint_v::Size hit indices, set to kInvalidRowHit
+    void SetRowHitsMemory( RowHit *rowHits, int nRows ) { fRowHits = rowHits; fWideRowHits = 0; fNRows = nRows; }
+      /// the same with 32 bit hit indices set to kInvalidWideRowHit, for the rows with kInvalidRowHit hits or more
+    void SetRowHitsMemory( unsigned int *rowHits, int nRows ) { fRowHits = 0; fWideRowHits = rowHits; fNRows = nRows; }
+
     uint_m IsValid() const { return fNHits > uint_v( Vc::Zero ); }
 
     uint_v NHits() const    { return fNHits;    }
@@ -41,10 +56,12 @@ class AliHLTTPCCATrackletVector
     uint_v LastRow() const  { return fLastRow;  }
     const AliHLTTPCCATrackParamVector &Param() const { return fParam; }
 
+      /// the hit index, or -1 (as unsigned) if there is no hit in the row
     unsigned int HitIndexAtRow( int rowIndex, int trackIndex ) const {
-      return fRowHits[rowIndex][trackIndex];
+      assert( rowIndex < fNRows );
+      return RowHitAt( rowIndex * uint_v::Size + trackIndex );
     }
-    uint_v HitIndexAtRow( int rowIndex ) const { return uint_v( &fRowHits[rowIndex][0] ); }
+    uint_v HitIndexAtRow( int rowIndex ) const;
 
     void SetNHits   ( const uint_v &x ) { fNHits    = x; }
     void SetFirstRow( const uint_v &x ) { fFirstRow = x; }
@@ -56,6 +73,7 @@ class AliHLTTPCCATrackletVector
     void SetLastRow ( const uint_v &x, uint_m mask  ) { fLastRow(mask)  = x; }
     void SetParam   ( const TrackParamVector &x, float_m mask  );
 
+    void SetRowHit( int rowIndex, int trackIndex, unsigned int hitIndex ) { SetRowHitAt( rowIndex * uint_v::Size + trackIndex, hitIndex ); }
     void SetRowHits( int rowIndex, const uint_v &trackIndex, const uint_v &hitIndex );
     void SetRowHits( const uint_v &rowIndex, const uint_v &trackIndex, const uint_v &hitIndex );
     void SetRowHits( int rowIndex, const uint_v &trackIndex, const uint_v &hitIndex, const int_m &mask );
@@ -63,15 +81,40 @@ class AliHLTTPCCATrackletVector
 
     void AddHitIds( const uint_v &rowIndexes, const uint_v &hitIndexes, const uint_m &mask );
 
-    int MaxNRows() const { return fRowHits.size(); }
+    int MaxNRows() const { return fNRows; }
   private:
+    static RowHit ToRowHit( unsigned int hitIndex ) {
+      assert( hitIndex < kInvalidRowHit || static_cast<int>( hitIndex ) < 0 ); // the negative ones mean no hit
+      return static_cast<int>( hitIndex ) < 0 ? kInvalidRowHit : static_cast<RowHit>( hitIndex );
+    }
+    unsigned int RowHitAt( int i ) const {
+      if ( fWideRowHits ) return fWideRowHits[i];
+      return ( fRowHits[i] == kInvalidRowHit ) ? static_cast<unsigned int>( -1 ) : fRowHits[i];
+    }
+    void SetRowHitAt( int i, unsigned int hitIndex ) {
+      if ( fWideRowHits ) fWideRowHits[i] = static_cast<int>( hitIndex ) < 0 ? kInvalidWideRowHit : hitIndex;
+      else fRowHits[i] = ToRowHit( hitIndex );
+    }
+
     uint_v fNHits;      // N hits
     uint_v fFirstRow;   // first TPC row
     uint_v fLastRow;    // last TPC row
     TrackParamVector fParam;   // tracklet parameters
-    Vc::array< Vc::array<unsigned int, uint_v::Size>, AliHLTTPCCAParameters::MaxNumberOfRows8 > fRowHits; // hit index for each TPC row
+    RowHit *fRowHits;   // hit index for each row of the slice and lane, see SetRowHitsMemory
+    unsigned int *fWideRowHits; // instead of fRowHits for the slices with big rows
+    int fNRows;         // number of rows in fRowHits
 };
 
+inline uint_v AliHLTTPCCATrackletVector::HitIndexAtRow( int rowIndex ) const
+{
+  assert( rowIndex < fNRows );
+  uint_v hitIndex;
+  for( unsigned int i = 0; i < uint_v::Size; i++ ) {
+    hitIndex[i] = RowHitAt( rowIndex * uint_v::Size + i );
+  }
+  return hitIndex;
+}
+
 inline void AliHLTTPCCATrackletVector::SetParam( const TrackParamVector &x, float_m mask )
 {
   if( mask.isFull() ) {
@@ -90,10 +133,9 @@ inline void AliHLTTPCCATrackletVector::SetRowHits( int rowIndex, const uint_v &t
   assert( uint_m(( trackIndex[0] % uint_v::Size ) == 0).isFull() );
   UNUSED_PARAM1( trackIndex );
   VALGRIND_CHECK_VALUE_IS_DEFINED( hitIndex );
-  VALGRIND_CHECK_MEM_IS_DEFINED( &fRowHits[rowIndex], sizeof( uint_v ) );
-//  hitIndex.store( &fRowHits[rowIndex][0] );
+  assert( rowIndex < fNRows );
   for( unsigned int i = 0; i < float_v::Size; i++ ) {
-    fRowHits[rowIndex][i] = hitIndex[i];
+    SetRowHitAt( rowIndex * uint_v::Size + i, hitIndex[i] );
   }
 //  VALGRIND_CHECK_MEM_IS_DEFINED( &fRowHits[rowIndex], sizeof( uint_v ) );
 }
@@ -118,15 +160,14 @@ inline void AliHLTTPCCATrackletVector::SetRowHits( int rowIndex, const uint_v &t
   assert( (trackIndex[0] + uint_v( Vc::IndexesFromZero ) == trackIndex).isFull() );
   assert( uint_m(( trackIndex[0] % uint_v::Size ) == 0).isFull() );
   UNUSED_PARAM1( trackIndex );
-  assert( &fRowHits[0] != 0 );
-  VALGRIND_CHECK_MEM_IS_DEFINED( &fRowHits[rowIndex], sizeof( uint_v ) );
+  assert( ( fRowHits != 0 || fWideRowHits != 0 ) && rowIndex < fNRows );
 //   debugF() << "TrackletVector::SetRowHits " << rowIndex << " old: ";
 //   debugF() << uint_v( fRowHits[rowIndex] );
 //   debugF() << " new: " << hitIndex << mask;
   if( mask.isEmpty() ) return;
   for( unsigned int i = 0; i < float_v::Size; i++ ) {
     if( !mask[i] ) continue;
-    fRowHits[rowIndex][i] = hitIndex[i];
+    SetRowHitAt( rowIndex * uint_v::Size + i, hitIndex[i] );
   }
 //   debugF() << " done: " << uint_v( fRowHits[rowIndex] ) << std::endl;
 //  VALGRIND_CHECK_MEM_IS_DEFINED( &fRowHits[rowIndex], sizeof( uint_v ) );
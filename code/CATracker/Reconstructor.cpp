@@ -95,7 +95,7 @@ int AliHLTTPCCATracker::Reconstructor::execute()
 
   if ( d->fData.NumberOfHits() <= 0 ) {
     d->RecalculateTrackMemorySize( 1, 1 );
-    d->fTrackMemory = new char[d->fTrackMemorySize + 1600]; // TODO rid of 1600
+    d->AllocateTrackMemory();
     d->SetPointersTracks( 1, 1 ); // set pointers for tracks
     d->fOutput->SetNTracks( 0 );
     d->fOutput->SetNTrackClusters( 0 );
@@ -124,7 +124,8 @@ int AliHLTTPCCATracker::Reconstructor::execute()
     for ( unsigned int i = 0; i < numberOfHits; i += int_v::Size ) {
       const uint_v hitIndexes = uint_v( Vc::IndexesFromZero ) + i;
       const int_m validHitsMask = (hitIndexes < numberOfHits);
-      const int_v isUsed = int_v( d->fData.HitDataIsUsed( row ), static_cast<uint_v>(hitIndexes), validHitsMask);
+      int_v isUsed;
+      CAGatherScatter::Gather( isUsed, d->fData.HitDataIsUsed( row ), hitIndexes, validHitsMask );
        ASSERT( ((isUsed == int_v( Vc::Zero )) && validHitsMask) == validHitsMask,
               isUsed << validHitsMask);
     }
@@ -138,7 +139,8 @@ int AliHLTTPCCATracker::Reconstructor::execute()
 #endif
 
 #ifdef V6
-  std::vector<hit_link> save_up_links;
+  std::vector<hit_link> &save_up_links = d->fSaveUpLinks;
+  save_up_links.clear(); // keeps the capacity
 #endif
 
   for (int iter = 0; iter < nIt; iter++) {
@@ -159,9 +161,7 @@ int AliHLTTPCCATracker::Reconstructor::execute()
     for ( unsigned int i = 0; i < numberOfHits; i += int_v::Size ) {
       const uint_v hitIndexes = uint_v( Vc::IndexesFromZero ) + i;
       int_v usedTemp;
-      for( unsigned int j = 0; j < float_v::Size; j++ ) {
-	usedTemp[j] = d->fData.HitDataIsUsed( row )[(unsigned int)hitIndexes[j]];
-      }
+      CAGatherScatter::Gather( usedTemp, d->fData.HitDataIsUsed( row ), hitIndexes, hitIndexes < numberOfHits );
       const int_m validHitsMask = (hitIndexes < numberOfHits) && (usedTemp == int_v( Vc::Zero ));
       d->fData.SetHitLinkUpData  ( row, hitIndexes, minusOne, validHitsMask );
       d->fData.SetHitLinkDownData( row, hitIndexes, minusOne, validHitsMask );
@@ -176,7 +176,8 @@ int AliHLTTPCCATracker::Reconstructor::execute()
     for ( unsigned int i = 0; i < numberOfHits; i += int_v::Size ) {
       const uint_v hitIndexes = uint_v( Vc::IndexesFromZero ) + i;
       const int_m validHitsMask = (hitIndexes < numberOfHits);
-      const int_v isUsed = int_v( d->fData.HitDataIsUsed( row ), static_cast<uint_v>(hitIndexes), validHitsMask);
+      int_v isUsed;
+      CAGatherScatter::Gather( isUsed, d->fData.HitDataIsUsed( row ), hitIndexes, validHitsMask );
        ASSERT( ((isUsed >= int_v( Vc::Zero )) && (isUsed <= int_v( 1 )) && validHitsMask) == validHitsMask,
               isUsed << validHitsMask);
     }
@@ -281,10 +282,12 @@ int AliHLTTPCCATracker::Reconstructor::execute()
     timer.Start();
 #endif // USE_TIMERS
 
+      // the candidates of the start hits are collected in the same pass, after the tracklets of the previous iterations
+    AliHLTTPCCAStartHitId *startHitCandidates = d->TrackletStartHits().data() + *d->NTracklets();
 #ifndef V6
-    AliHLTTPCCANeighboursCleaner::run( d->Param().NRows(), d->fData, d->Param() );
+    const int nStartHitCandidates = AliHLTTPCCANeighboursCleaner::run( d->Param().NRows(), d->fData, d->Param(), startHitCandidates );
 #else
-    AliHLTTPCCANeighboursCleaner::run( d->Param().NRows(), d->fData, d->Param(), iter, save_up_links );
+    const int nStartHitCandidates = AliHLTTPCCANeighboursCleaner::run( d->Param().NRows(), d->fData, d->Param(), iter, save_up_links, startHitCandidates );
 #endif
     
 #ifdef USE_TIMERS
@@ -372,7 +375,7 @@ int AliHLTTPCCATracker::Reconstructor::execute()
     timer.Start();
 #endif // USE_TIMERS
     
-    AliHLTTPCCAStartHitsFinder::run( *d, d->fData, iter );
+    AliHLTTPCCAStartHitsFinder::run( *d, d->fData, iter, nStartHitCandidates );
 
 #ifdef USE_TIMERS
     timer.Stop();
@@ -424,7 +427,8 @@ int AliHLTTPCCATracker::Reconstructor::execute()
     for ( unsigned int i = 0; i < numberOfHits; i += int_v::Size ) {
       const uint_v hitIndexes = uint_v( Vc::IndexesFromZero ) + i;
       const int_m validHitsMask = (hitIndexes < numberOfHits);
-      const int_v isUsed = int_v( d->fData.HitDataIsUsed( row ), static_cast<uint_v>(hitIndexes), validHitsMask);
+      int_v isUsed;
+      CAGatherScatter::Gather( isUsed, d->fData.HitDataIsUsed( row ), hitIndexes, validHitsMask );
        ASSERT( ((isUsed >= int_v( Vc::Zero )) && (isUsed <= int_v( 1 )) && validHitsMask) == validHitsMask,
               isUsed << validHitsMask);
     }
@@ -432,12 +436,12 @@ int AliHLTTPCCATracker::Reconstructor::execute()
 #endif // NDEBUG
 
 #ifdef V7
-  d->fTrackletVectors.Resize( d->fData.NumberOfHits() / 10 + 5 );
+  d->ResizeTrackletVectors( d->fData.NumberOfHits() / 10 + 5 );
 #else
 #ifdef V6
-  d->fTrackletVectors.Resize( ( d->fNTracklets + save_up_links.size()/2 + int_v::Size - 1 ) / int_v::Size );
+  d->ResizeTrackletVectors( ( d->fNTracklets + save_up_links.size()/2 + int_v::Size - 1 ) / int_v::Size );
 #else
-  d->fTrackletVectors.Resize( ( d->fNTracklets + int_v::Size - 1 ) / int_v::Size);
+  d->ResizeTrackletVectors( ( d->fNTracklets + int_v::Size - 1 ) / int_v::Size);
 #endif
 #endif
 
@@ -451,6 +455,7 @@ int AliHLTTPCCATracker::Reconstructor::execute()
 #ifdef V7
   AliHLTTPCCATrackletConstructor( *d, d->fData, d->fTrackletVectors ).run(0, tracksSaved, -1);
 #else
+  AliHLTTPCCAStartHitsFinder::Order( *d, 0, *d->NTracklets() );
   AliHLTTPCCATrackletConstructor( *d, d->fData, d->fTrackletVectors ).run(0, tracksSaved);
 #endif
 
@@ -462,7 +467,8 @@ int AliHLTTPCCATracker::Reconstructor::execute()
     for ( unsigned int i = 0; i < numberOfHits; i += int_v::Size ) {
       const uint_v hitIndexes = uint_v( Vc::IndexesFromZero ) + i;
       const int_m validHitsMask = (hitIndexes < numberOfHits);
-      const int_v isUsed = int_v( d->fData.HitDataIsUsed( row ), static_cast<uint_v>(hitIndexes), validHitsMask);
+      int_v isUsed;
+      CAGatherScatter::Gather( isUsed, d->fData.HitDataIsUsed( row ), hitIndexes, validHitsMask );
       ASSERT( ((isUsed >= int_v( Vc::Zero )) && (isUsed <= int_v( 3 )) && validHitsMask) == validHitsMask,
       isUsed << validHitsMask);
     }
@@ -488,6 +494,7 @@ int AliHLTTPCCATracker::Reconstructor::execute()
       nseeds++;
     }
   d->SetNTracklets(hitsStartOffset+nseeds);
+  AliHLTTPCCAStartHitsFinder::Order( *d, hitsStartOffset, hitsStartOffset + nseeds );
   AliHLTTPCCATrackletConstructor( *d, d->fData, d->fTrackletVectors ).run(0, tracksSaved);
 #endif
 
@@ -513,7 +520,7 @@ int AliHLTTPCCATracker::Reconstructor::execute()
     if ( file.is_open() ) {
       typedef std::list<AliHLTTPCCATracklet> TrackletList;
       TrackletList sortedTracklets;
-      for ( int i = 0; i < d->fTrackletVectors.Size(); ++i ) {
+      for ( int i = 0; i < d->fNTrackletVectors; ++i ) {
         const TrackletVector &tv = d->fTrackletVectors[i];
         for ( int j = 0; j < uint_v::Size; ++j ) {
           if ( tv.NHits()[j] > 0 ) {
@@ -544,7 +551,7 @@ int AliHLTTPCCATracker::Reconstructor::execute()
 
   d->fNumberOfTracks = tracksSaved;
 
-  AliHLTTPCCATrackletSelector( *d, &d->fTracks, &d->fNTrackHits, &d->fNumberOfTracks, d->fData, d->fTrackletVectors ).run();
+  AliHLTTPCCATrackletSelector( *d, &d->fTracks, &d->fTrackHitIds, &d->fNTrackHits, &d->fNumberOfTracks, d->fData, d->fTrackletVectors ).run();
   
 #ifdef USE_TIMERS
   tsc.Stop();
@@ -555,7 +562,7 @@ int AliHLTTPCCATracker::Reconstructor::execute()
 
   {
     d->RecalculateTrackMemorySize( d->fNTracklets, d->fNTrackHits ); // to calculate the size
-    d->fTrackMemory = new char[d->fTrackMemorySize + 1600]; // TODO rid of 1600
+    d->AllocateTrackMemory();
     d->SetPointersTracks( d->fNTracklets, d->fNTrackHits ); // set pointers for hits
   }
   d->WriteOutput();
@@ -194,23 +194,23 @@ void AliHLTTPCCASliceLinksPerformance::CollectTracks()
     recoTrack.hits.clear();
     int iHit = startHits[iTr].fHit;
     int iRow = startHits[iTr].fRow;
-    AliHLTTPCCARow row = data.Row( iRow );
+    const AliHLTTPCCARow *row = &data.Row( iRow );
 
-    int iHitGB = firstSliceHit + data.ClusterDataIndex( row, iHit ); // firstSliceHit + iHit + clusterData.RowOffset( iRow )
+    int iHitGB = firstSliceHit + data.ClusterDataIndex( *row, iHit ); // firstSliceHit + iHit + clusterData.RowOffset( iRow )
     assert ( iHitGB < endSliceHit );
     recoTrack.hits.push_back( iHitGB );
        
-    int iUpHit = data.HitLinkUpDataS( row, iHit );
+    int iUpHit = data.HitLinkUpDataS( *row, iHit );
     for(;iUpHit >= 0;) {
       iHit = iUpHit;
       iRow++;
-      row = data.Row( iRow );
+      row = &data.Row( iRow );
 
-      iHitGB = firstSliceHit + data.ClusterDataIndex( row, iHit );
+      iHitGB = firstSliceHit + data.ClusterDataIndex( *row, iHit );
       assert ( iHitGB < endSliceHit );
       recoTrack.hits.push_back( iHitGB );
          
-      iUpHit = data.HitLinkUpDataS( row, iHit );
+      iUpHit = data.HitLinkUpDataS( *row, iHit );
     }
 
     fRecoTracks.push_back(recoTrack);
@@ -26,6 +26,7 @@
 #include "AliHLTTPCCAGBHit.h"
 #include "AliHLTTPCCAOutTrack.h"
 #include "AliHLTArray.h"
+#include "AliHLTTPCCAEventFile.h"
 #include <algorithm>
 #include <fstream>
 using std::ofstream;
@@ -98,8 +99,16 @@ void AliHLTTPCCAInputData::SetHits( const AliHLTTPCCAGBHit *hits, int nHits )
   }
 } // need for StRoot
 
+void AliHLTTPCCAInputData::SetHits( const AliHLTTPCCAEventFile &event )
+{
+  SetNHits( event.NHits() );
+  event.GetHits( fHits.Data() );
+}
+
 bool AliHLTTPCCAInputData::ReadHitsFromFile(string prefix)
 {
+    if ( ReadHitsFromBinaryFile( prefix ) ) return 1;
+
     ifstream ifile((prefix+"hits.data").data());
     if ( !ifile.is_open() ) return 0;
     int Size;
@@ -113,3 +122,11 @@ bool AliHLTTPCCAInputData::ReadHitsFromFile(string prefix)
     ifile.close();
     return 1;
 }
+
+bool AliHLTTPCCAInputData::ReadHitsFromBinaryFile(string prefix)
+{
+  AliHLTTPCCAEventFile event;
+  if ( !event.Open( prefix+"hits.bin" ) ) return 0;
+  SetHits( event );
+  return 1;
+}
@@ -40,6 +40,7 @@
 using std::string;
 
 class AliHLTTPCCAMerger;
+class AliHLTTPCCAEventFile;
 
 /**
  * @class AliHLTTPCCAInputData
@@ -71,10 +72,12 @@ class AliHLTTPCCAInputData
 
     void ReadEvent( FILE *in );
 
-    bool ReadHitsFromFile( string prefix );
+    bool ReadHitsFromFile( string prefix ); // Read "hits.bin" if it exists, "hits.data" otherwise
+    bool ReadHitsFromBinaryFile( string prefix );
 
     void SetHits( std::vector<AliHLTTPCCAGBHit> &hits);     // need for StRoot
     void SetHits( const AliHLTTPCCAGBHit *hits, int nHits );
+    void SetHits( const AliHLTTPCCAEventFile &event );
     int  GetHitsSize() const {return fHits.Size();}
 
       /// Try to group close hits in row formed by one track. After sort hits.
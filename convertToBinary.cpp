@@ -22,96 +22,90 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+/// Convert the text hit files of the events into the binary format (see AliHLTTPCCAEventFile)
+  /// to run:  ./convertToBinary NEvents InputDir [OutputDir] [-archive ArchiveFile]
+  /// reads InputDir/eventN_hits.data and writes OutputDir/eventN_hits.bin, N = 0..NEvents-1,
+  /// or all events into one ArchiveFile (see AliHLTTPCCAEventArchive) if -archive is given
+
 #define HLTCA_STANDALONE
 #include <AliHLTTPCCAGBHit.h>
-#include <AliHLTTPCCAMCTrack.h>
-#include <AliHLTTPCCAPerformance.h>
-#include <AliHLTArray.h>
+#include <AliHLTTPCCAEventFile.h>
+#include <AliHLTTPCCAEventArchive.h>
 #include <fstream>
+#include <iostream>
+#include <vector>
+#include <string>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
 
-int main()
+static bool ReadHitsFromFile( const string &prefix, vector<AliHLTTPCCAGBHit> &hits )
 {
-  char name[255];
-  for ( int i = 0; i < 100; ++i ) {
-#ifdef HIT_CONVERT
-    sprintf( name, "Events/%i.event.dat", i );
-#else
-    sprintf( name, "Events/%i.mcevent.dat", i );
-#endif
-    std::fstream file;
-    file.open( name, std::ios::in );
-    if ( !file.is_open() ) {
-      return 1;
+  ifstream ifile( ( prefix + "hits.data" ).data() );
+  if ( !ifile.is_open() ) return 0;
+  int Size;
+  ifile >> Size;
+  hits.resize( Size );
+  for ( int i = 0; i < Size; i++ ) {
+    ifile >> hits[i];
+  }
+  return !ifile.fail();
+}
+
+int main( int argc, char *argv[] )
+{
+  vector<string> args;
+  string archiveName;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( !std::strcmp( argv[i], "-archive" ) && ++i < argc ) {
+      archiveName = argv[i];
+    } else {
+      args.push_back( argv[i] );
     }
+  }
+  if ( args.size() < 2 ) {
+    std::cout << "Usage: " << argv[0] << " NEvents InputDir [OutputDir] [-archive ArchiveFile]" << std::endl;
+    return 1;
+  }
+  const int NEvents = atoi( args[0].data() );
+  const string inDir = args[1] + "/";
+  const string outDir = ( args.size() >= 3 ) ? args[2] + "/" : inDir;
+
+  AliHLTTPCCAEventArchive archive;
+  if ( !archiveName.empty() && !archive.Create( archiveName ) ) {
+    std::cout << "Archive " << archiveName << " can't be created." << std::endl;
+    return 1;
+  }
+
+  vector<AliHLTTPCCAGBHit> hits;
+  for ( int iEvent = 0; iEvent < NEvents; iEvent++ ) {
+    char buf[12];
+    sprintf( buf, "%d", iEvent );
+    const string name = string( "event" ) + string( buf ) + string( "_" );
 
-#ifdef HIT_CONVERT
-    int nHits;
-    file >> nHits;
-    AliHLTResizableArray<AliHLTTPCCAGBHit> sliceData( nHits );
-    int hitIndex = 0;
-    AliHLTTPCCAGBHit hit;
-    hit.SetIsUsed( 0 );
-    for ( int j = 0; j < nHits; ++j ) {
-      float tmp;
-      int itmp;
-      file >> tmp; hit.SetX( tmp );
-      file >> tmp; hit.SetY( tmp );
-      file >> tmp; hit.SetZ( tmp );
-      file >> tmp; hit.SetErrY( tmp );
-      file >> tmp; hit.SetErrZ( tmp );
-      file >> tmp; hit.SetAmp( tmp );
-      file >> itmp; hit.SetID( itmp );
-      file >> itmp; hit.SetISlice( itmp );
-      file >> itmp; hit.SetIRow( itmp );
-      sliceData[hitIndex++] = hit;
+    if ( !ReadHitsFromFile( inDir + name, hits ) ) {
+      std::cout << "Hits for event " << iEvent << " can't be read from " << inDir + name << "hits.data" << std::endl;
+      return 1;
     }
-#else
-    int n1, n2;
-    file >> n1;
-    AliHLTResizableArray<AliHLTTPCCAMCTrack> fMCTracks( n1 );
-    for ( int j = 0; j < n1; ++j ) {
-      AliHLTTPCCAMCTrack &t = fMCTracks[j];
-      int k;
-      float f;
-      file >> k;
-      file >> k; t.SetPDG( k );
-      for ( int l = 0; l < 7; l++ ) { file >> f; t.SetPar( l, f );}
-      for ( int l = 0; l < 7; l++ ) { file >> f; t.SetTPCPar( l, f );}
-      file >> f; t.SetP( f );
-      file >> f; t.SetPt( f );
-      file >> k; t.SetNHits( k );
-      file >> k; t.SetNMCPoints( k );
-      file >> k; t.SetFirstMCPointID( k );
-      file >> k; t.SetNReconstructed( k );
-      file >> k; t.SetSet( k );
-      file >> k; t.SetNTurns( k );
+    const AliHLTTPCCAGBHit *data = hits.empty() ? 0 : &hits[0];
+    if ( !archiveName.empty() ) {
+      if ( !archive.AddEvent( data, hits.size() ) ) {
+        std::cout << "Hits for event " << iEvent << " can't be written to " << archiveName << std::endl;
+        return 1;
+      }
     }
-    file >> n2;
-    AliHLTResizableArray<AliHLTTPCCAPerformance::AliHLTTPCCAHitLabel> fHitLabels( n2 );
-    for ( int j = 0; j < n2; ++j ) {
-      AliHLTTPCCAPerformance::AliHLTTPCCAHitLabel &l = fHitLabels[j];
-      file >> l.fLab[0] >> l.fLab[1] >> l.fLab[2];
+    else if ( !AliHLTTPCCAEventFile::Write( outDir + name + "hits.bin", data, hits.size() ) ) {
+      std::cout << "Hits for event " << iEvent << " can't be written to " << outDir + name << "hits.bin" << std::endl;
+      return 1;
     }
-#endif
-    file.close();
+    std::cout << " Event " << iEvent << ": " << hits.size() << " hits converted." << std::endl;
+  }
 
-#ifdef HIT_CONVERT
-    sprintf( name, "Events/%i.bin", i );
-#else
-    sprintf( name, "Events/%i.mc.bin", i );
-#endif
-    FILE *f = std::fopen( name, "wb" );
-#ifdef HIT_CONVERT
-    std::fwrite( &nHits, sizeof( int ), 1, f );
-    std::fwrite( sliceData.Data(), sizeof( AliHLTTPCCAGBHit ), nHits, f );
-#else
-    std::fwrite( &n1, sizeof( int ), 1, f );
-    std::fwrite( &n2, sizeof( int ), 1, f );
-    std::fwrite( fMCTracks.Data(), sizeof( AliHLTTPCCAMCTrack ), fMCTracks.Size(), f );
-    std::fwrite( fHitLabels.Data(), sizeof( AliHLTTPCCAPerformance::AliHLTTPCCAHitLabel ), fHitLabels.Size(), f );
-#endif
-    std::fflush( f );
-    std::fclose( f );
+  if ( !archiveName.empty() && !archive.Finish() ) {
+    std::cout << "Archive " << archiveName << " can't be written." << std::endl;
+    return 1;
   }
+  return 0;
 }
@@ -0,0 +1,131 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// Microbenchmark of the NeighboursFinder, e.g. to compare the builds with and without the hardware
+/// gathers (VC_NO_GATHER_TRICKS, see AliHLTTPCCAGatherScatter.h)
+  /// to run:  ./neighboursBenchmark NEvents InputDir [-repeat N] [-dense]
+  /// reads InputDir/settings.data and InputDir/eventN_hits.bin (or .data), N = 0..NEvents-1, reconstructs
+  /// each event once to get the slice data and then runs the first NeighboursFinder iteration N times on each slice,
+  /// with -dense the kernel evaluating all neighbour candidates (AliHLTTPCCATracker::SetDenseNeighboursFinder)
+
+#define HLTCA_STANDALONE
+#include <AliHLTTPCCAGBTracker.h>
+#include <AliHLTTPCCATracker.h>
+#include <AliHLTTPCCASliceDataVector.h>
+#include <AliHLTTPCCANeighboursFinder.h>
+#include <Stopwatch.h>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+int main( int argc, char *argv[] )
+{
+  vector<string> args;
+  int nRepeat = 100;
+  bool isDense = false;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( !std::strcmp( argv[i], "-repeat" ) && ++i < argc ) {
+      nRepeat = atoi( argv[i] );
+    } else if ( !std::strcmp( argv[i], "-dense" ) ) {
+      isDense = true;
+    } else {
+      args.push_back( argv[i] );
+    }
+  }
+  if ( args.size() < 2 || nRepeat < 1 ) {
+    std::cout << "Usage: " << argv[0] << " NEvents InputDir [-repeat N] [-dense]" << std::endl;
+    return 1;
+  }
+  const int NEvents = atoi( args[0].data() );
+  const string inDir = args[1] + "/";
+
+  AliHLTTPCCAGBTracker tracker;
+  tracker.SetNThreads( 1 );
+  tracker.Init();
+  if ( !tracker.ReadSettingsFromFile( inDir ) ) {
+    std::cout << "Settings can't be read from " << inDir << "settings.data" << std::endl;
+    return 1;
+  }
+
+  AliHLTTPCCASliceData data; // own copy of the slice data, the one of the slice tracker is not modified
+  double time = 0;
+  long nHits = 0;
+  long nTruncations = 0;
+  for ( int iEvent = 0; iEvent < NEvents; iEvent++ ) {
+    char buf[12];
+    sprintf( buf, "%d", iEvent );
+    const string name = string( "event" ) + string( buf ) + string( "_" );
+    if ( !tracker.ReadHitsFromFile( inDir + name ) ) {
+      std::cout << "Hits for event " << iEvent << " can't be read from " << inDir + name << std::endl;
+      return 1;
+    }
+    tracker.FindTracks();
+    tracker.SetDenseNeighboursFinder( isDense );
+
+    double eventTime = 0;
+    long eventHits = 0;
+    for ( int iSlice = 0; iSlice < tracker.NSlices(); iSlice++ ) {
+      AliHLTTPCCATracker &slice = tracker.Slices()[iSlice];
+      if ( slice.Data().NumberOfHits() == 0 ) continue;
+      data.InitializeRows( slice.Param() );
+      for ( int iRow = 0; iRow < slice.Param().NRows(); iRow++ ) {
+        data.SetGridCreationCoeff( iRow, slice.Data().GridCreationCoeff( iRow ) );
+      }
+      data.InitFromClusterData( slice.ClusterData() );
+      for ( int iRow = 0; iRow < slice.Param().NRows(); iRow++ ) {
+        data.CleanUsedHits( iRow, 1 );
+      }
+
+      const int nTruncationsBefore = slice.NNeighbourTruncations(); // the finder adds to the counter of the event
+      Stopwatch timer;
+      timer.Start();
+      for ( int iRepeat = 0; iRepeat < nRepeat; iRepeat++ ) {
+        AliHLTTPCCATracker::NeighboursFinder( &slice, data, 0 ).execute();
+      }
+      timer.Stop();
+      nTruncations += ( slice.NNeighbourTruncations() - nTruncationsBefore ) / nRepeat;
+      eventTime += timer.RealTime();
+      eventHits += data.NumberOfHits();
+    }
+    std::cout << " Event " << iEvent << ": " << eventHits << " hits, "
+              << eventTime / nRepeat * 1.e3 << " ms per NeighboursFinder call for all slices" << std::endl;
+    time += eventTime;
+    nHits += eventHits;
+  }
+
+#ifdef VC_GATHER_SCATTER
+  std::cout << "Vc gathers, ";
+#else
+  std::cout << "scalar gathers, ";
+#endif
+  std::cout << ( isDense ? "dense kernel, " : "lane kernel, " ) << float_v::Size << " lanes: "
+            << ( nHits > 0 ? time / nRepeat / nHits * 1.e9 : 0. ) << " ns per hit, "
+            << nTruncations << " hits with more than " << int(AliHLTTPCCAParameters::MaxNeighboursUp) << " upper candidates" << std::endl;
+  return 0;
+}
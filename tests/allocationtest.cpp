@@ -0,0 +1,123 @@
+/*
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of
+    the License, or (at your option) version 3.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301, USA.
+
+*/
+
+#include "unittest.h"
+#include "trackerfixture.h"
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+static const int NSlices = 3;
+
+// a big event and a small one with the hits of the first tracks of the big one
+struct Events {
+  std::vector<AliHLTTPCCAParam> settings;
+  std::vector<AliHLTTPCCAGBHit> big, small;
+  int nWarmUpEvents; // events before the buffers are sized
+};
+static Events oneSlice, slices;
+
+// tracks from the origin on circles in the frames of the slices, every 3rd one with pt below the looper cut
+static void createEvents( Events &events, int nSlices, int nTracks )
+{
+  events.settings = createSettings( nSlices );
+    // the border candidates of a slice pair depend on the track positions, not only on their number,
+    // so the small event may need more of them than the big one
+  events.nWarmUpEvents = ( nSlices > 1 ) ? 2 : 1;
+  int id = 0;
+  for ( int iTrack = 0; iTrack < nTracks; ++iTrack ) {
+    const int nHits = addHelixTrack( events.big, ( iTrack % 3 ? 1.f : 6.f ) + ( std::rand() % 100 ) * 0.02f, iTrack % nSlices, id );
+    if ( iTrack < nTracks * 2 / 3 ) events.small.insert( events.small.end(), events.big.end() - nHits, events.big.end() );
+  }
+  std::random_shuffle( events.big.begin(), events.big.end() );
+  std::random_shuffle( events.small.begin(), events.small.end() );
+}
+
+// the first events size all the buffers of the tracker, the next ones have to reuse them
+static void checkSteadyState( const Events &events, int nThreads, int parallelTracklets = 0, bool refill = 0, bool dense = 0 )
+{
+  AliHLTTPCCAGBTracker tracker;
+  tracker.Init();
+  tracker.SetNThreads( nThreads );
+  tracker.SetParallelTrackletVectors( parallelTracklets );
+  tracker.SetRefillTrackletConstructor( refill );
+  tracker.SetDenseNeighboursFinder( dense );
+  tracker.SetSettings( events.settings );
+  for ( int iEvent = 0; iEvent < 6; ++iEvent ) {
+    tracker.SetHits( ( iEvent % 2 ) ? events.small : events.big );
+    tracker.FindTracks();
+    VERIFY( tracker.NTracks() > 10 );
+    if ( iEvent == 0 ) {
+      VERIFY( tracker.NAllocations() > 0 ); // the counter works
+    } else if ( iEvent >= events.nWarmUpEvents ) {
+      COMPARE( tracker.NAllocations(), 0l );
+    }
+  }
+}
+
+void testNoAllocationsSerial()
+{
+  checkSteadyState( oneSlice, 1 );
+}
+
+void testNoAllocationsThreads()
+{
+  checkSteadyState( oneSlice, 4 );
+}
+
+// the claims of the vectors of a wave keep their memory
+void testNoAllocationsParallelTracklets()
+{
+  checkSteadyState( oneSlice, 1, 4 );
+  checkSteadyState( oneSlice, 4, 4 );
+}
+
+// the refilled lanes take their memory and queues from the arena of the slice
+void testNoAllocationsRefill()
+{
+  checkSteadyState( oneSlice, 1, 0, 1 );
+  checkSteadyState( oneSlice, 4, 0, 1 );
+}
+
+// the candidates of the dense NeighboursFinder are kept by the thread, serial only: with more threads
+// a thread may see its biggest row in a later event
+void testNoAllocationsDense()
+{
+  checkSteadyState( oneSlice, 1, 0, 0, 1 );
+}
+
+// the slice tracks go through the merger and the looper merger of several slices
+void testNoAllocationsSlices()
+{
+  checkSteadyState( slices, 1 );
+  checkSteadyState( slices, 4 );
+}
+
+int main()
+{
+  std::srand( 11 );
+  createEvents( oneSlice, 1, 300 );
+  createEvents( slices, NSlices, 900 );
+  runTest( testNoAllocationsSerial );
+  runTest( testNoAllocationsThreads );
+  runTest( testNoAllocationsParallelTracklets );
+  runTest( testNoAllocationsRefill );
+  runTest( testNoAllocationsDense );
+  runTest( testNoAllocationsSlices );
+  return 0;
+}
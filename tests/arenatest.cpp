@@ -0,0 +1,101 @@
+/*
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of
+    the License, or (at your option) version 3.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301, USA.
+
+*/
+
+#include "unittest.h"
+#include <AliHLTTPCCAArena.h>
+#include <cstdint>
+
+struct Item {
+  Item(): fA( 7 ), fB( 0.5f ) {}
+  int fA;
+  float fB;
+};
+
+// an "event": allocations of different sizes, filled to check that they don't overlap
+static void fillEvent( AliHLTTPCCAArena &arena, int scale )
+{
+  int *ints[20];
+  for ( int i = 0; i < 20; ++i ) {
+    const int n = scale * ( 100 + 300 * i );
+    ints[i] = arena.Alloc<int>( n );
+    VERIFY( reinterpret_cast<uintptr_t>( ints[i] ) % AliHLTTPCCAArena::kAlignment == 0 );
+    for ( int j = 0; j < n; ++j ) ints[i][j] = i;
+  }
+  for ( int i = 0; i < 20; ++i ) {
+    const int n = scale * ( 100 + 300 * i );
+    for ( int j = 0; j < n; ++j ) COMPARE( ints[i][j], i );
+  }
+}
+
+void testAlloc()
+{
+  AliHLTTPCCAArena arena;
+  COMPARE( arena.Capacity(), size_t( 0 ) );
+  Item *items = arena.Alloc<Item>( 10 );
+  for ( int i = 0; i < 10; ++i ) {
+    COMPARE( items[i].fA, 7 );
+    COMPARE( items[i].fB, 0.5f );
+  }
+  VERIFY( arena.Used() >= 10 * sizeof( Item ) );
+  void *a = arena.AllocBytes( 0 );
+  void *b = arena.AllocBytes( 0 );
+  VERIFY( a != b ); // different objects get different addresses
+  char *c = static_cast<char *>( arena.AllocBytes( 1, 256 ) );
+  COMPARE( reinterpret_cast<uintptr_t>( c ) % 256, uintptr_t( 0 ) );
+    // bigger than the minimal block
+  const size_t nBig = AliHLTTPCCAArena::kMinBlockSize;
+  int *big = arena.Alloc<int>( nBig );
+  big[0] = 1; big[nBig - 1] = 2;
+  COMPARE( items[9].fA, 7 ); // the old blocks are still there
+  VERIFY( arena.Capacity() >= nBig * sizeof( int ) );
+  VERIFY( arena.HighWater() >= arena.Used() );
+}
+
+void testResetReusesMemory()
+{
+  AliHLTTPCCAArena arena;
+  fillEvent( arena, 10 );
+  const int nSystemAllocations = arena.NSystemAllocations();
+  const size_t capacity = arena.Capacity();
+  const size_t highWater = arena.HighWater();
+  VERIFY( nSystemAllocations > 1 ); // the event doesn't fit into the first block
+  for ( int iEvent = 0; iEvent < 5; ++iEvent ) {
+    arena.Reset();
+    COMPARE( arena.Used(), size_t( 0 ) );
+    fillEvent( arena, ( iEvent % 2 ) ? 10 : 3 ); // the same and a smaller event
+    COMPARE( arena.NSystemAllocations(), nSystemAllocations );
+    COMPARE( arena.Capacity(), capacity );
+    COMPARE( arena.HighWater(), highWater );
+  }
+    // a bigger event takes more memory, the following ones reuse it
+  arena.Reset();
+  fillEvent( arena, 20 );
+  VERIFY( arena.NSystemAllocations() > nSystemAllocations );
+  VERIFY( arena.HighWater() > highWater );
+  const int nSystemAllocations2 = arena.NSystemAllocations();
+  arena.Reset();
+  fillEvent( arena, 20 );
+  COMPARE( arena.NSystemAllocations(), nSystemAllocations2 );
+}
+
+int main()
+{
+  runTest( testAlloc );
+  runTest( testResetReusesMemory );
+  return 0;
+}
@@ -0,0 +1,95 @@
+/*
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of
+    the License, or (at your option) version 3.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301, USA.
+
+*/
+
+#include "unittest.h"
+#include "trackerfixture.h"
+#include <AliHLTTPCCAGBTrack.h>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+static const int BigRow = 20;
+static const int NNoiseHits = 70000; // more than the 16 bit row hits of the tracklets can index
+static const int NoiseID = 1000000;
+static std::vector<AliHLTTPCCAParam> settings;
+static std::vector<AliHLTTPCCAGBHit> hits;
+
+// straight tracks at positive z, and the noise of the big row at negative z, so the track hits of the
+// big row come after the noise in the grid order of the row and get row hit indices above 0xffff
+static void createEvent()
+{
+  settings = createSettings();
+
+  std::srand( 13 );
+  for ( int iTrack = 0; iTrack < 100; ++iTrack ) {
+    const float ty = ( std::rand() % 1000 - 500 ) * 0.0006f;
+    const float tz = 0.1f + ( std::rand() % 1000 ) * 0.0004f;
+    for ( int iRow = 0; iRow < NRows; ++iRow ) {
+      AliHLTTPCCAGBHit h;
+      h.SetX( rowX[iRow] );
+      h.SetY( ty * rowX[iRow] + ( std::rand() % 100 - 50 ) * 0.0005f );
+      h.SetZ( tz * rowX[iRow] + ( std::rand() % 100 - 50 ) * 0.0005f );
+      h.SetErrX( 0.1 ); h.SetErrY( 0.1 ); h.SetErrZ( 0.1 );
+      h.SetISlice( 0 );
+      h.SetIRow( iRow );
+      h.SetID( iTrack * NRows + iRow );
+      hits.push_back( h );
+    }
+  }
+  for ( int i = 0; i < NNoiseHits; ++i ) {
+    AliHLTTPCCAGBHit h;
+    h.SetX( rowX[BigRow] );
+    h.SetY( ( std::rand() % 10000 - 5000 ) * 0.0001f * 0.4f * rowX[BigRow] );
+    h.SetZ( -180.f + ( std::rand() % 10000 ) * 0.015f );
+    h.SetErrX( 0.1 ); h.SetErrY( 0.1 ); h.SetErrZ( 0.1 );
+    h.SetISlice( 0 );
+    h.SetIRow( BigRow );
+    h.SetID( NoiseID + i );
+    hits.push_back( h );
+  }
+  std::random_shuffle( hits.begin(), hits.end() );
+}
+
+// the hits of the big row are attached to the tracks with their full row hit index
+void testBigRow()
+{
+  AliHLTTPCCAGBTracker tracker;
+  tracker.Init();
+  tracker.SetSettings( settings );
+  tracker.SetHits( hits );
+  tracker.FindTracks();
+
+  VERIFY( tracker.NTracks() > 50 );
+  int nBigRowHits = 0;
+  for ( int iTr = 0; iTr < tracker.NTracks(); ++iTr ) {
+    const AliHLTTPCCAGBTrack &t = tracker.Track( iTr );
+    for ( int iH = 0; iH < t.NHits(); ++iH ) {
+      const AliHLTTPCCAGBHit &h = tracker.Hits()[tracker.TrackHit( t.FirstHitRef() + iH )];
+      VERIFY( h.ID() < NoiseID ); // a cut row hit index would point to the noise at the beginning of the row
+      if ( h.IRow() == BigRow ) nBigRowHits++;
+    }
+  }
+  VERIFY( nBigRowHits > 50 );
+}
+
+int main()
+{
+  createEvent();
+  runTest( testBigRow );
+  return 0;
+}
@@ -0,0 +1,214 @@
+/*
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of
+    the License, or (at your option) version 3.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301, USA.
+
+*/
+
+#include "unittest.h"
+#include <AliHLTTPCCAEventFile.h>
+#include <AliHLTTPCCAEventArchive.h>
+#include <AliHLTTPCCAGBHit.h>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+static const char *const eventFileName = "eventfiletest.bin";
+static const char *const archiveFileName = "eventfiletest_archive.bin";
+
+// random hits of nSlices slices with nRows rows, not sorted
+static std::vector<AliHLTTPCCAGBHit> createHits( int nHits, int nSlices, int nRows )
+{
+  std::vector<AliHLTTPCCAGBHit> hits( nHits );
+  for ( int i = 0; i < nHits; ++i ) {
+    AliHLTTPCCAGBHit &h = hits[i];
+    h.SetX( 60.f + ( std::rand() % 1000 ) * 0.1f );
+    h.SetY( ( std::rand() % 1000 - 500 ) * 0.05f );
+    h.SetZ( ( std::rand() % 1000 - 500 ) * 0.4f );
+    h.SetErrX( 0.1f ); h.SetErrY( 0.01f * ( 1 + std::rand() % 10 ) ); h.SetErrZ( 0.02f * ( 1 + std::rand() % 10 ) );
+    h.SetAmp( std::rand() % 100 );
+    h.SetISlice( std::rand() % nSlices );
+    h.SetIRow( std::rand() % nRows );
+    h.SetID( i );
+    h.SetIsUsed( 0 );
+  }
+  return hits;
+}
+
+// the stored hits are the input hits ordered by AliHLTTPCCAGBHit::Compare
+static void compareEvent( const AliHLTTPCCAEventFile &event, std::vector<AliHLTTPCCAGBHit> hits )
+{
+  std::stable_sort( hits.begin(), hits.end(), AliHLTTPCCAGBHit::Compare );
+  const int nHits = hits.size();
+  COMPARE( event.NHits(), nHits );
+  std::vector<AliHLTTPCCAGBHit> read( nHits );
+  event.GetHits( &read[0] );
+  for ( int i = 0; i < nHits; ++i ) {
+    COMPARE( event.X()[i], hits[i].X() );
+    COMPARE( event.Y()[i], hits[i].Y() );
+    COMPARE( event.Z()[i], hits[i].Z() );
+    COMPARE( event.ErrY()[i], hits[i].ErrY() );
+    COMPARE( event.ErrZ()[i], hits[i].ErrZ() );
+    COMPARE( event.Amp()[i], hits[i].Amp() );
+    COMPARE( event.ISlice()[i], hits[i].ISlice() );
+    COMPARE( event.IRow()[i], hits[i].IRow() );
+    COMPARE( event.ID()[i], hits[i].ID() );
+    COMPARE( read[i].X(), hits[i].X() );
+    COMPARE( read[i].ErrX(), hits[i].ErrX() );
+    COMPARE( read[i].IRow(), hits[i].IRow() );
+    COMPARE( read[i].ID(), hits[i].ID() );
+  }
+    // the offset table gives the hits of each row of each slice
+  for ( int iSlice = 0; iSlice < event.NSlices(); ++iSlice ) {
+    for ( int iRow = 0; iRow < event.NRows(); ++iRow ) {
+      for ( int i = event.FirstHit( iSlice, iRow ); i < event.FirstHit( iSlice, iRow + 1 ); ++i ) {
+        COMPARE( event.ISlice()[i], iSlice );
+        COMPARE( event.IRow()[i], iRow );
+      }
+    }
+  }
+  COMPARE( event.FirstSliceHit( event.NSlices() ), nHits );
+}
+
+void testEventFileRoundTrip()
+{
+  const std::vector<AliHLTTPCCAGBHit> hits = createHits( 1000, 5, 20 );
+  VERIFY( AliHLTTPCCAEventFile::Write( eventFileName, &hits[0], hits.size() ) );
+
+  AliHLTTPCCAEventFile event;
+  VERIFY( event.Open( eventFileName ) );
+  COMPARE( event.NSlices(), 5 );
+  COMPARE( event.NRows(), 20 );
+  compareEvent( event, hits );
+  event.Close();
+  VERIFY( !event.IsOpen() );
+  std::remove( eventFileName );
+}
+
+void testEventFileRefusesOtherFiles()
+{
+  FILE *f = std::fopen( eventFileName, "wb" );
+  VERIFY( f );
+  const char text[] = "0 1 2 3 4 5 6 7 8 9 this is a text hits file and not an event image";
+  std::fwrite( text, 1, sizeof( text ), f );
+  std::fclose( f );
+  AliHLTTPCCAEventFile event;
+  VERIFY( !event.Open( eventFileName ) );
+  VERIFY( !event.IsOpen() );
+  std::remove( eventFileName );
+  VERIFY( !event.Open( eventFileName ) ); // no file at all
+}
+
+// a copy of the image with the header changed by the given functor is refused by Map
+template<typename F>
+static bool mapsChanged( const std::vector<long long> &image, long long size, F change )
+{
+  std::vector<long long> copy( image );
+  char *data = reinterpret_cast<char *>( &copy[0] );
+  change( *reinterpret_cast<AliHLTTPCCAEventFile::Header *>( data ), data );
+  AliHLTTPCCAEventFile event;
+  return event.Map( data, size );
+}
+
+struct NoChange { void operator()( AliHLTTPCCAEventFile::Header &, char * ) const {} };
+struct MisalignColumn { void operator()( AliHLTTPCCAEventFile::Header &h, char * ) const { h.fColumn[AliHLTTPCCAEventFile::kZ] += 2; } };
+struct MisalignTable { void operator()( AliHLTTPCCAEventFile::Header &h, char * ) const { h.fFirstHit += 1; } };
+struct OverflowTable { // 65536 * 65536 is 0 in int
+  void operator()( AliHLTTPCCAEventFile::Header &h, char * ) const { h.fNSlices = 65536; h.fNRows = 65536; }
+};
+struct UnorderedTable {
+  void operator()( AliHLTTPCCAEventFile::Header &h, char *data ) const {
+    int *firstHit = reinterpret_cast<int *>( data + h.fFirstHit );
+    firstHit[3] = firstHit[4] + 1;
+  }
+};
+struct TableAfterHits {
+  void operator()( AliHLTTPCCAEventFile::Header &h, char *data ) const {
+    int *firstHit = reinterpret_cast<int *>( data + h.fFirstHit );
+    firstHit[h.fNSlices * h.fNRows] = h.fNHits + 1;
+  }
+};
+
+void testEventFileRefusesBadHeaders()
+{
+  const std::vector<AliHLTTPCCAGBHit> hits = createHits( 500, 3, 10 );
+  VERIFY( AliHLTTPCCAEventFile::Write( eventFileName, &hits[0], hits.size() ) );
+  long long size = 0;
+  bool isMMapped = 0;
+  char *mapped = AliHLTTPCCAEventFile::MapFile( eventFileName, size, isMMapped );
+  VERIFY( mapped );
+  std::vector<long long> image( ( size + 7 ) / 8 ); // aligned copy of the image
+  std::copy( mapped, mapped + size, reinterpret_cast<char *>( &image[0] ) );
+  AliHLTTPCCAEventFile::UnmapFile( mapped, size, isMMapped );
+  std::remove( eventFileName );
+
+  VERIFY( mapsChanged( image, size, NoChange() ) );
+  VERIFY( !mapsChanged( image, size, MisalignColumn() ) );
+  VERIFY( !mapsChanged( image, size, MisalignTable() ) );
+  VERIFY( !mapsChanged( image, size, OverflowTable() ) );
+  VERIFY( !mapsChanged( image, size, UnorderedTable() ) );
+  VERIFY( !mapsChanged( image, size, TableAfterHits() ) );
+}
+
+void testArchiveRoundTrip()
+{
+  const int nEvents = 4;
+  std::vector<AliHLTTPCCAGBHit> hits[nEvents];
+  for ( int iEvent = 0; iEvent < nEvents; ++iEvent ) {
+    hits[iEvent] = createHits( 200 + 300 * iEvent, 1 + iEvent, 10 );
+  }
+
+  AliHLTTPCCAEventArchive writer;
+  VERIFY( writer.Create( archiveFileName ) );
+  for ( int iEvent = 0; iEvent < nEvents; ++iEvent ) {
+    VERIFY( writer.AddEvent( &hits[iEvent][0], hits[iEvent].size() ) );
+  }
+  VERIFY( writer.Finish() );
+
+  AliHLTTPCCAEventArchive archive;
+  VERIFY( archive.Open( archiveFileName ) );
+  COMPARE( archive.NEvents(), nEvents );
+    // random access, with the prefetch of the next event as in the standalone program
+  const int order[nEvents] = { 2, 0, 3, 1 };
+  for ( int i = 0; i < nEvents; ++i ) {
+    const int iEvent = order[i];
+    if ( i + 1 < nEvents ) archive.Prefetch( order[i + 1] );
+    AliHLTTPCCAEventFile event;
+    VERIFY( archive.GetEvent( iEvent, event ) );
+    COMPARE( event.NSlices(), 1 + iEvent );
+    compareEvent( event, hits[iEvent] );
+  }
+  archive.WaitPrefetch();
+  AliHLTTPCCAEventFile event;
+  VERIFY( !archive.GetEvent( nEvents, event ) );
+  archive.Close();
+    // the prefetch thread serves the archive opened again
+  VERIFY( archive.Open( archiveFileName ) );
+  for ( int iEvent = 0; iEvent <= nEvents; ++iEvent ) archive.Prefetch( iEvent ); // the last one is ignored
+  VERIFY( archive.GetEvent( nEvents - 1, event ) );
+  compareEvent( event, hits[nEvents - 1] );
+  archive.Close();
+  std::remove( archiveFileName );
+}
+
+int main()
+{
+  std::srand( 3 );
+  runTest( testEventFileRoundTrip );
+  runTest( testEventFileRefusesOtherFiles );
+  runTest( testEventFileRefusesBadHeaders );
+  runTest( testArchiveRoundTrip );
+  return 0;
+}
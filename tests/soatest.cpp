@@ -0,0 +1,164 @@
+/*
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of
+    the License, or (at your option) version 3.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301, USA.
+
+*/
+
+#include "unittest.h"
+#include "trackerfixture.h"
+#include <AliHLTTPCCAGBTrack.h>
+#include <AliHLTTPCCAEventFile.h>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+static std::vector<AliHLTTPCCAParam> settings;
+static std::vector<AliHLTTPCCAGBHit> hits;
+
+// tracks from the origin on circles in the slice frame, half of them with pt below the looper cut
+static void createEvent()
+{
+  settings = createSettings();
+  std::srand( 7 );
+  int id = 0;
+  for ( int iTrack = 0; iTrack < 200; ++iTrack ) {
+    addHelixTrack( hits, ( iTrack % 2 ? 1.f : 6.f ) + ( std::rand() % 100 ) * 0.02f, 0, id );
+  }
+  std::random_shuffle( hits.begin(), hits.end() ); // PrepareEvent and PrepareSlice have to order both inputs
+}
+
+void testSoAEqualsAoS()
+{
+  AliHLTTPCCAGBTracker aos;
+  aos.Init();
+  aos.SetSettings( settings );
+  aos.SetHits( hits );
+  aos.FindTracks();
+
+  const HitColumns columns( hits );
+  AliHLTTPCCAGBTracker soa;
+  soa.Init();
+  soa.SetSettings( settings );
+  columns.setHits( soa );
+  soa.FindTracks();
+
+  VERIFY( aos.NTracks() > 10 );
+  COMPARE( soa.NTracks(), aos.NTracks() );
+  int nLowPt = 0;
+  for ( int iTr = 0; iTr < aos.NTracks(); ++iTr ) {
+    const AliHLTTPCCAGBTrack &tA = aos.Track( iTr );
+    const AliHLTTPCCAGBTrack &tS = soa.Track( iTr );
+    COMPARE( tS.NHits(), tA.NHits() );
+    COMPARE( tS.Param().QPt(), tA.Param().QPt() );
+    if ( CAMath::Abs( tA.Param().QPt() ) > looperQPtCut ) ++nLowPt;
+    for ( int iH = 0; iH < tA.NHits(); ++iH ) {
+      // AoS: indices of the tracker hits, SoA: indices of the input columns
+      COMPARE( columns.id[soa.TrackHit( tS.FirstHitRef() + iH )], aos.Hits()[aos.TrackHit( tA.FirstHitRef() + iH )].ID() );
+    }
+  }
+  VERIFY( nLowPt > 0 ); // the looper merger has read the hits
+}
+
+// the hits with the slice or the row out of range are rejected, the tracks of the good hits are not changed
+void testBadHitsRejected()
+{
+  AliHLTTPCCAGBTracker ref;
+  ref.Init();
+  ref.SetSettings( settings );
+  ref.SetHits( hits );
+  ref.FindTracks();
+
+  std::vector<AliHLTTPCCAGBHit> badHits( hits );
+  const int badSlice[4] = { 1, -1, 100000, 0 };
+  const int badRow[4] = { 0, 0, 0, NRows };
+  for ( int i = 0; i < 4; ++i ) {
+    AliHLTTPCCAGBHit h = hits[i];
+    h.SetISlice( badSlice[i] );
+    h.SetIRow( badRow[i] );
+    badHits.insert( badHits.begin() + i * 100, h );
+  }
+  const HitColumns columns( badHits );
+
+  AliHLTTPCCAGBTracker aos;
+  aos.Init();
+  aos.SetSettings( settings );
+  aos.SetHits( badHits );
+  aos.FindTracks();
+  COMPARE( aos.NHits(), int( hits.size() ) );
+  COMPARE( aos.NTracks(), ref.NTracks() );
+
+  AliHLTTPCCAGBTracker soa;
+  soa.Init();
+  soa.SetSettings( settings );
+  columns.setHits( soa );
+  soa.FindTracks();
+  COMPARE( soa.NHits(), int( hits.size() ) );
+  COMPARE( soa.NTracks(), ref.NTracks() );
+  for ( int iTr = 0; iTr < soa.NTracks(); ++iTr ) {
+    const AliHLTTPCCAGBTrack &t = soa.Track( iTr );
+    for ( int iH = 0; iH < t.NHits(); ++iH ) {
+      const int iHit = soa.TrackHit( t.FirstHitRef() + iH );
+      VERIFY( columns.iSlice[iHit] == 0 && columns.iRow[iHit] >= 0 && columns.iRow[iHit] < NRows );
+    }
+  }
+}
+
+// the dump of the SoA input has the hits of the AoS dump
+void testSoADump()
+{
+  const HitColumns columns( hits );
+  {
+    AliHLTTPCCAGBTracker aos;
+    aos.Init();
+    aos.SetSettings( settings );
+    aos.SetDumpPolicy( AliHLTTPCCAEventDumper::kEveryNth, 1, "soatest_aos_" );
+    aos.SetHits( hits );
+    aos.FindTracks();
+    AliHLTTPCCAGBTracker soa;
+    soa.Init();
+    soa.SetSettings( settings );
+    soa.SetDumpPolicy( AliHLTTPCCAEventDumper::kEveryNth, 1, "soatest_soa_" );
+    columns.setHits( soa );
+    soa.FindTracks();
+  } // the trackers wait for the writes
+
+  AliHLTTPCCAEventFile aosEvent, soaEvent;
+  VERIFY( aosEvent.Open( "soatest_aos_event1_hits.bin" ) );
+  VERIFY( soaEvent.Open( "soatest_soa_event1_hits.bin" ) );
+  const int nHits = hits.size();
+  COMPARE( soaEvent.NHits(), nHits );
+  COMPARE( soaEvent.NHits(), aosEvent.NHits() );
+  for ( int i = 0; i < nHits; ++i ) { // both are stored in the order of AliHLTTPCCAGBHit::Compare
+    COMPARE( soaEvent.ID()[i], aosEvent.ID()[i] );
+    COMPARE( soaEvent.X()[i], aosEvent.X()[i] );
+    COMPARE( soaEvent.Y()[i], aosEvent.Y()[i] );
+    COMPARE( soaEvent.Z()[i], aosEvent.Z()[i] );
+    COMPARE( soaEvent.IRow()[i], aosEvent.IRow()[i] );
+  }
+  aosEvent.Close();
+  soaEvent.Close();
+  std::remove( "soatest_aos_event1_hits.bin" );
+  std::remove( "soatest_soa_event1_hits.bin" );
+}
+
+int main()
+{
+  createEvent();
+  runTest( testSoAEqualsAoS );
+  runTest( testBadHitsRejected );
+  runTest( testSoADump );
+  return 0;
+}
@@ -0,0 +1,144 @@
+/*
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of
+    the License, or (at your option) version 3.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301, USA.
+
+*/
+
+#include "unittest.h"
+#include "trackerfixture.h"
+#include <AliHLTTPCCATracker.h>
+#include <AliHLTTPCCAClusterData.h>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+static const int NSlices = 3;
+static std::vector<AliHLTTPCCAParam> settings;
+
+// hits with different z, so the order of AliHLTTPCCAGBHit::Compare is unique
+static std::vector<AliHLTTPCCAGBHit> createHits( int nHits )
+{
+  std::vector<int> zRank( nHits );
+  for ( int i = 0; i < nHits; ++i ) zRank[i] = i;
+  std::random_shuffle( zRank.begin(), zRank.end() );
+  std::vector<AliHLTTPCCAGBHit> hits( nHits );
+  for ( int i = 0; i < nHits; ++i ) {
+    AliHLTTPCCAGBHit &h = hits[i];
+    h.SetIRow( std::rand() % NRows );
+    h.SetISlice( std::rand() % NSlices );
+    h.SetX( rowX[h.IRow()] );
+    h.SetY( ( std::rand() % 1000 - 500 ) * 0.04f );
+    h.SetZ( -190.f + 380.f * zRank[i] / nHits );
+    h.SetErrX( 0.1 ); h.SetErrY( 0.1 ); h.SetErrZ( 0.1 );
+    h.SetID( i );
+  }
+  return hits;
+}
+
+// IDs of the hits in the order of std::sort with AliHLTTPCCAGBHit::Compare
+static std::vector<int> sortedIDs( std::vector<AliHLTTPCCAGBHit> hits )
+{
+  std::sort( hits.begin(), hits.end(), AliHLTTPCCAGBHit::Compare );
+  std::vector<int> ids( hits.size() );
+  for ( unsigned int i = 0; i < hits.size(); ++i ) ids[i] = hits[i].ID();
+  return ids;
+}
+
+// the cluster data of the slices, filled by PrepareSlice, has to follow the std::sort order
+static void compareClusterData( AliHLTTPCCAGBTracker &tracker, const std::vector<int> &ids )
+{
+  tracker.PrepareEvent();
+  int iHit = 0;
+  for ( int iSlice = 0; iSlice < NSlices; ++iSlice ) {
+    tracker.PrepareSlice( iSlice );
+    const AliHLTTPCCAClusterData &data = tracker.Slice( iSlice ).ClusterData();
+    COMPARE( data.Slice(), iSlice );
+    for ( int i = 0; i < data.NumberOfClusters(); ++i ) {
+      const int id = ids[iHit];
+      COMPARE( data.Id( i ), id );
+      iHit++;
+    }
+  }
+  COMPARE( iHit, static_cast<int>( ids.size() ) );
+}
+
+static void checkAoS( const std::vector<AliHLTTPCCAGBHit> &hits )
+{
+  const std::vector<int> ids = sortedIDs( hits );
+  AliHLTTPCCAGBTracker tracker;
+  tracker.SetSettings( settings );
+  tracker.SetHits( hits );
+  compareClusterData( tracker, ids );
+  for ( unsigned int i = 0; i < hits.size(); ++i ) COMPARE( tracker.Hits()[i].ID(), ids[i] ); // the hits are moved too
+}
+
+static void checkSoA( const std::vector<AliHLTTPCCAGBHit> &hits )
+{
+  const std::vector<int> ids = sortedIDs( hits );
+  const HitColumns columns( hits );
+  AliHLTTPCCAGBTracker tracker;
+  tracker.SetSettings( settings );
+  columns.setHits( tracker );
+  compareClusterData( tracker, ids );
+}
+
+void testShuffledHits()
+{
+  const std::vector<AliHLTTPCCAGBHit> hits = createHits( 5000 );
+  checkAoS( hits );
+  checkSoA( hits );
+}
+
+void testSortedHits()
+{
+  std::vector<AliHLTTPCCAGBHit> hits = createHits( 3000 );
+  std::sort( hits.begin(), hits.end(), AliHLTTPCCAGBHit::Compare );
+  checkAoS( hits );
+  checkSoA( hits );
+}
+
+static bool SliceRowLess( const AliHLTTPCCAGBHit &a, const AliHLTTPCCAGBHit &b )
+{
+  if ( a.ISlice() != b.ISlice() ) return a.ISlice() < b.ISlice();
+  return a.IRow() < b.IRow();
+}
+
+// sorted by slice and row, but not by z inside the rows
+void testRowSortedHits()
+{
+  std::vector<AliHLTTPCCAGBHit> hits = createHits( 3000 );
+  std::sort( hits.begin(), hits.end(), SliceRowLess );
+  checkAoS( hits );
+  checkSoA( hits );
+}
+
+// few hits, most of the rows are empty
+void testSparseHits()
+{
+  const std::vector<AliHLTTPCCAGBHit> hits = createHits( 20 );
+  checkAoS( hits );
+  checkSoA( hits );
+}
+
+int main()
+{
+  std::srand( 5 );
+  settings = createSettings( NSlices );
+  runTest( testShuffledHits );
+  runTest( testSortedHits );
+  runTest( testRowSortedHits );
+  runTest( testSparseHits );
+  return 0;
+}
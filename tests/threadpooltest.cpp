@@ -0,0 +1,166 @@
+/*
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of
+    the License, or (at your option) version 3.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301, USA.
+
+*/
+
+#include "unittest.h"
+#include <AliHLTTPCCAThreadPool.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+// counts how often each task is executed
+class CountTasks
+{
+    std::atomic<int> *fCounts;
+  public:
+    CountTasks( std::atomic<int> *counts ): fCounts( counts ) {}
+    void operator()( int i ) const { fCounts[i]++; }
+};
+
+// counts the tasks which know that they are run by a pool
+class CountInside
+{
+    std::atomic<int> &fN;
+  public:
+    CountInside( std::atomic<int> &n ): fN( n ) {}
+    void operator()( int ) const { if ( AliHLTTPCCAThreadPool::InsideTask() ) fN++; }
+};
+
+static void checkAllOnce( int nThreads, int nTasks )
+{
+  AliHLTTPCCAThreadPool pool( nThreads );
+  COMPARE( pool.NThreads(), nThreads );
+  std::vector<std::atomic<int> > counts( nTasks + 1 );
+  for ( int iJob = 0; iJob < 3; ++iJob ) { // the pool is reused by the next jobs
+    for ( int i = 0; i <= nTasks; ++i ) counts[i] = 0;
+    pool.ParallelFor( nTasks, CountTasks( &counts[0] ) );
+    for ( int i = 0; i < nTasks; ++i ) COMPARE( counts[i].load(), 1 );
+    COMPARE( counts[nTasks].load(), 0 );
+  }
+}
+
+void testEachTaskOnce()
+{
+  const int nThreads[] = { 1, 2, 4 };
+  const int nTasks[] = { 0, 1, 3, 7, 1000 };
+  for ( int iT = 0; iT < 3; ++iT ) {
+    for ( int iN = 0; iN < 5; ++iN ) checkAllOnce( nThreads[iT], nTasks[iN] );
+  }
+}
+
+void testInsideTask()
+{
+  AliHLTTPCCAThreadPool pool( 3 );
+  VERIFY( !AliHLTTPCCAThreadPool::InsideTask() );
+  std::atomic<int> nInside( 0 );
+  pool.ParallelFor( 30, CountInside( nInside ) );
+  COMPARE( nInside.load(), 30 );
+  VERIFY( !AliHLTTPCCAThreadPool::InsideTask() );
+}
+
+static void runJobs( AliHLTTPCCAThreadPool *pool, int nJobs, int nTasks, std::atomic<int> *counts )
+{
+  for ( int iJob = 0; iJob < nJobs; ++iJob ) pool->ParallelFor( nTasks, CountTasks( counts ) );
+}
+
+// a job started by another thread while the pool is busy is run serially by that thread
+void testConcurrentCallers()
+{
+  AliHLTTPCCAThreadPool pool( 4 );
+  const int nTasks = 200;
+  std::vector<std::atomic<int> > counts1( nTasks ), counts2( nTasks );
+  for ( int i = 0; i < nTasks; ++i ) { counts1[i] = 0; counts2[i] = 0; }
+  std::thread other( runJobs, &pool, 20, nTasks, &counts2[0] );
+  runJobs( &pool, 20, nTasks, &counts1[0] );
+  other.join();
+  for ( int i = 0; i < nTasks; ++i ) {
+    COMPARE( counts1[i].load(), 20 );
+    COMPARE( counts2[i].load(), 20 );
+  }
+}
+
+// every outer task starts a nested job of nInner tasks
+class NestedJobs
+{
+    AliHLTTPCCAThreadPool &fPool;
+    std::atomic<int> *fCounts;
+    int fNInner;
+  public:
+    NestedJobs( AliHLTTPCCAThreadPool &pool, std::atomic<int> *counts, int nInner ): fPool( pool ), fCounts( counts ), fNInner( nInner ) {}
+    void operator()( int i ) const { fPool.ParallelFor( fNInner, CountTasks( fCounts + i * fNInner ) ); }
+};
+
+void testNestedJobs()
+{
+  const int nThreads[] = { 1, 2, 4 };
+  const int nOuter = 13, nInner = 45; // the slices and their rows
+  for ( int iT = 0; iT < 3; ++iT ) {
+    AliHLTTPCCAThreadPool pool( nThreads[iT] );
+    std::vector<std::atomic<int> > counts( nOuter * nInner );
+    for ( int iJob = 0; iJob < 3; ++iJob ) {
+      for ( int i = 0; i < nOuter * nInner; ++i ) counts[i] = 0;
+      pool.ParallelFor( nOuter, NestedJobs( pool, &counts[0], nInner ) );
+      for ( int i = 0; i < nOuter * nInner; ++i ) COMPARE( counts[i].load(), 1 );
+    }
+  }
+}
+
+// records the threads which run the tasks, the tasks are slow enough to let the other threads wake up
+class SlowTask
+{
+    std::mutex &fMutex;
+    std::set<std::thread::id> &fThreads;
+  public:
+    SlowTask( std::mutex &m, std::set<std::thread::id> &threads ): fMutex( m ), fThreads( threads ) {}
+    void operator()( int ) const {
+      std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+      std::lock_guard<std::mutex> lock( fMutex );
+      fThreads.insert( std::this_thread::get_id() );
+    }
+};
+
+// one busy outer task: the threads which have finished their outer tasks join its nested job
+class OneBusyTask
+{
+    AliHLTTPCCAThreadPool &fPool;
+    SlowTask fInner;
+  public:
+    OneBusyTask( AliHLTTPCCAThreadPool &pool, const SlowTask &inner ): fPool( pool ), fInner( inner ) {}
+    void operator()( int i ) const { if ( i == 0 ) fPool.ParallelFor( 64, fInner ); }
+};
+
+void testNestedJobIsShared()
+{
+  AliHLTTPCCAThreadPool pool( 4 );
+  std::mutex m;
+  std::set<std::thread::id> threads;
+  pool.ParallelFor( 4, OneBusyTask( pool, SlowTask( m, threads ) ) );
+  VERIFY( threads.size() > 1 );
+}
+
+int main()
+{
+  runTest( testEachTaskOnce );
+  runTest( testInsideTask );
+  runTest( testConcurrentCallers );
+  runTest( testNestedJobs );
+  runTest( testNestedJobIsShared );
+  return 0;
+}
@@ -0,0 +1,96 @@
+/*
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of
+    the License, or (at your option) version 3.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301, USA.
+
+*/
+
+#ifndef TRACKERFIXTURE_H
+#define TRACKERFIXTURE_H
+
+// the detector and the events shared by the tests of the whole tracker
+
+#include <AliHLTTPCCAGBTracker.h>
+#include <AliHLTTPCCAGBHit.h>
+#include <AliHLTTPCCAParam.h>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+
+static const int NRows = 45;
+static float rowX[NRows];
+
+// nSlices slices of 30 degrees with NRows rows at x = 60, 63, .., 192
+inline std::vector<AliHLTTPCCAParam> createSettings( int nSlices = 1 )
+{
+  for ( int i = 0; i < NRows; ++i ) rowX[i] = 60.f + i * 3.f;
+  std::vector<AliHLTTPCCAParam> settings( nSlices );
+  for ( int iSlice = 0; iSlice < nSlices; ++iSlice ) {
+    settings[iSlice].Initialize( iSlice, NRows, rowX, iSlice * 0.5236, 0.5236, 50, 200, -200, 200, 0.5, 0.2, 0.5 );
+    settings[iSlice].SetNInnerRows( NRows );
+    settings[iSlice].SetNTpcRows( NRows );
+  }
+  return settings;
+}
+
+// a track from the origin on a circle in the frame of slice iSlice with a random charge, direction and dip,
+// the hits are added until the track leaves the slice and get the IDs id, id+1, ..
+// returns the number of the added hits
+inline int addHelixTrack( std::vector<AliHLTTPCCAGBHit> &hits, float qPt, int iSlice, int &id )
+{
+  const float r = 1.f / ( qPt * 0.5f * 0.000299792458f ); // the radius in the field of the settings
+  const float q = ( std::rand() % 2 ) ? 1.f : -1.f;
+  const float phi = ( std::rand() % 1000 - 500 ) * 0.0004f;
+  const float tz = ( std::rand() % 1000 - 500 ) * 0.001f;
+  const float xc = -q * r * std::sin( phi ), yc = q * r * std::cos( phi );
+  int nHits = 0;
+  for ( int iRow = 0; iRow < NRows; ++iRow ) {
+    const float dx = rowX[iRow] - xc;
+    if ( dx * dx >= r * r ) break;
+    AliHLTTPCCAGBHit h;
+    h.SetX( rowX[iRow] );
+    h.SetY( yc - q * std::sqrt( r * r - dx * dx ) + ( std::rand() % 100 - 50 ) * 0.001f );
+    h.SetZ( tz * rowX[iRow] + ( std::rand() % 100 - 50 ) * 0.001f );
+    if ( CAMath::Abs( h.Y() ) > 0.4f * h.X() || CAMath::Abs( h.Z() ) > 190.f ) break;
+    h.SetErrX( 0.1 ); h.SetErrY( 0.1 ); h.SetErrZ( 0.1 );
+    h.SetISlice( iSlice );
+    h.SetIRow( iRow );
+    h.SetID( id++ );
+    hits.push_back( h );
+    nHits++;
+  }
+  return nHits;
+}
+
+// the hits as the columns of AliHLTTPCCAGBTracker::SetHitsSoA
+struct HitColumns {
+  std::vector<float> x, y, z;
+  std::vector<int> iSlice, iRow, id;
+
+  HitColumns( const std::vector<AliHLTTPCCAGBHit> &hits )
+      : x( hits.size() ), y( hits.size() ), z( hits.size() ), iSlice( hits.size() ), iRow( hits.size() ), id( hits.size() )
+  {
+    for ( unsigned int i = 0; i < hits.size(); ++i ) {
+      x[i] = hits[i].X(); y[i] = hits[i].Y(); z[i] = hits[i].Z();
+      iSlice[i] = hits[i].ISlice(); iRow[i] = hits[i].IRow(); id[i] = hits[i].ID();
+    }
+  }
+  int size() const { return x.size(); }
+  void setHits( AliHLTTPCCAGBTracker &tracker ) const
+  {
+    tracker.SetHitsSoA( size(), &x[0], &y[0], &z[0], &iSlice[0], &iRow[0], &id[0] );
+  }
+};
+
+#endif
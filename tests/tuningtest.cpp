@@ -0,0 +1,226 @@
+/*
+    This program is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License as
+    published by the Free Software Foundation; either version 2 of
+    the License, or (at your option) version 3.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+    02110-1301, USA.
+
+*/
+
+#include "unittest.h"
+#include <AliHLTTPCCAGridProfile.h>
+#include <AliHLTTPCCAParameters.h>
+#include <AliHLTTPCCAParam.h>
+#include <AliHLTTPCCAGBTracker.h>
+#include <AliHLTTPCCATracker.h>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+
+static const int NRows = 45;
+
+void testGridProfileDefault()
+{
+  AliHLTTPCCAGridProfile profile;
+  VERIFY( !profile.IsTuning() );
+  for ( int iRow = 0; iRow < AliHLTTPCCAParameters::MaxNumberOfRows8; ++iRow ) {
+    COMPARE( profile.Coeff( iRow ), float( AliHLTTPCCAParameters::GridCreationCoeff ) );
+  }
+    // the coefficients are limited to the candidates
+  profile.SetCoeff( 0, 100.f );
+  profile.SetCoeff( 1, 0.f );
+  COMPARE( profile.Coeff( 0 ), AliHLTTPCCAGridProfile::Candidate( AliHLTTPCCAGridProfile::NCandidates - 1 ) );
+  COMPARE( profile.Coeff( 1 ), AliHLTTPCCAGridProfile::Candidate( 0 ) );
+}
+
+void testGridProfileRoundTrip()
+{
+  AliHLTTPCCAGridProfile profile;
+  profile.StartTuning( NRows ); // the number of rows to write
+  profile.FinishTuning();
+  for ( int iRow = 0; iRow < NRows; ++iRow ) profile.SetCoeff( iRow, 0.5f + 0.125f * iRow + ( iRow % 3 ) * 0.01f );
+
+  std::stringstream s;
+  profile.Write( s );
+  AliHLTTPCCAGridProfile read;
+  VERIFY( read.Read( s ) );
+  for ( int iRow = 0; iRow < NRows; ++iRow ) COMPARE( read.Coeff( iRow ), profile.Coeff( iRow ) );
+  COMPARE( read.Coeff( NRows ), float( AliHLTTPCCAParameters::GridCreationCoeff ) ); // not in the profile
+
+  const char *fileName = "tuningtest_grid.txt";
+  VERIFY( profile.WriteToFile( fileName ) );
+  AliHLTTPCCAGridProfile readFile;
+  VERIFY( readFile.ReadFromFile( fileName ) );
+  for ( int iRow = 0; iRow < NRows; ++iRow ) COMPARE( readFile.Coeff( iRow ), profile.Coeff( iRow ) );
+  std::remove( fileName );
+  VERIFY( !readFile.ReadFromFile( fileName ) );
+}
+
+void testGridProfileBadInput()
+{
+  AliHLTTPCCAGridProfile profile;
+  profile.SetCoeff( 3, 4.f );
+  const char *bad[] = { "", "abc", "0", "100000 1 2", "3 1.0 2.0", "2 1.0 x" };
+  for ( int i = 0; i < 6; ++i ) {
+    std::istringstream s( bad[i] );
+    VERIFY( !profile.Read( s ) );
+    COMPARE( profile.Coeff( 3 ), 4.f ); // kept
+    COMPARE( profile.Coeff( 0 ), float( AliHLTTPCCAParameters::GridCreationCoeff ) );
+  }
+}
+
+void testGridProfileTuning()
+{
+  AliHLTTPCCAGridProfile profile;
+  profile.StartTuning( 3 );
+  VERIFY( profile.IsTuning() );
+    // row 0: the candidate 2 visits the least, row 1: the candidate 0, row 2: no queries
+  for ( int iCand = 0; iCand < AliHLTTPCCAGridProfile::NCandidates; ++iCand ) {
+    const float coeff = AliHLTTPCCAGridProfile::Candidate( iCand );
+    const int d2 = ( iCand - 2 ) * ( iCand - 2 );
+    profile.AddStatistics( 0, coeff, 10, 100 + 50 * d2, 20 );
+    profile.AddStatistics( 1, coeff, 20, 100 + 100 * iCand, 10 * iCand );
+  }
+  profile.AddStatistics( 0, 3.f, 1, 0, 0 ); // not a candidate, ignored
+  COMPARE( profile.Cost( 0, 2 ), 12. );
+  COMPARE( profile.Cost( 2, 0 ), -1. );
+  profile.FinishTuning();
+  VERIFY( !profile.IsTuning() );
+  COMPARE( profile.Coeff( 0 ), AliHLTTPCCAGridProfile::Candidate( 2 ) );
+  COMPARE( profile.Coeff( 1 ), AliHLTTPCCAGridProfile::Candidate( 0 ) );
+  COMPARE( profile.Coeff( 2 ), float( AliHLTTPCCAParameters::GridCreationCoeff ) );
+
+    // the tuned profile is written for the 3 tuned rows
+  std::stringstream s;
+  profile.Write( s );
+  AliHLTTPCCAGridProfile read;
+  VERIFY( read.Read( s ) );
+  for ( int iRow = 0; iRow < 3; ++iRow ) COMPARE( read.Coeff( iRow ), profile.Coeff( iRow ) );
+}
+
+static const int NIter = AliHLTTPCCAParameters::MaxNumberOfIterations;
+
+static void compareTuning( const AliHLTTPCCAParam::Tuning &a, const AliHLTTPCCAParam::Tuning &b )
+{
+  for ( int i = 0; i < NIter; ++i ) {
+    COMPARE( a.fNeighbourAreaSizeTgY[i], b.fNeighbourAreaSizeTgY[i] );
+    COMPARE( a.fNeighbourAreaSizeTgZ[i], b.fNeighbourAreaSizeTgZ[i] );
+    COMPARE( a.fNeighbourChiCut[i], b.fNeighbourChiCut[i] );
+    COMPARE( a.fNeighboursChainMinLength[i], b.fNeighboursChainMinLength[i] );
+  }
+}
+
+static AliHLTTPCCAParam::Tuning changedTuning()
+{
+  AliHLTTPCCAParam::Tuning t;
+  for ( int i = 0; i < NIter; ++i ) {
+    t.fNeighbourAreaSizeTgY[i] = 0.75f + i;
+    t.fNeighbourAreaSizeTgZ[i] = 1.5f + 0.25f * i;
+    t.fNeighbourChiCut[i] = 0.125f * ( i + 1 );
+    t.fNeighboursChainMinLength[i] = 4 + i;
+  }
+  return t;
+}
+
+void testTuningDefault()
+{
+  const AliHLTTPCCAParam::Tuning t;
+  for ( int i = 0; i < NIter; ++i ) {
+    COMPARE( t.fNeighbourAreaSizeTgY[i], AliHLTTPCCAParameters::NeighbourAreaSizeTgY[i] );
+    COMPARE( t.fNeighbourAreaSizeTgZ[i], AliHLTTPCCAParameters::NeighbourAreaSizeTgZ[i] );
+    COMPARE( t.fNeighboursChainMinLength[i], AliHLTTPCCAParameters::NeighboursChainMinLength[i] );
+  }
+  compareTuning( AliHLTTPCCAParam().GetTuning(), t );
+}
+
+void testTuningRoundTrip()
+{
+  const AliHLTTPCCAParam::Tuning t = changedTuning();
+  std::stringstream s;
+  t.Write( s );
+  AliHLTTPCCAParam::Tuning read;
+  VERIFY( read.Read( s ) );
+  compareTuning( read, t );
+}
+
+void testTuningPartialAndBadInput()
+{
+  const AliHLTTPCCAParam::Tuning defaults;
+  AliHLTTPCCAParam::Tuning t;
+  std::istringstream one( "1 0.5 0.75 1.25 5" ); // the first iteration only
+  VERIFY( t.Read( one ) );
+  COMPARE( t.fNeighbourAreaSizeTgY[0], 0.5f );
+  COMPARE( t.fNeighbourAreaSizeTgZ[0], 0.75f );
+  COMPARE( t.fNeighbourChiCut[0], 1.25f );
+  COMPARE( t.fNeighboursChainMinLength[0], 5 );
+  for ( int i = 1; i < NIter; ++i ) {
+    COMPARE( t.fNeighbourAreaSizeTgY[i], defaults.fNeighbourAreaSizeTgY[i] );
+    COMPARE( t.fNeighboursChainMinLength[i], defaults.fNeighboursChainMinLength[i] );
+  }
+
+  const AliHLTTPCCAParam::Tuning kept = t;
+  const char *bad[] = { "", "x", "0", "100 1 1 1 1", "2 1 1 1 1 2 2", "1 1 1 x 1" };
+  for ( int i = 0; i < 6; ++i ) {
+    std::istringstream s( bad[i] );
+    VERIFY( !t.Read( s ) );
+    compareTuning( t, kept );
+  }
+}
+
+// the tracker gives the tuning to all its slice trackers, also to the ones created by later settings
+void testTrackerTuning()
+{
+  float rowX[NRows];
+  for ( int i = 0; i < NRows; ++i ) rowX[i] = 60.f + i * 3.f;
+  std::vector<AliHLTTPCCAParam> settings( 2 );
+  for ( int iSlice = 0; iSlice < 2; ++iSlice ) {
+    settings[iSlice].Initialize( iSlice, NRows, rowX, iSlice * 0.5236, 0.5236, 50, 200, -200, 200, 0.5, 0.2, 0.5 );
+  }
+  const AliHLTTPCCAParam::Tuning t = changedTuning();
+  AliHLTTPCCAGBTracker tracker;
+  tracker.SetSettings( settings );
+  tracker.SetTuning( t );
+  compareTuning( tracker.Tuning(), t );
+  for ( int iSlice = 0; iSlice < 2; ++iSlice ) {
+    for ( int i = 0; i < NIter; ++i ) {
+      COMPARE( tracker.Slice( iSlice ).Param().NeighbourAreaSizeTgY( i ), t.fNeighbourAreaSizeTgY[i] );
+      COMPARE( tracker.Slice( iSlice ).Param().NeighboursChainMinLength( i ), t.fNeighboursChainMinLength[i] );
+    }
+  }
+  tracker.SetSettings( settings );
+  COMPARE( tracker.Slice( 1 ).Param().NeighbourChiCut( 2 ), t.fNeighbourChiCut[2] );
+
+  const char *fileName = "tuningtest_cuts.txt";
+  VERIFY( !tracker.ReadTuning( fileName ) ); // no file, the tuning is kept
+  compareTuning( tracker.Tuning(), t );
+  {
+    std::ofstream out( fileName );
+    AliHLTTPCCAParam::Tuning().Write( out );
+  }
+  VERIFY( tracker.ReadTuning( fileName ) );
+  compareTuning( tracker.Slice( 0 ).Param().GetTuning(), AliHLTTPCCAParam::Tuning() );
+  std::remove( fileName );
+}
+
+int main()
+{
+  runTest( testGridProfileDefault );
+  runTest( testGridProfileRoundTrip );
+  runTest( testGridProfileBadInput );
+  runTest( testGridProfileTuning );
+  runTest( testTuningDefault );
+  runTest( testTuningRoundTrip );
+  runTest( testTuningPartialAndBadInput );
+  runTest( testTrackerTuning );
+  return 0;
+}
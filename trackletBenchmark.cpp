@@ -0,0 +1,141 @@
+/*
+ * This file is part of TPCCATracker package
+ * Copyright (C) 2007-2020 FIAS Frankfurt Institute for Advanced Studies
+ *               2007-2020 Goethe University of Frankfurt
+ *               2007-2020 Ivan Kisel <I.Kisel@compeng.uni-frankfurt.de>
+ *               2007-2019 Sergey Gorbunov
+ *               2007-2019 Maksym Zyzak
+ *               2007-2014 Igor Kulakov
+ *               2014-2020 Grigory Kozlov
+ *
+ * TPCCATracker is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * TPCCATracker is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/// Benchmark of the packing of the start hits into the vectors of the TrackletConstructor
+/// (AliHLTTPCCATracker::SetStartHitsRowBucket): by start row as found, or in buckets of start rows ordered by the chain length
+  /// to run:  ./trackletBenchmark NEvents InputDir [-repeat N] [-bucket n] [-refill] [-parallel n] [-nThreads N]
+  /// reads InputDir/settings.data and InputDir/eventN_hits.bin (or .data), N = 0..NEvents-1, reconstructs each event
+  /// N times with each packing and prints the time of the TrackletConstructor, its lane utilisation and the found tracks,
+  /// with -refill the lanes of finished tracklets are refilled (AliHLTTPCCATracker::SetRefillTrackletConstructor),
+  /// with -parallel the vectors run in waves of n on N threads (AliHLTTPCCATracker::SetParallelTrackletVectors)
+
+#define HLTCA_STANDALONE
+#include <AliHLTTPCCAGBTracker.h>
+#include <AliHLTTPCCATracker.h>
+#include <AliHLTTPCCAGBTrack.h>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+  /// results of one packing summed over the events
+struct PackingStat
+{
+  PackingStat(): fTime( 0 ), fNLaneSteps( 0 ), fNActiveLaneSteps( 0 ), fNTracks( 0 ), fNTrackHits( 0 ) {}
+  double fTime; // TrackletConstructor time of all slices, all repetitions
+  long fNLaneSteps;
+  long fNActiveLaneSteps;
+  long fNTracks;
+  long fNTrackHits;
+};
+
+int main( int argc, char *argv[] )
+{
+  vector<string> args;
+  int nRepeat = 10;
+  int rowBucket = 2;
+  bool isRefill = false;
+  int parallelVectors = 0;
+  int nThreads = 1;
+  for ( int i = 1; i < argc; i++ ) {
+    if ( !std::strcmp( argv[i], "-repeat" ) && ++i < argc ) {
+      nRepeat = atoi( argv[i] );
+    } else if ( !std::strcmp( argv[i], "-bucket" ) && ++i < argc ) {
+      rowBucket = atoi( argv[i] );
+    } else if ( !std::strcmp( argv[i], "-refill" ) ) {
+      isRefill = true;
+    } else if ( !std::strcmp( argv[i], "-parallel" ) && ++i < argc ) {
+      parallelVectors = atoi( argv[i] );
+    } else if ( !std::strcmp( argv[i], "-nThreads" ) && ++i < argc ) {
+      nThreads = atoi( argv[i] );
+    } else {
+      args.push_back( argv[i] );
+    }
+  }
+  if ( args.size() < 2 || nRepeat < 1 || rowBucket < 1 || parallelVectors < 0 ) {
+    std::cout << "Usage: " << argv[0] << " NEvents InputDir [-repeat N] [-bucket n] [-refill] [-parallel n] [-nThreads N]" << std::endl;
+    return 1;
+  }
+  const int NEvents = atoi( args[0].data() );
+  const string inDir = args[1] + "/";
+
+  AliHLTTPCCAGBTracker tracker;
+  tracker.SetNThreads( nThreads );
+  tracker.Init();
+  if ( !tracker.ReadSettingsFromFile( inDir ) ) {
+    std::cout << "Settings can't be read from " << inDir << "settings.data" << std::endl;
+    return 1;
+  }
+  tracker.SetRefillTrackletConstructor( isRefill );
+  tracker.SetParallelTrackletVectors( parallelVectors );
+
+  const int buckets[2] = { 0, rowBucket };
+  PackingStat stat[2];
+  for ( int iEvent = 0; iEvent < NEvents; iEvent++ ) {
+    char buf[12];
+    sprintf( buf, "%d", iEvent );
+    const string name = string( "event" ) + string( buf ) + string( "_" );
+    for ( int iPacking = 0; iPacking < 2; iPacking++ ) {
+      tracker.SetStartHitsRowBucket( buckets[iPacking] );
+      PackingStat &s = stat[iPacking];
+      for ( int iRepeat = 0; iRepeat < nRepeat; iRepeat++ ) {
+        if ( !tracker.ReadHitsFromFile( inDir + name ) ) {
+          std::cout << "Hits for event " << iEvent << " can't be read from " << inDir + name << std::endl;
+          return 1;
+        }
+        tracker.FindTracks();
+        for ( int iSlice = 0; iSlice < tracker.NSlices(); iSlice++ ) {
+          const AliHLTTPCCATracker &slice = tracker.Slices()[iSlice];
+          s.fTime += slice.Timer( 1 );
+          s.fNLaneSteps += slice.NTrackletLaneSteps();
+          s.fNActiveLaneSteps += slice.NTrackletActiveLaneSteps();
+        }
+      }
+      s.fNTracks += tracker.NTracks();
+      for ( int iTrack = 0; iTrack < tracker.NTracks(); iTrack++ ) s.fNTrackHits += tracker.Track( iTrack ).NHits();
+    }
+    std::cout << " Event " << iEvent << ": " << tracker.NHits() << " hits" << std::endl;
+  }
+
+  std::cout << float_v::Size << " lanes" << ( isRefill ? ", refilled lanes" : "" );
+  if ( parallelVectors > 0 ) std::cout << ", parallel waves of " << parallelVectors << " vectors";
+  std::cout << ", " << tracker.NThreads() << " threads:" << std::endl;
+  for ( int iPacking = 0; iPacking < 2; iPacking++ ) {
+    const PackingStat &s = stat[iPacking];
+    if ( buckets[iPacking] == 0 ) {
+      std::cout << " by start row:          ";
+    } else {
+      std::cout << " in buckets of " << buckets[iPacking] << " rows:  ";
+    }
+    std::cout << s.fTime / nRepeat / NEvents * 1.e3 << " ms per event, lane utilisation "
+              << ( s.fNLaneSteps > 0 ? 100. * s.fNActiveLaneSteps / s.fNLaneSteps : 0. ) << "% of "
+              << s.fNLaneSteps / nRepeat << " lane row steps, "
+              << s.fNTracks << " tracks with " << s.fNTrackHits << " hits" << std::endl;
+  }
+  return 0;
+}